@@ -0,0 +1,192 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "BitwiseOperations.hpp"
+
+#include <intrin.h>
+#include <immintrin.h>
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		InstructionSet DetectInstructionSet()
+		{
+			int registers[4] = {};
+			const int ecx = 2;
+			const int ebx = 1;
+
+			__cpuid(registers, 0);
+			auto maxLeaf = registers[0];
+
+			__cpuid(registers, 1);
+			auto hasSse2 = (registers[3] & (1 << 26)) != 0;
+			auto hasOsXSave = (registers[ecx] & (1 << 27)) != 0;
+			auto hasAvx = (registers[ecx] & (1 << 28)) != 0;
+
+			// The operating system must save AVX registers (XMM and YMM states).
+			if (hasOsXSave && hasAvx && maxLeaf >= 7 && (_xgetbv(0) & 6) == 6)
+			{
+				__cpuidex(registers, 7, 0);
+				if (registers[ebx] & (1 << 5))
+					return InstructionSet::Avx2;
+			}
+
+			return hasSse2 ? InstructionSet::Sse2 : InstructionSet::Scalar;
+		}
+
+		//---------------------------------------------------------------------
+		struct Or
+		{
+			static uint64_t Apply(uint64_t x, uint64_t y) { return x | y; }
+			static __m128i Apply(__m128i x, __m128i y) { return _mm_or_si128(x, y); }
+			static __m256i Apply(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+		};
+
+		//---------------------------------------------------------------------
+		struct And
+		{
+			static uint64_t Apply(uint64_t x, uint64_t y) { return x & y; }
+			static __m128i Apply(__m128i x, __m128i y) { return _mm_and_si128(x, y); }
+			static __m256i Apply(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+		};
+
+		//---------------------------------------------------------------------
+		// Intrinsics compute ~first & second.
+		struct AndNot
+		{
+			static uint64_t Apply(uint64_t x, uint64_t y) { return x & ~y; }
+			static __m128i Apply(__m128i x, __m128i y) { return _mm_andnot_si128(y, x); }
+			static __m256i Apply(__m256i x, __m256i y) { return _mm256_andnot_si256(y, x); }
+		};
+
+		//---------------------------------------------------------------------
+		struct Xor
+		{
+			static uint64_t Apply(uint64_t x, uint64_t y) { return x ^ y; }
+			static __m128i Apply(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+			static __m256i Apply(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+		};
+
+		//---------------------------------------------------------------------
+		template <typename Operation>
+		void ApplyScalar(
+			uint64_t* destination,
+			const uint64_t* source,
+			size_t wordCount)
+		{
+			for (size_t i = 0; i < wordCount; ++i)
+				destination[i] = Operation::Apply(destination[i], source[i]);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Operation>
+		void ApplySse2(
+			uint64_t* destination,
+			const uint64_t* source,
+			size_t wordCount)
+		{
+			size_t i = 0;
+
+			for (; i + 2 <= wordCount; i += 2)
+			{
+				auto* destinationBlock = reinterpret_cast<__m128i*>(destination + i);
+				auto sourceBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+				_mm_storeu_si128(destinationBlock, Operation::Apply(_mm_loadu_si128(destinationBlock), sourceBlock));
+			}
+			ApplyScalar<Operation>(destination + i, source + i, wordCount - i);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Operation>
+		void ApplyAvx2(
+			uint64_t* destination,
+			const uint64_t* source,
+			size_t wordCount)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= wordCount; i += 4)
+			{
+				auto* destinationBlock = reinterpret_cast<__m256i*>(destination + i);
+				auto sourceBlock = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+				_mm256_storeu_si256(destinationBlock, Operation::Apply(_mm256_loadu_si256(destinationBlock), sourceBlock));
+			}
+			// Avoid AVX to SSE transition penalties in the caller.
+			_mm256_zeroupper();
+			ApplyScalar<Operation>(destination + i, source + i, wordCount - i);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Operation>
+		void Apply(
+			uint64_t* destination,
+			const uint64_t* source,
+			size_t wordCount,
+			InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::Avx2: ApplyAvx2<Operation>(destination, source, wordCount); break;
+				case InstructionSet::Sse2: ApplySse2<Operation>(destination, source, wordCount); break;
+				case InstructionSet::Scalar: ApplyScalar<Operation>(destination, source, wordCount); break;
+				default: THROW(L"Invalid instruction set.");
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	InstructionSet GetSupportedInstructionSet()
+	{
+		static const auto instructionSet = DetectInstructionSet();
+
+		return instructionSet;
+	}
+
+	//-------------------------------------------------------------------------
+	void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		uint64_t* destination,
+		const uint64_t* source,
+		size_t wordCount)
+	{
+		ApplyBitwiseOperation(operation, destination, source, wordCount, GetSupportedInstructionSet());
+	}
+
+	//-------------------------------------------------------------------------
+	void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		uint64_t* destination,
+		const uint64_t* source,
+		size_t wordCount,
+		InstructionSet instructionSet)
+	{
+		switch (operation)
+		{
+			case BitwiseOperation::Or: Apply<Or>(destination, source, wordCount, instructionSet); break;
+			case BitwiseOperation::And: Apply<And>(destination, source, wordCount, instructionSet); break;
+			case BitwiseOperation::AndNot: Apply<AndNot>(destination, source, wordCount, instructionSet); break;
+			case BitwiseOperation::Xor: Apply<Xor>(destination, source, wordCount, instructionSet); break;
+			default: THROW(L"Invalid bitwise operation.");
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	enum class InstructionSet
+	{
+		Scalar,
+		Sse2,
+		Avx2
+	};
+
+	// Best instruction set supported by both the processor and the operating system.
+	CPPCOVERAGE_DLL InstructionSet GetSupportedInstructionSet();
+
+	enum class BitwiseOperation
+	{
+		Or,
+		And,
+		AndNot,
+		Xor
+	};
+
+	// destination[i] = destination[i] <operation> source[i] for each of the wordCount words.
+	// AndNot computes destination[i] & ~source[i].
+	CPPCOVERAGE_DLL void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		uint64_t* destination, 
+		const uint64_t* source, 
+		size_t wordCount);
+
+	// Same as above with an explicit instruction set that must be supported.
+	CPPCOVERAGE_DLL void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		uint64_t* destination,
+		const uint64_t* source,
+		size_t wordCount,
+		InstructionSet instructionSet);
+}
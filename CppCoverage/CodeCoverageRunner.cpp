@@ -35,11 +35,18 @@
 #include "Address.hpp"
 #include "RunCoverageSettings.hpp"
 #include "MonitoredLineRegister.hpp"
+#include "CoverageJournal.hpp"
 
 #include "tools/Tool.hpp"
 
 namespace CppCoverage
-{			
+{
+	namespace
+	{
+		// Maximum time the executed lines stay in memory before being written to the journal.
+		const std::chrono::milliseconds JournalFlushInterval{ 1000 };
+	}
+
 	//-------------------------------------------------------------------------
 	CodeCoverageRunner::CodeCoverageRunner()
 	{ 
@@ -57,7 +64,10 @@ namespace CppCoverage
 	CoverageData CodeCoverageRunner::RunCoverage(
 		const RunCoverageSettings& settings)
 	{
-		Debugger debugger{ settings.GetCoverChildren(), settings.GetContinueAfterCppException()};
+		const auto& journalPath = settings.GetJournalPath();
+		// Without debug events, the journal is flushed when the wait times out.
+		auto waitTimeout = journalPath ? static_cast<DWORD>(JournalFlushInterval.count()) : INFINITE;
+		Debugger debugger{ settings.GetCoverChildren(), settings.GetContinueAfterCppException(), waitTimeout };
 
 		coverageFilterManager_ = std::make_shared<CoverageFilterManager>(
 			settings.GetCoverageFilterSettings(),
@@ -69,8 +79,21 @@ namespace CppCoverage
 		    breakpoint_, executedAddressManager_, coverageFilterManager_);
 
 		const auto& startInfo = settings.GetStartInfo();
-		int exitCode = debugger.Debug(startInfo, *this);
 		const auto& path = startInfo.GetPath();
+		journal_.reset();
+
+		if (journalPath)
+		{
+			LOG_INFO << L"Write coverage journal to: " << journalPath->wstring();
+			journal_ = std::make_shared<CoverageJournal>(*journalPath, path.filename().wstring(),
+				JournalFlushInterval, settings.GetJournalSyncOnFlush());
+		}
+		executedAddressManager_->SetJournal(journal_);
+
+		int exitCode = debugger.Debug(startInfo, *this);
+
+		if (journal_)
+			journal_->Close(exitCode);
 
 		auto warningMessageLines = coverageFilterManager_->ComputeWarningMessageLines(
 			settings.GetMaxUnmatchPathsForWarning());
@@ -152,6 +175,14 @@ namespace CppCoverage
 
 		return IDebugEventsHandler::ExceptionType::NotHandled;
 	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnWaitTimeout()
+	{
+		// The executed lines are written even if the program hangs.
+		if (journal_)
+			journal_->Flush();
+	}
 	
 	//-------------------------------------------------------------------------
 	bool CodeCoverageRunner::OnBreakPoint(
@@ -33,6 +33,7 @@ namespace CppCoverage
 	class ExceptionHandler;
 	class UnifiedDiffSettings;
 	class MonitoredLineRegister;
+	class CoverageJournal;
 
 	class CPPCOVERAGE_DLL CodeCoverageRunner : private IDebugEventsHandler
 	{
@@ -48,6 +49,7 @@ namespace CppCoverage
 		virtual void OnLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
 		virtual void OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&) override;
 		virtual ExceptionType OnException(HANDLE hProcess, HANDLE hThread, const EXCEPTION_DEBUG_INFO&) override;
+		virtual void OnWaitTimeout() override;
 
 	private:
 		CodeCoverageRunner(const CodeCoverageRunner&) = delete;
@@ -62,6 +64,7 @@ namespace CppCoverage
 		std::shared_ptr<CoverageFilterManager> coverageFilterManager_;
 		std::unique_ptr<MonitoredLineRegister> monitoredLineRegister_;
 		std::unique_ptr<ExceptionHandler> exceptionHandler_;
+		std::shared_ptr<CoverageJournal> journal_;
 	};
 }
 
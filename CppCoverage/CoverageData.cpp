@@ -59,6 +59,20 @@ namespace CppCoverage
 		return *modules_.back();
 	}
 
+	//-------------------------------------------------------------------------
+	ModuleCoverage& CoverageData::AddModule(std::unique_ptr<ModuleCoverage> module)
+	{
+		modules_.push_back(std::move(module));
+
+		return *modules_.back();
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageData::ReserveModules(size_t moduleCount)
+	{
+		modules_.reserve(moduleCount);
+	}
+
 	//-------------------------------------------------------------------------	
 	void CoverageData::SetName(const std::wstring& name)
 	{
@@ -46,6 +46,8 @@ namespace CppCoverage
 		CoverageData(CoverageData&&);			
 		CoverageData& operator=(CoverageData&&);
 		ModuleCoverage& AddModule(const boost::filesystem::path& name);
+		ModuleCoverage& AddModule(std::unique_ptr<ModuleCoverage>);
+		void ReserveModules(size_t moduleCount);
 		
 		void SetName(const std::wstring&);
 		void SetExitCode(int);
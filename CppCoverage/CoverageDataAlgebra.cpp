@@ -0,0 +1,265 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataAlgebra.hpp"
+
+#include <map>
+
+#include "CoverageData.hpp"
+#include "ModuleCoverage.hpp"
+#include "FileCoverage.hpp"
+#include "LineCoverage.hpp"
+#include "LineBitsets.hpp"
+#include "CppCoverageException.hpp"
+
+#include "Tools/ParallelFor.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		template <typename Child>
+		struct Operands
+		{
+			std::vector<const Child*> children1;
+			std::vector<const Child*> children2;
+		};
+
+		//---------------------------------------------------------------------
+		struct FileToCompute
+		{
+			FileCoverage* file;
+			Operands<FileCoverage> operands;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename Child, typename Parent, typename GetChildren>
+		std::map<fs::path, Operands<Child>> GroupByPath(
+			const std::vector<const Parent*>& parents1,
+			const std::vector<const Parent*>& parents2,
+			GetChildren getChildren)
+		{
+			std::map<fs::path, Operands<Child>> operandsByPath;
+
+			for (const auto* parent : parents1)
+			{
+				for (const auto& child : getChildren(*parent))
+					operandsByPath[child->GetPath()].children1.push_back(child.get());
+			}
+			for (const auto* parent : parents2)
+			{
+				for (const auto& child : getChildren(*parent))
+					operandsByPath[child->GetPath()].children2.push_back(child.get());
+			}
+
+			return operandsByPath;
+		}
+
+		//---------------------------------------------------------------------
+		void OrFiles(
+			const std::vector<const FileCoverage*>& files,
+			LineBitsets& fileBitsets,
+			LineBitsets& bitsets)
+		{
+			for (const auto* file : files)
+			{
+				auto range = fileBitsets.Assign(file->GetLines());
+
+				ApplyBitwiseOperation(BitwiseOperation::Or, bitsets.GetLines(), fileBitsets.GetLines(), range);
+				ApplyBitwiseOperation(BitwiseOperation::Or, bitsets.GetExecutedLines(), fileBitsets.GetExecutedLines(), range);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		struct LineOperands
+		{
+			bool isLine1 = false;
+			bool isExecuted1 = false;
+			bool isLine2 = false;
+			bool isExecuted2 = false;
+		};
+
+		//---------------------------------------------------------------------
+		// Same result as the bitsets without allocating the whole line range.
+		std::vector<LineCoverage> ComputeSparseLines(
+			CoverageDataOperation operation,
+			const Operands<FileCoverage>& operands)
+		{
+			std::map<unsigned int, LineOperands> lineOperandsByNumber;
+
+			for (const auto* file : operands.children1)
+			{
+				for (const auto& line : file->GetLines())
+				{
+					auto& lineOperands = lineOperandsByNumber[line.GetLineNumber()];
+					lineOperands.isLine1 = true;
+					lineOperands.isExecuted1 |= line.HasBeenExecuted();
+				}
+			}
+			for (const auto* file : operands.children2)
+			{
+				for (const auto& line : file->GetLines())
+				{
+					auto& lineOperands = lineOperandsByNumber[line.GetLineNumber()];
+					lineOperands.isLine2 = true;
+					lineOperands.isExecuted2 |= line.HasBeenExecuted();
+				}
+			}
+
+			std::vector<LineCoverage> lines;
+
+			for (const auto& pair : lineOperandsByNumber)
+			{
+				const auto& lineOperands = pair.second;
+				bool isExecuted = false;
+
+				switch (operation)
+				{
+					case CoverageDataOperation::Difference:
+						isExecuted = lineOperands.isExecuted1 && !lineOperands.isExecuted2;
+						break;
+					case CoverageDataOperation::Intersection:
+						isExecuted = lineOperands.isExecuted1 && lineOperands.isExecuted2;
+						break;
+					case CoverageDataOperation::SymmetricDifference:
+						isExecuted = lineOperands.isExecuted1 != lineOperands.isExecuted2;
+						break;
+					case CoverageDataOperation::NewlyUncovered:
+						if (!lineOperands.isLine2)
+							continue;
+						isExecuted = lineOperands.isExecuted1 && !lineOperands.isExecuted2;
+						break;
+					default:
+						THROW(L"Invalid coverage data operation.");
+				}
+				lines.emplace_back(pair.first, isExecuted);
+			}
+
+			return lines;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<LineCoverage> ComputeLines(
+			CoverageDataOperation operation,
+			const Operands<FileCoverage>& operands)
+		{
+			std::vector<const std::vector<LineCoverage>*> linesCollection;
+
+			for (const auto* file : operands.children1)
+				linesCollection.push_back(&file->GetLines());
+			for (const auto* file : operands.children2)
+				linesCollection.push_back(&file->GetLines());
+			if (!LineBitsets::IsSuitableFor(linesCollection))
+				return ComputeSparseLines(operation, operands);
+
+			LineBitsets bitsets1{ linesCollection };
+			LineBitsets bitsets2{ linesCollection };
+			LineBitsets fileBitsets{ linesCollection };
+			auto range = bitsets1.GetWordRange();
+
+			OrFiles(operands.children1, fileBitsets, bitsets1);
+			OrFiles(operands.children2, fileBitsets, bitsets2);
+
+			auto& lines = bitsets1.GetLines();
+			auto& executedLines = bitsets1.GetExecutedLines();
+
+			switch (operation)
+			{
+				case CoverageDataOperation::Difference:
+					ApplyBitwiseOperation(BitwiseOperation::AndNot, executedLines, bitsets2.GetExecutedLines(), range);
+					break;
+				case CoverageDataOperation::Intersection:
+					ApplyBitwiseOperation(BitwiseOperation::And, executedLines, bitsets2.GetExecutedLines(), range);
+					break;
+				case CoverageDataOperation::SymmetricDifference:
+					ApplyBitwiseOperation(BitwiseOperation::Xor, executedLines, bitsets2.GetExecutedLines(), range);
+					break;
+				case CoverageDataOperation::NewlyUncovered:
+					ApplyBitwiseOperation(BitwiseOperation::AndNot, executedLines, bitsets2.GetExecutedLines(), range);
+					ApplyBitwiseOperation(BitwiseOperation::And, executedLines, bitsets2.GetLines(), range);
+					lines = bitsets2.GetLines();
+					return bitsets1.ToLines();
+				default:
+					THROW(L"Invalid coverage data operation.");
+			}
+			ApplyBitwiseOperation(BitwiseOperation::Or, lines, bitsets2.GetLines(), range);
+
+			return bitsets1.ToLines();
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<FileToCompute> AddFiles(
+			CoverageDataOperation operation,
+			ModuleCoverage& module,
+			const Operands<ModuleCoverage>& operands)
+		{
+			auto filesByPath = GroupByPath<FileCoverage>(
+				operands.children1,
+				operands.children2,
+				[](const ModuleCoverage& m) -> const ModuleCoverage::T_FileCoverageCollection& { return m.GetFiles(); });
+			std::vector<FileToCompute> filesToCompute;
+
+			for (auto& pair : filesByPath)
+			{
+				if (operation == CoverageDataOperation::NewlyUncovered && pair.second.children2.empty())
+					continue;
+				filesToCompute.push_back({ &module.AddFile(pair.first), std::move(pair.second) });
+			}
+
+			return filesToCompute;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageData CoverageDataAlgebra::Compute(
+		CoverageDataOperation operation,
+		const CoverageData& coverageData1,
+		const CoverageData& coverageData2) const
+	{
+		const auto& reference = (operation == CoverageDataOperation::NewlyUncovered) ? coverageData2 : coverageData1;
+		CoverageData coverageData{ reference.GetName(), reference.GetExitCode() };
+
+		auto modulesByPath = GroupByPath<ModuleCoverage>(
+			std::vector<const CoverageData*>{ &coverageData1 },
+			std::vector<const CoverageData*>{ &coverageData2 },
+			[](const CoverageData& data) -> const CoverageData::T_ModuleCoverageCollection& { return data.GetModules(); });
+		std::vector<FileToCompute> filesToCompute;
+
+		for (const auto& pair : modulesByPath)
+		{
+			if (operation == CoverageDataOperation::NewlyUncovered && pair.second.children2.empty())
+				continue;
+
+			auto& module = coverageData.AddModule(pair.first);
+			auto moduleFilesToCompute = AddFiles(operation, module, pair.second);
+
+			std::move(moduleFilesToCompute.begin(), moduleFilesToCompute.end(), std::back_inserter(filesToCompute));
+		}
+
+		// Files are independent: lines are computed per file.
+		Tools::ParallelFor(filesToCompute.size(), [&](size_t i)
+		{
+			const auto& fileToCompute = filesToCompute[i];
+			fileToCompute.file->AddLines(ComputeLines(operation, fileToCompute.operands));
+		});
+
+		return coverageData;
+	}
+}
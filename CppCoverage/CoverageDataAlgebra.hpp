@@ -0,0 +1,50 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "CppCoverageExport.hpp"
+#include "CoverageDataOperation.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+
+	// Set operations on executed lines. Modules and files are matched by path.
+	// A line of the result is executed when the operation selects it:
+	// - Difference: executed in the first coverage data but not in the second.
+	// - Intersection: executed in both coverage data.
+	// - SymmetricDifference: executed in only one of the coverage data.
+	// - NewlyUncovered: executed in the first (previous) coverage data and
+	//   not executed in the second (current) one.
+	// NewlyUncovered keeps only the modules, files and lines of the second
+	// coverage data, its name and its exit code. Other operations keep the
+	// modules, files and lines of both, and the name and exit code of the first.
+	class CPPCOVERAGE_DLL CoverageDataAlgebra
+	{
+	public:
+		CoverageDataAlgebra() = default;
+
+		CoverageData Compute(
+			CoverageDataOperation operation,
+			const CoverageData& coverageData1,
+			const CoverageData& coverageData2) const;
+
+	private:
+		CoverageDataAlgebra(const CoverageDataAlgebra&) = delete;
+		CoverageDataAlgebra& operator=(const CoverageDataAlgebra&) = delete;
+	};
+}
@@ -21,6 +21,9 @@
 #include "ModuleCoverage.hpp"
 #include "FileCoverage.hpp"
 #include "LineCoverage.hpp"
+#include "LineBitsets.hpp"
+
+#include "Tools/ParallelFor.hpp"
 
 namespace fs = boost::filesystem;
 
@@ -28,6 +31,13 @@ namespace CppCoverage
 {
 	namespace
 	{
+		//---------------------------------------------------------------------
+		struct FileToMerge
+		{
+			FileCoverage* file;
+			std::vector<FileCoverage*> sources;
+		};
+
 		//---------------------------------------------------------------------
 		CoverageData CreateCoverageData(const std::vector<CoverageData>& coverageDataCollection)
 		{
@@ -66,38 +76,57 @@ namespace CppCoverage
 
 			return childrenByKey;
 		}
-		
+
 		//---------------------------------------------------------------------
-		void AddFileCoverageTo(
-			const FileCoverage* sourceFile,
-			FileCoverage* destinationFile)
+		// Linear merge of two sorted line collections. A line is executed
+		// if it is executed in one of the collections.
+		void MergeLines(
+			const std::vector<LineCoverage>& lines1,
+			const std::vector<LineCoverage>& lines2,
+			std::vector<LineCoverage>& output)
 		{
-			if (sourceFile && destinationFile)
+			auto it1 = lines1.begin();
+			auto it2 = lines2.begin();
+
+			output.clear();
+			output.reserve(lines1.size() + lines2.size());
+			while (it1 != lines1.end() && it2 != lines2.end())
 			{
-				for (const auto& line : sourceFile->GetLines())
-				{
-					auto lineNumber = line.GetLineNumber();
-					auto hasBeenExecuted = line.HasBeenExecuted();
+				auto lineNumber1 = it1->GetLineNumber();
+				auto lineNumber2 = it2->GetLineNumber();
 
-					if (!(*destinationFile)[lineNumber])
-						destinationFile->AddLine(lineNumber, hasBeenExecuted);
-					else if (hasBeenExecuted)
-						destinationFile->UpdateLine(lineNumber, true);
+				if (lineNumber1 < lineNumber2)
+					output.push_back(*it1++);
+				else if (lineNumber2 < lineNumber1)
+					output.push_back(*it2++);
+				else
+				{
+					output.emplace_back(lineNumber1, it1->HasBeenExecuted() | it2->HasBeenExecuted());
+					++it1;
+					++it2;
 				}
 			}
+			output.insert(output.end(), it1, lines1.end());
+			output.insert(output.end(), it2, lines2.end());
 		}
 
 		//---------------------------------------------------------------------
-		void FillFiles(
-			FileCoverage& file,
-			const std::vector<FileCoverage*>& files)
+		std::vector<LineCoverage> MergeLines(const std::vector<FileCoverage*>& files)
 		{
-			for (const auto& f : files)
-				AddFileCoverageTo(f, &file);
+			std::vector<LineCoverage> mergedLines;
+			std::vector<LineCoverage> buffer;
+
+			for (const auto* file : files)
+			{
+				MergeLines(mergedLines, file->GetLines(), buffer);
+				std::swap(mergedLines, buffer);
+			}
+
+			return mergedLines;
 		}
 
 		//---------------------------------------------------------------------
-		void FillModule(
+		std::vector<FileToMerge> AddModuleFiles(
 			ModuleCoverage& module,
 			const std::vector<ModuleCoverage*>& modules)
 		{
@@ -106,29 +135,53 @@ namespace CppCoverage
 				modules,
 				[](const ModuleCoverage* m) -> const ModuleCoverage::T_FileCoverageCollection&{ return m->GetFiles(); },
 				[](const FileCoverage& file) -> const fs::path&{ return file.GetPath(); });
+			std::vector<FileToMerge> filesToMerge;
+
+			module.ReserveFiles(filesByPath.size());
+			filesToMerge.reserve(filesByPath.size());
+			for (auto& pair : filesByPath)
+				filesToMerge.push_back({ &module.AddFile(pair.first), std::move(pair.second) });
+
+			return filesToMerge;
+		}
+
+		//---------------------------------------------------------------------
+		// Each file is converted to bitsets restricted to its own line range
+		// and then merged with a vectorized bitwise OR. Sparse line numbers
+		// use the linear merge.
+		std::vector<LineCoverage> MergeLinesWithBitsets(const std::vector<FileCoverage*>& files)
+		{
+			std::vector<const std::vector<LineCoverage>*> linesCollection;
+
+			for (const auto* file : files)
+				linesCollection.push_back(&file->GetLines());
+			if (!LineBitsets::IsSuitableFor(linesCollection))
+				return MergeLines(files);
 
-			for (const auto& pair : filesByPath)
+			LineBitsets mergedBitsets{ linesCollection };
+			LineBitsets fileBitsets{ linesCollection };
+
+			for (const auto* lines : linesCollection)
 			{
-				auto& file = module.AddFile(pair.first);
-				FillFiles(file, pair.second);
+				auto range = fileBitsets.Assign(*lines);
+
+				ApplyBitwiseOperation(BitwiseOperation::Or, mergedBitsets.GetLines(), fileBitsets.GetLines(), range);
+				ApplyBitwiseOperation(BitwiseOperation::Or, mergedBitsets.GetExecutedLines(), fileBitsets.GetExecutedLines(), range);
 			}
+
+			return mergedBitsets.ToLines();
 		}
 
 		//-------------------------------------------------------------------------
 		void MergeFileCoverages(const std::vector<FileCoverage*>& fileCoverages)
 		{
-			if (fileCoverages.size() > 1)
-			{
-				auto mutableFileCoverages = fileCoverages;
-				auto& fileCoverageSum = mutableFileCoverages.back();
+			FileCoverage mergedFileCoverage{ fileCoverages.front()->GetPath() };
 
-				mutableFileCoverages.pop_back();
-				for (const auto* fileCoverage : mutableFileCoverages)
-					AddFileCoverageTo(fileCoverage, fileCoverageSum);
+			mergedFileCoverage.AddLines(MergeLinesWithBitsets(fileCoverages));
 
-				for (auto* fileCoverage : mutableFileCoverages)
-					*fileCoverage = *fileCoverageSum;
-			}
+			// All copies share the lines of mergedFileCoverage.
+			for (auto* fileCoverage : fileCoverages)
+				*fileCoverage = mergedFileCoverage;
 		}
 	}
 
@@ -144,15 +197,49 @@ namespace CppCoverage
 				[](const CoverageData& data) -> const CoverageData::T_ModuleCoverageCollection& { return data.GetModules(); },
 				[](const ModuleCoverage& module) -> const fs::path& { return module.GetPath(); });
 		
+		std::vector<std::pair<ModuleCoverage*, const std::vector<ModuleCoverage*>*>> modulesToMerge;
+
+		coverageData.ReserveModules(modulesByPath.size());
 		for (const auto& pair : modulesByPath)
+			modulesToMerge.emplace_back(&coverageData.AddModule(pair.first), &pair.second);
+
+		// Modules are independent: files can be added concurrently.
+		std::vector<std::vector<FileToMerge>> filesToMergeByModule(modulesToMerge.size());
+		Tools::ParallelFor(modulesToMerge.size(), [&](size_t i)
+		{
+			filesToMergeByModule[i] = AddModuleFiles(*modulesToMerge[i].first, *modulesToMerge[i].second);
+		});
+
+		std::vector<FileToMerge*> filesToMerge;
+		for (auto& moduleFilesToMerge : filesToMergeByModule)
 		{
-			auto& module = coverageData.AddModule(pair.first);
-			FillModule(module, pair.second);
+			for (auto& fileToMerge : moduleFilesToMerge)
+				filesToMerge.push_back(&fileToMerge);
 		}
+
+		// Files are independent too: lines are merged per file.
+		Tools::ParallelFor(filesToMerge.size(), [&](size_t i)
+		{
+			const auto& fileToMerge = *filesToMerge[i];
+			fileToMerge.file->AddLines(MergeLines(fileToMerge.sources));
+		});
 		
 		return coverageData;
 	}
 
+	//-------------------------------------------------------------------------
+	void CoverageDataMerger::Merge(
+		const FileCoverage& source,
+		FileCoverage& destination) const
+	{
+		std::vector<LineCoverage> lines;
+		FileCoverage mergedFile{ destination.GetPath() };
+
+		MergeLines(destination.GetLines(), source.GetLines(), lines);
+		mergedFile.AddLines(std::move(lines));
+		destination = mergedFile;
+	}
+
 	//-------------------------------------------------------------------------
 	void CoverageDataMerger::MergeFileCoverage(CoverageData& coverageData) const
 	{
@@ -164,11 +251,18 @@ namespace CppCoverage
 				fileCoveragesByPath[file->GetPath()].push_back(file.get());
 		}
 
+		std::vector<const std::vector<FileCoverage*>*> fileCoveragesToMerge;
 		for (const auto& fileCoverageByPath : fileCoveragesByPath)
 		{
 			const auto& fileCoverages = fileCoverageByPath.second;
 
-			MergeFileCoverages(fileCoverages);
+			if (fileCoverages.size() > 1)
+				fileCoveragesToMerge.push_back(&fileCoverages);
 		}
+
+		Tools::ParallelFor(fileCoveragesToMerge.size(), [&](size_t i)
+		{
+			MergeFileCoverages(*fileCoveragesToMerge[i]);
+		});
 	}
-}
+}
\ No newline at end of file
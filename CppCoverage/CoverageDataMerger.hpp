@@ -21,6 +21,7 @@
 namespace CppCoverage
 {
 	class CoverageData;
+	class FileCoverage;
 
 	class CPPCOVERAGE_DLL CoverageDataMerger
 	{
@@ -30,6 +31,10 @@ namespace CppCoverage
 		CoverageData Merge(const std::vector<CoverageData>&) const;
 		void MergeFileCoverage(CoverageData&) const;
 
+		// Add the lines of source to destination. A line is executed if it is
+		// executed in one of them.
+		void Merge(const FileCoverage& source, FileCoverage& destination) const;
+
 	private:
 		CoverageDataMerger(const CoverageDataMerger&) = delete;
 		CoverageDataMerger& operator=(const CoverageDataMerger&) = delete;
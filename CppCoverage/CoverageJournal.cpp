@@ -0,0 +1,210 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageJournal.hpp"
+
+#include <boost/crc.hpp>
+
+#include "Tools/Tool.hpp"
+#include "Tools/Log.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const size_t MaxBufferSize = 64 * 1024;
+		const size_t RecordHeaderSize = 8;
+
+		//---------------------------------------------------------------------
+		void AppendVarint(std::string& buffer, unsigned int value)
+		{
+			while (value >= 0x80)
+			{
+				buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			buffer.push_back(static_cast<char>(value));
+		}
+
+		//---------------------------------------------------------------------
+		void AppendString(std::string& buffer, const std::wstring& str)
+		{
+			auto utf8Str = Tools::ToUtf8String(str);
+
+			AppendVarint(buffer, static_cast<unsigned int>(utf8Str.size()));
+			buffer += utf8Str;
+		}
+
+		//---------------------------------------------------------------------
+		void SetLittleEndian32(std::string& buffer, size_t position, unsigned int value)
+		{
+			for (int i = 0; i < 4; ++i)
+				buffer[position + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const unsigned int CoverageJournal::FileTypeId = 0x4A43434F; // "OCCJ"
+	const unsigned int CoverageJournal::Version = 1;
+
+	//-------------------------------------------------------------------------
+	CoverageJournal::CoverageJournal(
+		const boost::filesystem::path& path,
+		const std::wstring& name,
+		std::chrono::milliseconds flushInterval,
+		bool syncOnFlush)
+		: flushInterval_{ flushInterval }
+		, lastFlush_{ std::chrono::steady_clock::now() }
+		, syncOnFlush_{ syncOnFlush }
+		, moduleCount_{ 0 }
+		, fileCount_{ 0 }
+		, lineCount_{ 0 }
+	{
+		Tools::CreateParentFolderIfNeeded(path);
+		hFile_ = CreateFileW(path.wstring().c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile_ == INVALID_HANDLE_VALUE)
+			THROW_LAST_ERROR(L"Cannot create the coverage journal " << path.wstring(), GetLastError());
+
+		std::string header(8, '\0');
+
+		SetLittleEndian32(header, 0, FileTypeId);
+		SetLittleEndian32(header, 4, Version);
+		Write(header.data(), header.size());
+
+		buffer_.reserve(MaxBufferSize + RecordHeaderSize);
+		buffer_.resize(RecordHeaderSize);
+		AddEntry(CoverageJournalEntry::Start);
+		AppendString(buffer_, name);
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageJournal::~CoverageJournal()
+	{
+		if (hFile_ == INVALID_HANDLE_VALUE)
+			return;
+		try
+		{
+			Flush();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR << "Cannot write the coverage journal: " << e.what();
+		}
+		CloseHandle(hFile_);
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int CoverageJournal::AddModule(const std::wstring& path)
+	{
+		AddEntry(CoverageJournalEntry::Module);
+		AppendString(buffer_, path);
+		FlushIfNeeded();
+
+		return moduleCount_++;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int CoverageJournal::AddFile(unsigned int moduleId, const std::wstring& path)
+	{
+		AddEntry(CoverageJournalEntry::File);
+		AppendVarint(buffer_, moduleId);
+		AppendString(buffer_, path);
+		FlushIfNeeded();
+
+		return fileCount_++;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int CoverageJournal::AddLine(unsigned int fileId, unsigned int lineNumber)
+	{
+		AddEntry(CoverageJournalEntry::Line);
+		AppendVarint(buffer_, fileId);
+		AppendVarint(buffer_, lineNumber);
+		FlushIfNeeded();
+
+		return lineCount_++;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::OnLineExecuted(unsigned int lineId)
+	{
+		AddEntry(CoverageJournalEntry::ExecutedLine);
+		AppendVarint(buffer_, lineId);
+		FlushIfNeeded();
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::Flush()
+	{
+		auto payloadSize = buffer_.size() - RecordHeaderSize;
+
+		if (payloadSize == 0)
+			return;
+
+		boost::crc_32_type crc;
+
+		crc.process_bytes(buffer_.data() + RecordHeaderSize, payloadSize);
+		SetLittleEndian32(buffer_, 0, static_cast<unsigned int>(payloadSize));
+		SetLittleEndian32(buffer_, 4, crc.checksum());
+		Write(buffer_.data(), buffer_.size());
+		buffer_.resize(RecordHeaderSize);
+
+		if (syncOnFlush_ && !FlushFileBuffers(hFile_))
+			THROW_LAST_ERROR(L"Cannot flush the coverage journal.", GetLastError());
+		lastFlush_ = std::chrono::steady_clock::now();
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::Close(int exitCode)
+	{
+		AddEntry(CoverageJournalEntry::Exit);
+		AppendVarint(buffer_, static_cast<unsigned int>(exitCode));
+		Flush();
+		CloseHandle(hFile_);
+		hFile_ = INVALID_HANDLE_VALUE;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::AddEntry(CoverageJournalEntry entry)
+	{
+		if (hFile_ == INVALID_HANDLE_VALUE)
+			THROW(L"The coverage journal is closed.");
+		buffer_.push_back(static_cast<char>(entry));
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::FlushIfNeeded()
+	{
+		if (buffer_.size() >= MaxBufferSize + RecordHeaderSize ||
+			std::chrono::steady_clock::now() - lastFlush_ >= flushInterval_)
+		{
+			Flush();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::Write(const void* data, size_t size)
+	{
+		DWORD written = 0;
+
+		if (!WriteFile(hFile_, data, static_cast<DWORD>(size), &written, nullptr) || written != size)
+			THROW_LAST_ERROR(L"Cannot write the coverage journal.", GetLastError());
+	}
+}
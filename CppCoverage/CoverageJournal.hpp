@@ -0,0 +1,90 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include <Windows.h>
+#include <boost/filesystem/path.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	enum class CoverageJournalEntry : unsigned char
+	{
+		Start,
+		Module,
+		File,
+		Line,
+		ExecutedLine,
+		Exit
+	};
+
+	// Append-only file where the coverage is written while the program runs.
+	// If OpenCppCoverage is killed, the coverage data can be rebuilt from the
+	// journal with CoverageJournalReader.
+	//
+	// The journal contains the lines to monitor and the lines executed, identified
+	// by the ids returned by AddModule, AddFile and AddLine. Entries are buffered
+	// and written in records with a checksum so that a record partially
+	// written is detected.
+	class CPPCOVERAGE_DLL CoverageJournal
+	{
+	public:
+		static const unsigned int FileTypeId;
+		static const unsigned int Version;
+
+		// A write is done when the buffer is full or when flushInterval has elapsed
+		// since the previous write. When syncOnFlush is true, each write is also
+		// flushed to the disk, so the journal survives a system crash.
+		CoverageJournal(
+			const boost::filesystem::path&,
+			const std::wstring& name,
+			std::chrono::milliseconds flushInterval,
+			bool syncOnFlush);
+		~CoverageJournal();
+
+		unsigned int AddModule(const std::wstring& path);
+		unsigned int AddFile(unsigned int moduleId, const std::wstring& path);
+		unsigned int AddLine(unsigned int fileId, unsigned int lineNumber);
+		void OnLineExecuted(unsigned int lineId);
+
+		void Flush();
+
+		// Mark the journal as complete. No entry can be added after.
+		void Close(int exitCode);
+
+	private:
+		CoverageJournal(const CoverageJournal&) = delete;
+		CoverageJournal& operator=(const CoverageJournal&) = delete;
+
+		void AddEntry(CoverageJournalEntry);
+		void FlushIfNeeded();
+		void Write(const void* data, size_t size);
+
+		HANDLE hFile_;
+		std::string buffer_;
+		std::chrono::milliseconds flushInterval_;
+		std::chrono::steady_clock::time_point lastFlush_;
+		bool syncOnFlush_;
+		unsigned int moduleCount_;
+		unsigned int fileCount_;
+		unsigned int lineCount_;
+	};
+}
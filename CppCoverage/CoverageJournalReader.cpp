@@ -0,0 +1,285 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageJournalReader.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <boost/crc.hpp>
+#include <boost/optional.hpp>
+
+#include "Tools/Tool.hpp"
+#include "Tools/Log.hpp"
+
+#include "CppCoverageException.hpp"
+#include "CoverageJournal.hpp"
+#include "CoverageData.hpp"
+#include "ModuleCoverage.hpp"
+#include "FileCoverage.hpp"
+#include "LineCoverage.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const size_t HeaderSize = 8;
+		const size_t RecordHeaderSize = 8;
+
+		//---------------------------------------------------------------------
+		unsigned int GetLittleEndian32(const char* data)
+		{
+			unsigned int value = 0;
+
+			for (int i = 0; i < 4; ++i)
+				value |= static_cast<unsigned int>(static_cast<unsigned char>(data[i])) << (8 * i);
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		std::string ReadFile(const fs::path& path)
+		{
+			std::ifstream ifs{ path.string(), std::ios::binary };
+
+			if (!ifs)
+				THROW(L"Cannot open the coverage journal " << path.wstring());
+			return{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+		}
+
+		//---------------------------------------------------------------------
+		class RecordDecoder
+		{
+		public:
+			RecordDecoder(const char* data, size_t size)
+				: current_{ data }
+				, end_{ data + size }
+			{
+			}
+
+			bool IsEnd() const
+			{
+				return current_ == end_;
+			}
+
+			unsigned int ReadVarint()
+			{
+				unsigned int value = 0;
+
+				for (int shift = 0; shift < 35; shift += 7)
+				{
+					auto byte = static_cast<unsigned char>(ReadByte());
+
+					value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0)
+						return value;
+				}
+				THROW(L"Invalid varint in the coverage journal.");
+			}
+
+			std::wstring ReadString()
+			{
+				auto size = ReadVarint();
+
+				if (size > static_cast<size_t>(end_ - current_))
+					THROW(L"Invalid string in the coverage journal.");
+				std::string str{ current_, size };
+				current_ += size;
+
+				return Tools::Utf8ToWString(str);
+			}
+
+			char ReadByte()
+			{
+				if (current_ == end_)
+					THROW(L"Invalid record in the coverage journal.");
+				return *current_++;
+			}
+
+		private:
+			const char* current_;
+			const char* end_;
+		};
+
+		//---------------------------------------------------------------------
+		struct JournalContent
+		{
+			struct Module
+			{
+				std::wstring path;
+				std::vector<unsigned int> fileIds;
+			};
+
+			struct File
+			{
+				std::wstring path;
+				std::vector<unsigned int> lineIds;
+			};
+
+			std::wstring name;
+			boost::optional<int> exitCode;
+			std::vector<Module> modules;
+			std::vector<File> files;
+			std::vector<LineCoverage> lines;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		T& GetById(std::vector<T>& values, unsigned int id)
+		{
+			if (id >= values.size())
+				THROW(L"Invalid id in the coverage journal.");
+			return values[id];
+		}
+
+		//---------------------------------------------------------------------
+		void ReadEntries(RecordDecoder& decoder, JournalContent& content)
+		{
+			while (!decoder.IsEnd())
+			{
+				switch (static_cast<CoverageJournalEntry>(decoder.ReadByte()))
+				{
+				case CoverageJournalEntry::Start:
+					content.name = decoder.ReadString();
+					break;
+				case CoverageJournalEntry::Module:
+					content.modules.push_back({ decoder.ReadString(), {} });
+					break;
+				case CoverageJournalEntry::File:
+				{
+					auto& module = GetById(content.modules, decoder.ReadVarint());
+
+					module.fileIds.push_back(static_cast<unsigned int>(content.files.size()));
+					content.files.push_back({ decoder.ReadString(), {} });
+					break;
+				}
+				case CoverageJournalEntry::Line:
+				{
+					auto& file = GetById(content.files, decoder.ReadVarint());
+
+					file.lineIds.push_back(static_cast<unsigned int>(content.lines.size()));
+					content.lines.emplace_back(decoder.ReadVarint(), false);
+					break;
+				}
+				case CoverageJournalEntry::ExecutedLine:
+				{
+					auto& line = GetById(content.lines, decoder.ReadVarint());
+					line = LineCoverage{ line.GetLineNumber(), true };
+					break;
+				}
+				case CoverageJournalEntry::Exit:
+					content.exitCode = static_cast<int>(decoder.ReadVarint());
+					break;
+				default:
+					THROW(L"Invalid entry in the coverage journal.");
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		CoverageData CreateCoverageData(const JournalContent& content)
+		{
+			auto exitCode = content.exitCode ? *content.exitCode : CoverageJournalReader::IncompleteJournalExitCode;
+			CoverageData coverageData{ content.name, exitCode };
+			std::vector<const JournalContent::Module*> modules;
+
+			// Same order as ExecutedAddressManager::CreateCoverageData.
+			for (const auto& module : content.modules)
+				modules.push_back(&module);
+			std::stable_sort(modules.begin(), modules.end(), [](const auto* module1, const auto* module2)
+			{
+				return module1->path < module2->path;
+			});
+
+			coverageData.ReserveModules(modules.size());
+			for (const auto* module : modules)
+			{
+				auto& moduleCoverage = coverageData.AddModule(module->path);
+
+				moduleCoverage.ReserveFiles(module->fileIds.size());
+				for (auto fileId : module->fileIds)
+				{
+					const auto& file = content.files[fileId];
+					auto& fileCoverage = moduleCoverage.AddFile(file.path);
+					std::vector<LineCoverage> lines;
+
+					lines.reserve(file.lineIds.size());
+					for (auto lineId : file.lineIds)
+						lines.push_back(content.lines[lineId]);
+					std::sort(lines.begin(), lines.end(), [](const auto& line1, const auto& line2)
+					{
+						return line1.GetLineNumber() < line2.GetLineNumber();
+					});
+					fileCoverage.AddLines(std::move(lines));
+				}
+			}
+
+			return coverageData;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const int CoverageJournalReader::IncompleteJournalExitCode = -1;
+
+	//-------------------------------------------------------------------------
+	bool CoverageJournalReader::IsCoverageJournal(const fs::path& path)
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+		char header[HeaderSize];
+
+		return ifs.read(header, HeaderSize) && GetLittleEndian32(header) == CoverageJournal::FileTypeId;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageData CoverageJournalReader::Read(const fs::path& path) const
+	{
+		auto journal = ReadFile(path);
+
+		if (journal.size() < HeaderSize || GetLittleEndian32(&journal[0]) != CoverageJournal::FileTypeId)
+			THROW(path.wstring() << L" is not a coverage journal.");
+		if (GetLittleEndian32(&journal[4]) != CoverageJournal::Version)
+			THROW(L"Unsupported version of the coverage journal " << path.wstring());
+
+		JournalContent content;
+		size_t position = HeaderSize;
+
+		while (journal.size() - position >= RecordHeaderSize)
+		{
+			auto payloadSize = GetLittleEndian32(&journal[position]);
+			auto checksum = GetLittleEndian32(&journal[position + 4]);
+			const auto* payload = journal.data() + position + RecordHeaderSize;
+			boost::crc_32_type crc;
+
+			if (payloadSize > journal.size() - position - RecordHeaderSize)
+				break;
+			crc.process_bytes(payload, payloadSize);
+			if (crc.checksum() != checksum)
+				break;
+
+			RecordDecoder decoder{ payload, payloadSize };
+			ReadEntries(decoder, content);
+			position += RecordHeaderSize + payloadSize;
+		}
+
+		if (position != journal.size())
+			LOG_WARNING << L"Ignore the end of the coverage journal " << path.wstring() << L": the record is incomplete.";
+		if (!content.exitCode)
+			LOG_WARNING << L"The coverage journal " << path.wstring() << L" was not closed: coverage is partial.";
+
+		return CreateCoverageData(content);
+	}
+}
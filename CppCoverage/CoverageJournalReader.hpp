@@ -0,0 +1,46 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+
+	// Rebuild the coverage data from a journal written by CoverageJournal.
+	class CPPCOVERAGE_DLL CoverageJournalReader
+	{
+	public:
+		// Exit code of a journal not closed, for example when OpenCppCoverage was killed.
+		static const int IncompleteJournalExitCode;
+
+		CoverageJournalReader() = default;
+
+		static bool IsCoverageJournal(const boost::filesystem::path&);
+
+		// Records after the last valid one are ignored: they are the records
+		// not fully written when the journal stopped.
+		CoverageData Read(const boost::filesystem::path&) const;
+
+	private:
+		CoverageJournalReader(const CoverageJournalReader&) = delete;
+		CoverageJournalReader& operator=(const CoverageJournalReader&) = delete;
+	};
+}
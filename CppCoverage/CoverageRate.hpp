@@ -26,7 +26,7 @@ namespace CppCoverage
 		CoverageRate();
 		CoverageRate(int executedLinesCount, int unexecutedLinesCount);
 		
-		CoverageRate& operator=(const CoverageRate&) = delete;
+		CoverageRate& operator=(const CoverageRate&) = default;
 		CoverageRate(const CoverageRate&) = default;
 
 		int GetExecutedLinesCount() const;
@@ -17,6 +17,8 @@
 #include "stdafx.h"
 #include "CoverageRateComputer.hpp"
 
+#include <algorithm>
+
 #include "CoverageData.hpp"
 #include "ModuleCoverage.hpp"
 #include "FileCoverage.hpp"
@@ -27,40 +29,29 @@ namespace CppCoverage
 	namespace
 	{
 		//---------------------------------------------------------------------
-		CoverageRate ComputeFileCoverage(const FileCoverage& file)
-		{
-			int executedLines = 0;
-			int unexecutedLines = 0;
-
-			for (const auto& lineCoverage : file.GetLines())
-			{
-				if (lineCoverage.HasBeenExecuted())
-					++executedLines;
-				else
-					++unexecutedLines;
-			}
-
-			return CoverageRate{executedLines, unexecutedLines};
-		}
-		
-		//---------------------------------------------------------------------
-		template<typename Object>
+		template<typename Object, typename GetCoverageRate>
 		std::vector<Object*> SortByCoverageRate(
 			const std::vector<std::unique_ptr<Object>>& objects,
-			const std::unordered_map<const Object*, CoverageRate>& coverageRates)
+			GetCoverageRate getCoverageRate)
 		{
-			std::vector<Object*> sortedObjects;
+			std::vector<std::pair<int, Object*>> objectsByPercentRate;
 			
+			objectsByPercentRate.reserve(objects.size());
 			for (const auto& object : objects)
-				sortedObjects.push_back(object.get());
+				objectsByPercentRate.emplace_back(getCoverageRate(*object).GetPercentRate(), object.get());
 
-			std::sort(sortedObjects.begin(), sortedObjects.end(), 
-				[&](const Object* object1, const Object* object2)
+			std::stable_sort(objectsByPercentRate.begin(), objectsByPercentRate.end(),
+				[](const std::pair<int, Object*>& pair1, const std::pair<int, Object*>& pair2)
 			{
-				return coverageRates.at(object1).GetPercentRate() 
-					 < coverageRates.at(object2).GetPercentRate();
+				return pair1.first < pair2.first;
 			});
 
+			std::vector<Object*> sortedObjects;
+
+			sortedObjects.reserve(objectsByPercentRate.size());
+			for (const auto& pair : objectsByPercentRate)
+				sortedObjects.push_back(pair.second);
+
 			return sortedObjects;
 		}
 	}
@@ -75,17 +66,14 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	void CoverageRateComputer::ComputeCoverageRateCache(const CoverageData& coverageData)
 	{
+		// File coverage rates are maintained by FileCoverage itself, 
+		// only the sums need to be computed.
 		for (const auto& module : coverageData.GetModules())
 		{
 			CoverageRate moduleCoverageRate;
 
 			for (const auto& file : module->GetFiles())
-			{
-				CoverageRate fileCoverageRate = ComputeFileCoverage(*file);
-
-				moduleCoverageRate += fileCoverageRate;
-				fileCoverageRate_.emplace(file.get(), fileCoverageRate);
-			}
+				moduleCoverageRate += file->GetCoverageRate();
 
 			moduleCoverageRate_.emplace(module.get(), moduleCoverageRate);
 			coverageRate_ += moduleCoverageRate;
@@ -95,14 +83,16 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	std::vector<ModuleCoverage*> CoverageRateComputer::SortModulesByCoverageRate() const
 	{
-		return SortByCoverageRate(coverageData_.GetModules(), moduleCoverageRate_);
+		return SortByCoverageRate(coverageData_.GetModules(), 
+			[&](const ModuleCoverage& module) -> const CoverageRate& { return GetCoverageRate(module); });
 	}
 
 	//-------------------------------------------------------------------------
 	std::vector<FileCoverage*> CoverageRateComputer::SortFilesByCoverageRate(
 		const ModuleCoverage& modules) const
 	{
-		return SortByCoverageRate(modules.GetFiles(), fileCoverageRate_);
+		return SortByCoverageRate(modules.GetFiles(), 
+			[](const FileCoverage& file) -> const CoverageRate& { return file.GetCoverageRate(); });
 	}
 
 	//-------------------------------------------------------------------------
@@ -120,6 +110,6 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	const CoverageRate& CoverageRateComputer::GetCoverageRate(const FileCoverage& file) const
 	{
-		return fileCoverageRate_.at(&file);
+		return file.GetCoverageRate();
 	}
 }
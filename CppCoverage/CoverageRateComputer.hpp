@@ -47,7 +47,6 @@ namespace CppCoverage
 		const CoverageData& coverageData_;
 
 		std::unordered_map<const ModuleCoverage*, CoverageRate> moduleCoverageRate_;
-		std::unordered_map<const FileCoverage*, CoverageRate> fileCoverageRate_;
 		CoverageRate coverageRate_;
 	};
 }
\ No newline at end of file
@@ -59,9 +59,11 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	Debugger::Debugger(
 		bool coverChildren,
-		bool continueAfterCppException)
+		bool continueAfterCppException,
+		DWORD waitTimeout)
 		: coverChildren_{ coverChildren }
 		, continueAfterCppException_{ continueAfterCppException }
+		, waitTimeout_{ waitTimeout }
 	{
 	}
 
@@ -82,8 +84,15 @@ namespace CppCoverage
 
 		while (!exitCode || !processHandles_.empty())
 		{
-			if (!WaitForDebugEvent(&debugEvent, INFINITE))
-				THROW_LAST_ERROR(L"Error WaitForDebugEvent:", GetLastError());
+			if (!WaitForDebugEvent(&debugEvent, waitTimeout_))
+			{
+				auto lastError = GetLastError();
+
+				if (lastError != ERROR_SEM_TIMEOUT)
+					THROW_LAST_ERROR(L"Error WaitForDebugEvent:", lastError);
+				debugEventsHandler.OnWaitTimeout();
+				continue;
+			}
 
 			ProcessStatus processStatus = HandleDebugEvent(debugEvent, debugEventsHandler);
 			
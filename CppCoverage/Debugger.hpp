@@ -31,9 +31,12 @@ namespace CppCoverage
 	class CPPCOVERAGE_DLL Debugger
 	{
 	public:
+		// waitTimeout is the time in milliseconds to wait for a debug event before
+		// calling IDebugEventsHandler::OnWaitTimeout.
 		Debugger(
 			bool coverChildren,
-			bool continueAfterCppException);
+			bool continueAfterCppException,
+			DWORD waitTimeout = INFINITE);
 
 		int Debug(const StartInfo&, IDebugEventsHandler&);
 		size_t GetRunningProcesses() const;
@@ -81,6 +84,7 @@ namespace CppCoverage
 		boost::optional<DWORD> rootProcessId_;
 		bool coverChildren_;
 		bool continueAfterCppException_;
+		DWORD waitTimeout_;
 	};
 }
 
@@ -26,9 +26,17 @@
 #include "ModuleCoverage.hpp"
 #include "FileCoverage.hpp"
 #include "Address.hpp"
+#include "CoverageJournal.hpp"
 
 namespace CppCoverage
 {
+	//-------------------------------------------------------------------------
+	struct ExecutedAddressManager::LineState
+	{
+		bool hasBeenExecuted = false;
+		unsigned int journalId = 0;
+	};
+
 	//-------------------------------------------------------------------------
 	struct ExecutedAddressManager::Line
 	{
@@ -40,14 +48,15 @@ namespace CppCoverage
 
 		const unsigned char instructionToRestore_;
 		void* const dllBaseOfImage_;
-		boost::container::small_vector<bool*, 1> hasBeenExecutedCollection_;
+		boost::container::small_vector<LineState*, 1> lineStates_;
 	};
 
 	//-------------------------------------------------------------------------
 	struct ExecutedAddressManager::File
 	{		
 		// Use map to have iterator always valid
-		std::map<unsigned int, bool> lines;
+		std::map<unsigned int, LineState> lines;
+		unsigned int journalId = 0;
 	};
 
 	//-------------------------------------------------------------------------
@@ -59,6 +68,7 @@ namespace CppCoverage
 
 		const std::wstring name_;
 		std::unordered_map<std::wstring, File> files_;
+		unsigned int journalId_ = 0;
 	};
 	
 	//-------------------------------------------------------------------------
@@ -73,6 +83,35 @@ namespace CppCoverage
 	{
 	}
 
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::SetJournal(std::shared_ptr<CoverageJournal> journal)
+	{
+		journal_ = journal;
+		if (!journal_)
+			return;
+
+		// Ids from a previous journal are not valid for this one.
+		for (auto& pair : modules_)
+		{
+			auto& module = pair.second;
+			module.journalId_ = journal_->AddModule(module.name_);
+
+			for (auto& filePair : module.files_)
+			{
+				auto& file = filePair.second;
+				file.journalId = journal_->AddFile(module.journalId_, filePair.first);
+
+				for (auto& linePair : file.lines)
+				{
+					auto& lineState = linePair.second;
+					lineState.journalId = journal_->AddLine(file.journalId, linePair.first);
+					if (lineState.hasBeenExecuted)
+						journal_->OnLineExecuted(lineState.journalId);
+				}
+			}
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	void ExecutedAddressManager::AddModule(
 		const std::wstring& moduleName,
@@ -81,7 +120,11 @@ namespace CppCoverage
 		auto it = modules_.find(moduleName);
 
 		if (it == modules_.end())
+		{
 			it = modules_.emplace(moduleName, Module{ moduleName }).first;
+			if (journal_)
+				it->second.journalId_ = journal_->AddModule(moduleName);
+		}
 		lastModule_.module_ = &it->second;
 		lastModule_.baseOfImage_ = dllBaseOfImage;
 	}
@@ -94,7 +137,24 @@ namespace CppCoverage
 		unsigned char instructionValue)
 	{
 		auto& module = GetLastAddedModule();
-		auto& file = module.files_[filename];
+		auto itFile = module.files_.find(filename);
+
+		if (itFile == module.files_.end())
+		{
+			itFile = module.files_.emplace(filename, File{}).first;
+			if (journal_)
+				itFile->second.journalId = journal_->AddFile(module.journalId_, filename);
+		}
+
+		auto& file = itFile->second;
+		auto itLine = file.lines.find(lineNumber);
+
+		if (itLine == file.lines.end())
+		{
+			itLine = file.lines.emplace(lineNumber, LineState{}).first;
+			if (journal_)
+				itLine->second.journalId = journal_->AddLine(file.journalId, lineNumber);
+		}
 
 		LOG_TRACE << "RegisterAddress: " << address << " for " << filename << ":" << lineNumber;
 
@@ -111,7 +171,7 @@ namespace CppCoverage
 		}
 		
 		auto& line = itAddress->second;
-		line.hasBeenExecutedCollection_.push_back(&file.lines[lineNumber]);
+		line.lineStates_.push_back(&itLine->second);
 		
 		return keepBreakpoint;
 	}
@@ -136,11 +196,13 @@ namespace CppCoverage
 
 		auto& line = it->second;
 
-		for (bool* hasBeenExecuted : line.hasBeenExecutedCollection_)
+		for (LineState* lineState : line.lineStates_)
 		{
-			if (!hasBeenExecuted)
+			if (!lineState)
 				THROW("Invalid pointer");
-			*hasBeenExecuted = true;
+			if (journal_ && !lineState->hasBeenExecuted)
+				journal_->OnLineExecuted(lineState->journalId);
+			lineState->hasBeenExecuted = true;
 		}
 		return line.instructionToRestore_;
 	}
@@ -152,25 +214,31 @@ namespace CppCoverage
 	{
 		CoverageData coverageData{ name, exitCode };
 
+		coverageData.ReserveModules(modules_.size());
 		for (const auto& pair : modules_)
 		{
 			const auto& module = pair.second;
 			auto& moduleCoverage = coverageData.AddModule(module.name_);
 
+			moduleCoverage.ReserveFiles(module.files_.size());
 			for (const auto& file : module.files_)
 			{
 				const std::wstring& name = file.first;
 				const File& fileData = file.second;
 
 				auto& fileCoverage = moduleCoverage.AddFile(name);
+				std::vector<LineCoverage> lines;
 
+				// fileData.lines is a std::map so lines are already sorted.
+				lines.reserve(fileData.lines.size());
 				for (const auto& pair : fileData.lines)
 				{
 					auto lineNumber = pair.first;
-					bool hasLineBeenExecuted = pair.second;
+					bool hasLineBeenExecuted = pair.second.hasBeenExecuted;
 					
-					fileCoverage.AddLine(lineNumber, hasLineBeenExecuted);
+					lines.emplace_back(lineNumber, hasLineBeenExecuted);
 				}
+				fileCoverage.AddLines(std::move(lines));
 			}			
 		}
 
@@ -20,6 +20,7 @@
 
 #include <Windows.h>
 #include <map>
+#include <memory>
 #include <set>
 #include <boost/optional.hpp>
 
@@ -30,6 +31,7 @@ namespace CppCoverage
 {
 	class FileCoverage;
 	class Address;
+	class CoverageJournal;
 
 	class CPPCOVERAGE_DLL ExecutedAddressManager
 	{
@@ -37,6 +39,10 @@ namespace CppCoverage
 		ExecutedAddressManager();
 		~ExecutedAddressManager();
 
+		// Lines registered and executed after this call are also written to the journal.
+		// Lines already known are written again to the new journal. nullptr stops journaling.
+		void SetJournal(std::shared_ptr<CoverageJournal>);
+
 		void AddModule(const std::wstring& moduleName, void* dllBaseOfImage);
 		void OnUnloadModule(HANDLE hProcess, void* dllBaseOfImage);
 
@@ -56,6 +62,7 @@ namespace CppCoverage
 		struct File;
 		struct File;
 		struct Line;
+		struct LineState;
 		struct LastModule
 		{
 			Module* module_;
@@ -72,5 +79,6 @@ namespace CppCoverage
 		std::map<std::wstring, Module> modules_;
 		std::map<Address, Line> addressLineMap_;
 		LastModule lastModule_;
+		std::shared_ptr<CoverageJournal> journal_;
 	};
 }
@@ -17,13 +17,44 @@
 #include "stdafx.h"
 #include "FileCoverage.hpp"
 
+#include <algorithm>
+
 #include "CppCoverageException.hpp"
 
 namespace CppCoverage
 {
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct LineNumberLess
+		{
+			bool operator()(const LineCoverage& line, unsigned int lineNumber) const
+			{
+				return line.GetLineNumber() < lineNumber;
+			}
+		};
+
+		//---------------------------------------------------------------------
+		bool IsStrictlySorted(const std::vector<LineCoverage>& lines)
+		{
+			return std::adjacent_find(lines.begin(), lines.end(),
+				[](const LineCoverage& line, const LineCoverage& nextLine)
+			{
+				return line.GetLineNumber() >= nextLine.GetLineNumber();
+			}) == lines.end();
+		}
+
+		//---------------------------------------------------------------------
+		CoverageRate ToCoverageRate(bool hasBeenExecuted)
+		{
+			return hasBeenExecuted ? CoverageRate{ 1, 0 } : CoverageRate{ 0, 1 };
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	FileCoverage::FileCoverage(const boost::filesystem::path& path)
 		: path_(path)
+		, lines_(std::make_shared<std::vector<LineCoverage>>())
 	{
 	}
 
@@ -31,18 +62,61 @@ namespace CppCoverage
 	void FileCoverage::AddLine(unsigned int lineNumber, bool hasBeenExecuted)
 	{
 		LineCoverage line{ lineNumber, hasBeenExecuted };
+		auto& lines = GetMutableLines();
+
+		// Lines are usually added in order.
+		if (lines.empty() || lines.back().GetLineNumber() < lineNumber)
+			lines.push_back(line);
+		else
+		{
+			auto it = std::lower_bound(lines.begin(), lines.end(), lineNumber, LineNumberLess{});
 
-		if (!lines_.emplace(lineNumber, line).second)
-			THROW(L"Line " << lineNumber << L" already exists for " << path_.wstring());
+			if (it != lines.end() && it->GetLineNumber() == lineNumber)
+				THROW(L"Line " << lineNumber << L" already exists for " << path_.wstring());
+			lines.insert(it, line);
+		}
+		coverageRate_ += ToCoverageRate(hasBeenExecuted);
 	}
 
 	//-------------------------------------------------------------------------
 	void FileCoverage::UpdateLine(unsigned int lineNumber, bool hasBeenExecuted)
 	{
-		if (!lines_.erase(lineNumber))
+		const auto* line = (*this)[lineNumber];
+
+		if (!line)
 			THROW(L"Line " << lineNumber << L" does not exists and cannot be updated for " << path_.wstring());
 
-		AddLine(lineNumber, hasBeenExecuted);
+		if (line->HasBeenExecuted() != hasBeenExecuted)
+		{
+			auto& lines = GetMutableLines();
+			auto it = std::lower_bound(lines.begin(), lines.end(), lineNumber, LineNumberLess{});
+			auto executedDelta = hasBeenExecuted ? 1 : -1;
+
+			coverageRate_ += CoverageRate{ executedDelta, -executedDelta };
+			*it = LineCoverage{ lineNumber, hasBeenExecuted };
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void FileCoverage::AddLines(std::vector<LineCoverage>&& lines)
+	{
+		if (lines_->empty() && IsStrictlySorted(lines))
+		{
+			lines_ = std::make_shared<std::vector<LineCoverage>>(std::move(lines));
+			for (const auto& line : *lines_)
+				coverageRate_ += ToCoverageRate(line.HasBeenExecuted());
+			return;
+		}
+
+		ReserveLines(lines_->size() + lines.size());
+		for (const auto& line : lines)
+			AddLine(line.GetLineNumber(), line.HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	void FileCoverage::ReserveLines(size_t lineCount)
+	{
+		GetMutableLines().reserve(lineCount);
 	}
 
 	//-------------------------------------------------------------------------
@@ -54,22 +128,33 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	const LineCoverage* FileCoverage::operator[](unsigned int line) const
 	{
-		auto it = lines_.find(line);
+		auto it = std::lower_bound(lines_->begin(), lines_->end(), line, LineNumberLess{});
 
-		if (it == lines_.end())
+		if (it == lines_->end() || it->GetLineNumber() != line)
 			return 0;
 
-		return &it->second;
+		return &*it;
 	}
 		
 	//-------------------------------------------------------------------------
-	std::vector<LineCoverage> FileCoverage::GetLines() const
+	const std::vector<LineCoverage>& FileCoverage::GetLines() const
 	{
-		std::vector<LineCoverage> lines;
-		
-		for (const auto& pair : lines_)
-			lines.push_back(pair.second);
-		
-		return lines;
+		return *lines_;
 	}	
-}
+
+	//-------------------------------------------------------------------------
+	const CoverageRate& FileCoverage::GetCoverageRate() const
+	{
+		return coverageRate_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<LineCoverage>& FileCoverage::GetMutableLines()
+	{
+		// Lines shared with a copy are duplicated before any modification.
+		// use_count is not synchronized with the other owners: see operator=.
+		if (lines_.use_count() > 1)
+			lines_ = std::make_shared<std::vector<LineCoverage>>(*lines_);
+		return *lines_;
+	}
+}
\ No newline at end of file
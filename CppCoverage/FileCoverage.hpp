@@ -18,9 +18,11 @@
 
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
-#include <map>
+#include <vector>
+#include <memory>
 
 #include "LineCoverage.hpp"
+#include "CoverageRate.hpp"
 #include "CppCoverageExport.hpp"
 
 namespace CppCoverage
@@ -33,18 +35,31 @@ namespace CppCoverage
 		void AddLine(unsigned int lineNumber, bool hasBeenExecuted);
 		void UpdateLine(unsigned int lineNumber, bool hasBeenExecuted);
 
+		// Bulk construction: lines sorted by line number are appended without
+		// any lookup. Unsorted lines are still accepted but are slower.
+		void AddLines(std::vector<LineCoverage>&& lines);
+		void ReserveLines(size_t lineCount);
+
 		const boost::filesystem::path& GetPath() const;
 		const LineCoverage* operator[](unsigned int line) const;
-		std::vector<LineCoverage> GetLines() const;
+		const std::vector<LineCoverage>& GetLines() const;
+
+		// Kept up to date by AddLine, AddLines and UpdateLine.
+		const CoverageRate& GetCoverageRate() const;
 
+		// Lines are shared with the copy until one of them is modified.
+		// The copy on write is not synchronized: file coverages sharing their
+		// lines must not be modified concurrently, even if they are different objects.
 		FileCoverage& operator=(const FileCoverage&) = default;
 
 	private:
 		FileCoverage(const FileCoverage&) = delete;
+		std::vector<LineCoverage>& GetMutableLines();
 			
 	private:
 		boost::filesystem::path path_;
-		std::map<unsigned int, LineCoverage> lines_;	
+		std::shared_ptr<std::vector<LineCoverage>> lines_; // Sorted by line number
+		CoverageRate coverageRate_;
 	};
 }
 
@@ -44,4 +44,9 @@ namespace CppCoverage
 	{ 
 		return IDebugEventsHandler::ExceptionType::NotHandled;
 	}
+
+	//-------------------------------------------------------------------------
+	void IDebugEventsHandler::OnWaitTimeout()
+	{
+	}
 }
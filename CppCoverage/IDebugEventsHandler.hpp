@@ -42,6 +42,9 @@ namespace CppCoverage
 		virtual void OnLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&);
 		virtual void OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&);
 		virtual ExceptionType OnException(HANDLE hProcess, HANDLE hThread, const EXCEPTION_DEBUG_INFO&);
+
+		// Called when no debug event was received during the wait timeout of the debugger.
+		virtual void OnWaitTimeout();
 		
 	private:
 		IDebugEventsHandler(const IDebugEventsHandler&) = delete;
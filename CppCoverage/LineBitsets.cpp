@@ -0,0 +1,191 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "LineBitsets.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "LineCoverage.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		const unsigned int BitsPerWord = 64;
+
+		//---------------------------------------------------------------------
+		// Bitsets smaller than this are always allowed.
+		const size_t MinWordCountLimit = 1024;
+
+		//---------------------------------------------------------------------
+		struct LineRange
+		{
+			unsigned int firstLineNumber;
+			unsigned int lastLineNumber;
+		};
+
+		//---------------------------------------------------------------------
+		// firstLineNumber > lastLineNumber when there is no line.
+		LineRange ComputeLineRange(const std::vector<const std::vector<LineCoverage>*>& linesCollection)
+		{
+			LineRange range{ std::numeric_limits<unsigned int>::max(), 0 };
+
+			for (const auto* lines : linesCollection)
+			{
+				if (!lines->empty())
+				{
+					range.firstLineNumber = std::min(range.firstLineNumber, lines->front().GetLineNumber());
+					range.lastLineNumber = std::max(range.lastLineNumber, lines->back().GetLineNumber());
+				}
+			}
+
+			return range;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetWordCount(const LineRange& range)
+		{
+			if (range.firstLineNumber > range.lastLineNumber)
+				return 0;
+			return (range.lastLineNumber - range.firstLineNumber) / BitsPerWord + 1;
+		}
+
+		//---------------------------------------------------------------------
+		void SetBit(std::vector<uint64_t>& bitset, unsigned int index)
+		{
+			bitset[index / BitsPerWord] |= uint64_t{ 1 } << (index % BitsPerWord);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	LineBitsets::LineBitsets(const std::vector<const std::vector<LineCoverage>*>& linesCollection)
+	{
+		auto range = ComputeLineRange(linesCollection);
+		auto wordCount = GetWordCount(range);
+
+		firstLineNumber_ = range.firstLineNumber;
+		lines_.resize(wordCount);
+		executedLines_.resize(wordCount);
+	}
+
+	//-------------------------------------------------------------------------
+	bool LineBitsets::IsSuitableFor(const std::vector<const std::vector<LineCoverage>*>& linesCollection)
+	{
+		size_t lineCount = 0;
+
+		for (const auto* lines : linesCollection)
+			lineCount += lines->size();
+
+		// A word holds 64 lines: allow on average one word by line.
+		return GetWordCount(ComputeLineRange(linesCollection)) <= std::max(lineCount, MinWordCountLimit);
+	}
+
+	//-------------------------------------------------------------------------
+	WordRange LineBitsets::Assign(const std::vector<LineCoverage>& lines)
+	{
+		if (lines.empty())
+			return{ 0, 0 };
+
+		auto firstWord = (lines.front().GetLineNumber() - firstLineNumber_) / BitsPerWord;
+		auto wordCount = (lines.back().GetLineNumber() - firstLineNumber_) / BitsPerWord - firstWord + 1;
+
+		std::fill_n(lines_.begin() + firstWord, wordCount, 0);
+		std::fill_n(executedLines_.begin() + firstWord, wordCount, 0);
+		for (const auto& line : lines)
+		{
+			auto index = line.GetLineNumber() - firstLineNumber_;
+
+			SetBit(lines_, index);
+			if (line.HasBeenExecuted())
+				SetBit(executedLines_, index);
+		}
+
+		return{ firstWord, wordCount };
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<LineCoverage> LineBitsets::ToLines() const
+	{
+		std::vector<LineCoverage> lines;
+
+		for (size_t word = 0; word < lines_.size(); ++word)
+		{
+			auto lineBits = lines_[word];
+			auto executedLineBits = executedLines_[word];
+
+			for (unsigned int bit = 0; lineBits; ++bit, lineBits >>= 1, executedLineBits >>= 1)
+			{
+				if (lineBits & 1)
+				{
+					auto lineNumber = firstLineNumber_ + static_cast<unsigned int>(word * BitsPerWord) + bit;
+					lines.emplace_back(lineNumber, (executedLineBits & 1) != 0);
+				}
+			}
+		}
+
+		return lines;
+	}
+
+	//-------------------------------------------------------------------------
+	WordRange LineBitsets::GetWordRange() const
+	{
+		return{ 0, lines_.size() };
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<uint64_t>& LineBitsets::GetLines()
+	{
+		return lines_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<uint64_t>& LineBitsets::GetLines() const
+	{
+		return lines_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<uint64_t>& LineBitsets::GetExecutedLines()
+	{
+		return executedLines_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<uint64_t>& LineBitsets::GetExecutedLines() const
+	{
+		return executedLines_;
+	}
+
+	//-------------------------------------------------------------------------
+	void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		std::vector<uint64_t>& destination,
+		const std::vector<uint64_t>& source,
+		const WordRange& range)
+	{
+		if (range.wordCount)
+		{
+			ApplyBitwiseOperation(
+				operation,
+				&destination[range.firstWord],
+				&source[range.firstWord],
+				range.wordCount);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BitwiseOperations.hpp"
+
+namespace CppCoverage
+{
+	class LineCoverage;
+
+	struct WordRange
+	{
+		size_t firstWord;
+		size_t wordCount;
+	};
+
+	// Lines of a file as two bitsets indexed by line number - first line number:
+	// one for the lines and one for the executed lines.
+	class LineBitsets
+	{
+	public:
+		// The bitsets are large enough for all the lines of linesCollection.
+		explicit LineBitsets(const std::vector<const std::vector<LineCoverage>*>& linesCollection);
+
+		// Return false when the line numbers of linesCollection are so sparse that
+		// the bitsets would be much larger than the lines. Use a linear merge instead.
+		static bool IsSuitableFor(const std::vector<const std::vector<LineCoverage>*>& linesCollection);
+
+		// Clear the words covering lines and set the bits of lines.
+		// Return the range of modified words.
+		WordRange Assign(const std::vector<LineCoverage>& lines);
+		std::vector<LineCoverage> ToLines() const;
+
+		WordRange GetWordRange() const;
+		std::vector<uint64_t>& GetLines();
+		const std::vector<uint64_t>& GetLines() const;
+		std::vector<uint64_t>& GetExecutedLines();
+		const std::vector<uint64_t>& GetExecutedLines() const;
+
+	private:
+		LineBitsets(const LineBitsets&) = delete;
+		LineBitsets& operator=(const LineBitsets&) = delete;
+
+	private:
+		unsigned int firstLineNumber_;
+		std::vector<uint64_t> lines_;
+		std::vector<uint64_t> executedLines_;
+	};
+
+	void ApplyBitwiseOperation(
+		BitwiseOperation operation,
+		std::vector<uint64_t>& destination,
+		const std::vector<uint64_t>& source,
+		const WordRange& range);
+}
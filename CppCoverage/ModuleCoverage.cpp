@@ -40,6 +40,12 @@ namespace CppCoverage
 		return *files_.back();
 	}
 
+	//-------------------------------------------------------------------------
+	void ModuleCoverage::ReserveFiles(size_t fileCount)
+	{
+		files_.reserve(fileCount);
+	}
+
 	//-------------------------------------------------------------------------
 	const boost::filesystem::path& ModuleCoverage::GetPath() const
 	{
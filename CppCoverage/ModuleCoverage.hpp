@@ -37,6 +37,7 @@ namespace CppCoverage
 		~ModuleCoverage();
 
 		FileCoverage& AddFile(const boost::filesystem::path& filename);
+		void ReserveFiles(size_t fileCount);
 		
 		const boost::filesystem::path& GetPath() const;
 		const T_FileCoverageCollection& GetFiles() const;
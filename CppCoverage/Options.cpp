@@ -34,6 +34,22 @@ namespace CppCoverage
 			}
 			THROW("Invalid Log level.");
 		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetCoverageDataOperationStr(const boost::optional<CoverageDataOperation>& operation)
+		{
+			if (!operation)
+				return L"None";
+
+			switch (*operation)
+			{
+			case CoverageDataOperation::Difference: return L"Difference";
+			case CoverageDataOperation::Intersection: return L"Intersection";
+			case CoverageDataOperation::SymmetricDifference: return L"Symmetric difference";
+			case CoverageDataOperation::NewlyUncovered: return L"Newly uncovered";
+			}
+			THROW("Invalid coverage data operation.");
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -49,6 +65,8 @@ namespace CppCoverage
 		, isAggregateByFileModeEnabled_{true}
 		, isContinueAfterCppExceptionModeEnabled_{false}
 		, isOptimizedBuildSupportEnabled_{false}
+		, isJournalSyncModeEnabled_{false}
+		, isStatModeEnabled_{false}
 	{
 		if (startInfo)
 			optionalStartInfo_ = *startInfo;
@@ -195,6 +213,66 @@ namespace CppCoverage
 		return excludedLineRegexes_;
 	}
 
+	//-------------------------------------------------------------------------
+	void Options::SetCoverageDataOperation(CoverageDataOperation operation)
+	{
+		coverageDataOperation_ = operation;
+	}
+
+	//-------------------------------------------------------------------------
+	const boost::optional<CoverageDataOperation>& Options::GetCoverageDataOperation() const
+	{
+		return coverageDataOperation_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetJournalPath(const boost::filesystem::path& path)
+	{
+		journalPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const boost::optional<boost::filesystem::path>& Options::GetJournalPath() const
+	{
+		return journalPath_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableJournalSyncMode()
+	{
+		isJournalSyncModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsJournalSyncModeEnabled() const
+	{
+		return isJournalSyncModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableStatMode()
+	{
+		isStatModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsStatModeEnabled() const
+	{
+		return isStatModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetMinCoverage(double minCoverage)
+	{
+		minCoverage_ = minCoverage;
+	}
+
+	//-------------------------------------------------------------------------
+	const boost::optional<double>& Options::GetMinCoverage() const
+	{
+		return minCoverage_;
+	}
+
 	//-------------------------------------------------------------------------
 	std::wostream& operator<<(std::wostream& ostr, const Options& options)
 	{
@@ -231,6 +309,15 @@ namespace CppCoverage
 			ostr << excludedRegex << L" ";
 		ostr << std::endl;
 
+		ostr << L"Coverage operation: " << GetCoverageDataOperationStr(options.coverageDataOperation_) << std::endl;
+		ostr << L"Journal: " << (options.journalPath_ ? options.journalPath_->wstring() : L"") << std::endl;
+		ostr << L"Journal sync: " << options.isJournalSyncModeEnabled_ << std::endl;
+		ostr << L"Stat: " << options.isStatModeEnabled_ << std::endl;
+		ostr << L"Min coverage: ";
+		if (options.minCoverage_)
+			ostr << *options.minCoverage_;
+		ostr << std::endl;
+
 		return ostr;
 	}
 }
@@ -24,6 +24,7 @@
 #include "StartInfo.hpp"
 #include "UnifiedDiffSettings.hpp"
 #include "OptionsExport.hpp"
+#include "CoverageDataOperation.hpp"
 
 namespace CppCoverage
 {
@@ -81,6 +82,21 @@ namespace CppCoverage
 		void AddExcludedLineRegex(const std::wstring&);
 		const std::vector<std::wstring>& GetExcludedLineRegexes() const;
 
+		void SetCoverageDataOperation(CoverageDataOperation);
+		const boost::optional<CoverageDataOperation>& GetCoverageDataOperation() const;
+
+		void SetJournalPath(const boost::filesystem::path&);
+		const boost::optional<boost::filesystem::path>& GetJournalPath() const;
+
+		void EnableJournalSyncMode();
+		bool IsJournalSyncModeEnabled() const;
+
+		void EnableStatMode();
+		bool IsStatModeEnabled() const;
+
+		void SetMinCoverage(double);
+		const boost::optional<double>& GetMinCoverage() const;
+
 		friend CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream&, const Options&);
 
 	private:
@@ -102,5 +118,10 @@ namespace CppCoverage
 		std::vector<boost::filesystem::path> inputCoveragePaths_;
 		std::vector<UnifiedDiffSettings> unifiedDiffSettingsCollection_;
 		std::vector<std::wstring> excludedLineRegexes_;
+		boost::optional<CoverageDataOperation> coverageDataOperation_;
+		boost::optional<boost::filesystem::path> journalPath_;
+		bool isJournalSyncModeEnabled_;
+		bool isStatModeEnabled_;
+		boost::optional<double> minCoverage_;
 	};
 }
\ No newline at end of file
@@ -48,7 +48,11 @@ namespace CppCoverage
 		static const std::map<OptionsExportType, std::wstring> optionsExportTypeTexts =
 		{ { OptionsExportType::Html, L"Html" },
 		{ OptionsExportType::Cobertura, L"Cobertura" },
-		{ OptionsExportType::Binary, L"Binary" } };
+		{ OptionsExportType::Binary, L"Binary" },
+		{ OptionsExportType::BinaryV2, L"BinaryV2" },
+		{ OptionsExportType::BinaryV2Compressed, L"BinaryV2Compressed" },
+		{ OptionsExportType::CompactHtml, L"CompactHtml" },
+		{ OptionsExportType::Lcov, L"Lcov" } };
 
 		return optionsExportTypeTexts.at(type_);
 	}
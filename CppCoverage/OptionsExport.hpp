@@ -27,7 +27,11 @@ namespace CppCoverage
 	{
 		Html,
 		Cobertura,
-		Binary
+		Binary,
+		BinaryV2,
+		BinaryV2Compressed,
+		CompactHtml,
+		Lcov
 	};
 
 	class CPPCOVERAGE_DLL OptionsExport
@@ -247,6 +247,86 @@ namespace CppCoverage
 					options.AddExcludedLineRegex(Tools::LocalToWString(excludedLineRegex));
 			}
 		}
+
+		//----------------------------------------------------------------------------
+		void SetCoverageDataOperation(const po::variables_map& variables, Options& options)
+		{
+			auto operationStr = GetOptionalValue<std::string>(variables, ProgramOptions::CoverageOperationOption);
+
+			if (!operationStr)
+				return;
+
+			const std::map<std::string, CoverageDataOperation> operations = {
+				{ ProgramOptions::CoverageOperationDifferenceValue, CoverageDataOperation::Difference },
+				{ ProgramOptions::CoverageOperationIntersectionValue, CoverageDataOperation::Intersection },
+				{ ProgramOptions::CoverageOperationSymmetricDifferenceValue, CoverageDataOperation::SymmetricDifference },
+				{ ProgramOptions::CoverageOperationNewlyUncoveredValue, CoverageDataOperation::NewlyUncovered } };
+			auto it = operations.find(*operationStr);
+
+			if (it == operations.end())
+				throw OptionsParserException(*operationStr + " is not a valid coverage operation.");
+			if (options.GetStartInfo() || options.GetInputCoveragePaths().size() != 2)
+			{
+				throw OptionsParserException("--" + ProgramOptions::CoverageOperationOption + 
+					" requires exactly two --" + ProgramOptions::InputCoverageValue + " and no program to execute.");
+			}
+
+			options.SetCoverageDataOperation(it->second);
+		}
+
+		//----------------------------------------------------------------------------
+		void SetJournal(const po::variables_map& variables, Options& options)
+		{
+			auto journalPath = GetOptionalValue<std::string>(variables, ProgramOptions::JournalOption);
+			bool isJournalSync = IsOptionSelected(variables, ProgramOptions::JournalSyncOption);
+
+			if (journalPath)
+			{
+				if (!options.GetStartInfo())
+					throw OptionsParserException("--" + ProgramOptions::JournalOption + " requires a program to execute.");
+				options.SetJournalPath(*journalPath);
+			}
+			if (isJournalSync)
+			{
+				if (!journalPath)
+				{
+					throw OptionsParserException("--" + ProgramOptions::JournalSyncOption +
+						" requires --" + ProgramOptions::JournalOption + ".");
+				}
+				options.EnableJournalSyncMode();
+			}
+		}
+
+		//----------------------------------------------------------------------------
+		void SetStat(const po::variables_map& variables, Options& options)
+		{
+			auto minCoverage = GetOptionalValue<double>(variables, ProgramOptions::MinCoverageOption);
+
+			if (IsOptionSelected(variables, ProgramOptions::StatOption))
+			{
+				if (options.GetStartInfo() || options.GetInputCoveragePaths().empty() || options.GetCoverageDataOperation())
+				{
+					throw OptionsParserException("--" + ProgramOptions::StatOption + " requires --" + 
+						ProgramOptions::InputCoverageValue + ", no program to execute and no --" + 
+						ProgramOptions::CoverageOperationOption + ".");
+				}
+				options.EnableStatMode();
+			}
+			if (minCoverage)
+			{
+				if (!options.IsStatModeEnabled())
+				{
+					throw OptionsParserException("--" + ProgramOptions::MinCoverageOption +
+						" requires --" + ProgramOptions::StatOption + ".");
+				}
+				if (*minCoverage < 0 || *minCoverage > 100)
+				{
+					throw OptionsParserException("--" + ProgramOptions::MinCoverageOption +
+						" must be between 0 and 100.");
+				}
+				options.SetMinCoverage(*minCoverage);
+			}
+		}
 	}
 		
 	//-------------------------------------------------------------------------
@@ -259,6 +339,10 @@ namespace CppCoverage
 		exportTypes_.emplace(ProgramOptions::ExportTypeHtmlValue, OptionsExportType::Html);
 		exportTypes_.emplace(ProgramOptions::ExportTypeCoberturaValue, OptionsExportType::Cobertura);
 		exportTypes_.emplace(ProgramOptions::ExportTypeBinaryValue, OptionsExportType::Binary);
+		exportTypes_.emplace(ProgramOptions::ExportTypeBinaryV2Value, OptionsExportType::BinaryV2);
+		exportTypes_.emplace(ProgramOptions::ExportTypeBinaryV2CompressedValue, OptionsExportType::BinaryV2Compressed);
+		exportTypes_.emplace(ProgramOptions::ExportTypeCompactHtmlValue, OptionsExportType::CompactHtml);
+		exportTypes_.emplace(ProgramOptions::ExportTypeLcovValue, OptionsExportType::Lcov);
 
 		std::vector<std::string> optionsExportTypes;
 
@@ -358,6 +442,9 @@ namespace CppCoverage
 		AddInputCoverages(variables, options);
 		AddUnifiedDiff(variables, options);
 		AddExcludedLineRegexes(variables, options);
+		SetCoverageDataOperation(variables, options);
+		SetJournal(variables, options);
+		SetStat(variables, options);
 
 		if (!options.GetStartInfo() && options.GetInputCoveragePaths().empty())
 			throw OptionsParserException("You must specify a program to execute or use --" + ProgramOptions::InputCoverageValue);
@@ -66,6 +66,14 @@ namespace CppCoverage
 			exportTypeText += GetExportTypesAsString(exportTypes) + "\n";
 			exportTypeText += "<outputPath> (optional) output file or directory for the export.\n";
 			exportTypeText += "Example: html:MyFolder\\MySubFolder\n";
+			exportTypeText += ProgramOptions::ExportTypeHtmlValue + " only regenerates the changed source pages " +
+				"when <outputPath> is the folder of a previous report. The default folder is new on each run.\n";
+			exportTypeText += ProgramOptions::ExportTypeBinaryValue + " writes the format read by all versions. " +
+				ProgramOptions::ExportTypeBinaryV2Value + " and " + ProgramOptions::ExportTypeBinaryV2CompressedValue +
+				" (compressed) write smaller files that older versions cannot read.\n";
+			exportTypeText += "When only binary coverage files are merged to " + ProgramOptions::ExportTypeBinaryV2Value + 
+				" or " + ProgramOptions::ExportTypeBinaryV2CompressedValue + ", one module is loaded at a time. " +
+				"Aggregating by file still keeps all the files in memory, see --" + ProgramOptions::NoAggregateByFileOption + ".\n";
 			exportTypeText += "This flag can have multiple occurrences.";
 
 			return exportTypeText;
@@ -83,6 +91,21 @@ namespace CppCoverage
 				"See documentation for limitations.";
 		}
 
+		//---------------------------------------------------------------------
+		std::string GetCoverageOperationHelp()
+		{
+			return "Compute an operation between the two occurrences of --" + ProgramOptions::InputCoverageValue + 
+				" instead of merging them.\n" +
+				"Operation can be: " +
+				ProgramOptions::CoverageOperationDifferenceValue + ", " +
+				ProgramOptions::CoverageOperationIntersectionValue + ", " +
+				ProgramOptions::CoverageOperationSymmetricDifferenceValue + ", " +
+				ProgramOptions::CoverageOperationNewlyUncoveredValue + "\n" +
+				"Executed lines of the result are the lines selected by the operation. " +
+				ProgramOptions::CoverageOperationNewlyUncoveredValue + 
+				" selects lines executed in the first input but not in the second one.";
+		}
+
 		//---------------------------------------------------------------------
 		void FillConfigurationOptions(
 			po::options_description& options, 
@@ -105,6 +128,10 @@ namespace CppCoverage
 				"The pattern that source's paths should NOT match. Can have multiple occurrences.")
 				(ProgramOptions::InputCoverageValue.c_str(), po::value<T_Strings>()->composing(),
 				("A output path of " + ProgramOptions::ExportTypeOption + "=" + ProgramOptions::ExportTypeBinaryValue +
+				" or of --" + ProgramOptions::JournalOption +
+				", a Cobertura or LCOV report of another tool"
+				", a folder with the .gcno and .gcda files of gcc --coverage"
+				", or a .pcguard file written by SanitizerCoverageRuntime"
 				". This coverage data will be merged with the current one. Can have multiple occurrences.").c_str())
 				(ProgramOptions::ExportTypeOption.c_str(),
 				po::value<T_Strings>()->default_value({ ProgramOptions::ExportTypeHtmlValue }, ProgramOptions::ExportTypeHtmlValue),
@@ -118,7 +145,21 @@ namespace CppCoverage
 				(ProgramOptions::OptimizedBuildOption.c_str(), 
 					"Enable heuristics to support optimized build. See documentation for restrictions.")
 				(ProgramOptions::ExcludedLineRegexOption.c_str(), po::value<T_Strings>()->composing(),
-					"Exclude all lines match the regular expression. Regular expression must match the whole line.");
+					"Exclude all lines match the regular expression. Regular expression must match the whole line.")
+				(ProgramOptions::CoverageOperationOption.c_str(), po::value<std::string>(),
+					GetCoverageOperationHelp().c_str())
+				(ProgramOptions::JournalOption.c_str(), po::value<std::string>(),
+					("Write the coverage to this journal while the program runs. If OpenCppCoverage stops unexpectedly, "
+					"the coverage can be recovered with --" + ProgramOptions::InputCoverageValue + ".").c_str())
+				(ProgramOptions::JournalSyncOption.c_str(),
+					("Flush the journal to the disk at each write. Slower, but the journal survives a system crash. "
+					"Requires --" + ProgramOptions::JournalOption + ".").c_str())
+				(ProgramOptions::StatOption.c_str(),
+					("Print the coverage rate of each --" + ProgramOptions::InputCoverageValue +
+					" without exporting it. Only the summary written in binary coverage files is read.").c_str())
+				(ProgramOptions::MinCoverageOption.c_str(), po::value<double>(),
+					("Minimum coverage rate in percent. OpenCppCoverage fails if the total coverage rate is lower. "
+					"Requires --" + ProgramOptions::StatOption + ".").c_str());
 		}
 
 		//-------------------------------------------------------------------------
@@ -153,11 +194,24 @@ namespace CppCoverage
 	const std::string ProgramOptions::ExportTypeHtmlValue = "html";
 	const std::string ProgramOptions::ExportTypeCoberturaValue = "cobertura";
 	const std::string ProgramOptions::ExportTypeBinaryValue = "binary";
+	const std::string ProgramOptions::ExportTypeBinaryV2Value = "binary_v2";
+	const std::string ProgramOptions::ExportTypeBinaryV2CompressedValue = "binary_v2z";
+	const std::string ProgramOptions::ExportTypeCompactHtmlValue = "compact_html";
+	const std::string ProgramOptions::ExportTypeLcovValue = "lcov";
 	const std::string ProgramOptions::InputCoverageValue = "input_coverage";
 	const std::string ProgramOptions::UnifiedDiffOption = "unified_diff";
 	const std::string ProgramOptions::ContinueAfterCppExceptionOption = "continue_after_cpp_exception";
 	const std::string ProgramOptions::OptimizedBuildOption = "optimized_build";
 	const std::string ProgramOptions::ExcludedLineRegexOption = "excluded_line_regex";
+	const std::string ProgramOptions::CoverageOperationOption = "coverage_operation";
+	const std::string ProgramOptions::CoverageOperationDifferenceValue = "difference";
+	const std::string ProgramOptions::CoverageOperationIntersectionValue = "intersection";
+	const std::string ProgramOptions::CoverageOperationSymmetricDifferenceValue = "symmetric_difference";
+	const std::string ProgramOptions::CoverageOperationNewlyUncoveredValue = "newly_uncovered";
+	const std::string ProgramOptions::JournalOption = "journal";
+	const std::string ProgramOptions::JournalSyncOption = "journal_sync";
+	const std::string ProgramOptions::StatOption = "stat";
+	const std::string ProgramOptions::MinCoverageOption = "min_coverage";
 
 	//-------------------------------------------------------------------------
 	ProgramOptions::ProgramOptions(const std::vector<std::string>& exportTypes)
@@ -46,11 +46,24 @@ namespace CppCoverage
 		static const std::string ExportTypeHtmlValue;
 		static const std::string ExportTypeCoberturaValue;	
 		static const std::string ExportTypeBinaryValue;
+		static const std::string ExportTypeBinaryV2Value;
+		static const std::string ExportTypeBinaryV2CompressedValue;
+		static const std::string ExportTypeCompactHtmlValue;
+		static const std::string ExportTypeLcovValue;
 		static const std::string InputCoverageValue;
 		static const std::string UnifiedDiffOption;
 		static const std::string ContinueAfterCppExceptionOption;
 		static const std::string OptimizedBuildOption;
 		static const std::string ExcludedLineRegexOption;
+		static const std::string CoverageOperationOption;
+		static const std::string CoverageOperationDifferenceValue;
+		static const std::string CoverageOperationIntersectionValue;
+		static const std::string CoverageOperationSymmetricDifferenceValue;
+		static const std::string CoverageOperationNewlyUncoveredValue;
+		static const std::string JournalOption;
+		static const std::string JournalSyncOption;
+		static const std::string StatOption;
+		static const std::string MinCoverageOption;
 
 		ProgramOptions(const std::vector<std::string>& optionsExportTypes);
 
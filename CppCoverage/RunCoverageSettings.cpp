@@ -33,6 +33,7 @@ namespace CppCoverage
 		, maxUnmatchPathsForWarning_{ 0 }
 		, optimizedBuildSupport_{ false }
 		, excludedLineRegexes_{ excludedLineRegexes }
+		, journalSyncOnFlush_{ false }
 	{
 	}
 
@@ -60,6 +61,13 @@ namespace CppCoverage
 		optimizedBuildSupport_ = optimizedBuildSupport;
 	}
 
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetJournal(const boost::filesystem::path& journalPath, bool syncOnFlush)
+	{
+		journalPath_ = journalPath;
+		journalSyncOnFlush_ = syncOnFlush;
+	}
+
 	//-------------------------------------------------------------------------
 	const StartInfo& RunCoverageSettings::GetStartInfo() const
 	{
@@ -107,4 +115,16 @@ namespace CppCoverage
 	{
 		return excludedLineRegexes_;
 	}
+
+	//-------------------------------------------------------------------------
+	const boost::optional<boost::filesystem::path>& RunCoverageSettings::GetJournalPath() const
+	{
+		return journalPath_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetJournalSyncOnFlush() const
+	{
+		return journalSyncOnFlush_;
+	}
 }
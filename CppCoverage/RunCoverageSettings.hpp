@@ -17,6 +17,9 @@
 #pragma once
 
 #include <vector>
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
 #include "StartInfo.hpp"
 #include "UnifiedDiffSettings.hpp"
 #include "CoverageFilterSettings.hpp"
@@ -40,6 +43,7 @@ namespace CppCoverage
 		void SetContinueAfterCppException(bool);
 		void SetMaxUnmatchPathsForWarning(size_t);
 		void SetOptimizedBuildSupport(bool);
+		void SetJournal(const boost::filesystem::path&, bool syncOnFlush);
 
 		const StartInfo& GetStartInfo() const;
 		const CoverageFilterSettings& GetCoverageFilterSettings() const;
@@ -49,6 +53,8 @@ namespace CppCoverage
 		size_t GetMaxUnmatchPathsForWarning() const;
 		bool GetOptimizedBuildSupport() const;
 		const std::vector<std::wstring>& GetExcludedLineRegexes() const;
+		const boost::optional<boost::filesystem::path>& GetJournalPath() const;
+		bool GetJournalSyncOnFlush() const;
 
 	private:
 		StartInfo startInfo_;
@@ -59,5 +65,7 @@ namespace CppCoverage
 		size_t maxUnmatchPathsForWarning_;
 		bool optimizedBuildSupport_;
 		std::vector<std::wstring> excludedLineRegexes_;
+		boost::optional<boost::filesystem::path> journalPath_;
+		bool journalSyncOnFlush_;
 	};
 }
@@ -0,0 +1,235 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SanitizerCoverageReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <boost/uuid/uuid_generators.hpp>
+
+#include "FileFilter/ModuleInfo.hpp"
+#include "FileFilter/FileInfo.hpp"
+#include "FileFilter/LineInfo.hpp"
+
+#include "SanitizerCoverageRuntime/SanitizerCoverageFile.hpp"
+
+#include "CppCoverageException.hpp"
+#include "CoverageData.hpp"
+#include "ModuleCoverage.hpp"
+#include "FileCoverage.hpp"
+#include "DebugInformationEnumerator.hpp"
+#include "ICoverageFilterManager.hpp"
+
+namespace fs = boost::filesystem;
+namespace sancov = SanitizerCoverageRuntime;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		using Blocks = std::vector<sancov::Block>;
+
+		//---------------------------------------------------------------------
+		bool ReadHeader(std::istream& istr, sancov::FileHeader& header)
+		{
+			return istr.read(reinterpret_cast<char*>(&header), sizeof(header))
+				&& std::memcmp(header.magic, sancov::FileMagic, sizeof(header.magic)) == 0
+				&& header.version == sancov::FileVersion;
+		}
+
+		//---------------------------------------------------------------------
+		// Blocks are sorted by address.
+		Blocks ReadBlocks(const fs::path& path, fs::path& modulePath)
+		{
+			std::ifstream ifs{ path.string(), std::ios::binary };
+			sancov::FileHeader header;
+
+			if (!ReadHeader(ifs, header))
+				THROW(path.wstring() << L" is not a SanitizerCoverage file.");
+
+			std::wstring modulePathValue(header.modulePathSize, L'\0');
+			Blocks blocks(header.blockCount);
+
+			ifs.read(reinterpret_cast<char*>(&modulePathValue[0]), modulePathValue.size() * sizeof(wchar_t));
+			ifs.read(reinterpret_cast<char*>(blocks.data()), blocks.size() * sizeof(sancov::Block));
+			if (!ifs || modulePathValue.empty())
+				THROW(L"The SanitizerCoverage file " << path.wstring() << L" is truncated.");
+
+			std::sort(blocks.begin(), blocks.end(), [](const sancov::Block& block1, const sancov::Block& block2)
+			{
+				return block1.rva < block2.rva;
+			});
+			modulePath = modulePathValue;
+			return blocks;
+		}
+
+		//---------------------------------------------------------------------
+		// Image loaded without running its code for the filters reading its memory.
+		class LoadedImage
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit LoadedImage(const fs::path& path)
+				: module_{ LoadLibraryExW(path.c_str(), nullptr, DONT_RESOLVE_DLL_REFERENCES) }
+			{
+				if (!module_)
+					THROW_LAST_ERROR(L"Cannot load " << path.wstring() << L": ", GetLastError());
+			}
+
+			//-----------------------------------------------------------------
+			~LoadedImage()
+			{
+				FreeLibrary(module_);
+			}
+
+			//-----------------------------------------------------------------
+			void* GetBaseOfImage() const
+			{
+				return module_;
+			}
+
+		private:
+			LoadedImage(const LoadedImage&) = delete;
+			LoadedImage& operator=(const LoadedImage&) = delete;
+
+			HMODULE module_;
+		};
+
+		//---------------------------------------------------------------------
+		class BlockLineMapper : public IDebugInformationHandler
+		{
+		public:
+			//-----------------------------------------------------------------
+			BlockLineMapper(
+				const Blocks& blocks,
+				ICoverageFilterManager& coverageFilterManager,
+				const FileFilter::ModuleInfo& moduleInfo,
+				ModuleCoverage& moduleCoverage)
+				: blocks_{ blocks }
+				, coverageFilterManager_{ coverageFilterManager }
+				, moduleInfo_{ moduleInfo }
+				, moduleCoverage_{ moduleCoverage }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool IsSourceFileSelected(const fs::path& path) override
+			{
+				return coverageFilterManager_.IsSourceFileSelected(path.wstring());
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFile(const fs::path& path, const std::vector<Line>& lines) override
+			{
+				if (!IsInstrumented(lines))
+					return;
+
+				std::vector<FileFilter::LineInfo> lineInfos;
+				for (const auto& line : lines)
+					lineInfos.emplace_back(line.lineNumber_, line.virtualAddress_, 0);
+				FileFilter::FileInfo fileInfo{ path, std::move(lineInfos) };
+
+				// A line is executed if one of its blocks is executed.
+				std::map<unsigned int, bool> executedLines;
+				for (const auto& lineInfo : fileInfo.lineInfoColllection_)
+				{
+					const auto* block = FindBlock(static_cast<int64_t>(lineInfo.virtualAddress_));
+
+					if (block && coverageFilterManager_.IsLineSelected(moduleInfo_, fileInfo, lineInfo))
+					{
+						auto& isExecuted = executedLines[static_cast<unsigned int>(lineInfo.lineNumber_)];
+						isExecuted = isExecuted || (block->flags & sancov::Executed) != 0;
+					}
+				}
+
+				if (!executedLines.empty())
+				{
+					auto& fileCoverage = moduleCoverage_.AddFile(path);
+
+					for (const auto& executedLine : executedLines)
+						fileCoverage.AddLine(executedLine.first, executedLine.second);
+				}
+			}
+
+		private:
+			BlockLineMapper(const BlockLineMapper&) = delete;
+			BlockLineMapper& operator=(const BlockLineMapper&) = delete;
+
+			//-----------------------------------------------------------------
+			// The block of a function entry starts at the address of the function
+			// which is also the address of its first line.
+			bool IsInstrumented(const std::vector<Line>& lines) const
+			{
+				return std::any_of(lines.begin(), lines.end(), [&](const Line& line)
+				{
+					const auto* block = FindBlock(line.virtualAddress_);
+
+					return block && block->rva == line.virtualAddress_
+						&& (block->flags & sancov::FunctionEntry) != 0;
+				});
+			}
+
+			//-----------------------------------------------------------------
+			const sancov::Block* FindBlock(int64_t rva) const
+			{
+				auto it = std::upper_bound(blocks_.begin(), blocks_.end(), rva,
+					[](int64_t value, const sancov::Block& block) { return value < block.rva; });
+
+				return (it == blocks_.begin()) ? nullptr : &*(it - 1);
+			}
+
+			const Blocks& blocks_;
+			ICoverageFilterManager& coverageFilterManager_;
+			const FileFilter::ModuleInfo& moduleInfo_;
+			ModuleCoverage& moduleCoverage_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	bool SanitizerCoverageReader::IsSanitizerCoverageFile(const fs::path& path)
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+		sancov::FileHeader header;
+
+		return ReadHeader(ifs, header);
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageData SanitizerCoverageReader::Read(
+		const fs::path& path,
+		ICoverageFilterManager& coverageFilterManager) const
+	{
+		fs::path modulePath;
+		auto blocks = ReadBlocks(path, modulePath);
+		CoverageData coverageData{ modulePath.filename().wstring(), 0 };
+
+		if (coverageFilterManager.IsModuleSelected(modulePath.wstring()))
+		{
+			LoadedImage loadedImage{ modulePath };
+			FileFilter::ModuleInfo moduleInfo{
+				GetCurrentProcess(), boost::uuids::random_generator()(), loadedImage.GetBaseOfImage() };
+			BlockLineMapper blockLineMapper{
+				blocks, coverageFilterManager, moduleInfo, coverageData.AddModule(modulePath) };
+
+			if (!DebugInformationEnumerator{}.Enumerate(modulePath, blockLineMapper))
+				THROW(L"Cannot read the debug information of " << modulePath.wstring());
+		}
+		return coverageData;
+	}
+}
@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+	class ICoverageFilterManager;
+
+	// Rebuild the coverage of a module from the file written by SanitizerCoverageRuntime
+	// for a module built with clang-cl -fsanitize-coverage=trace-pc-guard,pc-table.
+	// Blocks are mapped to lines with the debug information of the module, as
+	// MonitoredLineRegister does, and the same filters are applied.
+	// A block extends to the next instrumented block. Only the source files with
+	// an instrumented function are kept.
+	class CPPCOVERAGE_DLL SanitizerCoverageReader
+	{
+	public:
+		SanitizerCoverageReader() = default;
+
+		static bool IsSanitizerCoverageFile(const boost::filesystem::path&);
+
+		// The module must be on the disk with its pdb file.
+		CoverageData Read(const boost::filesystem::path&, ICoverageFilterManager&) const;
+
+	private:
+		SanitizerCoverageReader(const SanitizerCoverageReader&) = delete;
+		SanitizerCoverageReader& operator=(const SanitizerCoverageReader&) = delete;
+	};
+}
@@ -24,47 +24,23 @@
 
 #include "CoverageFilterSettings.hpp"
 #include "Patterns.hpp"
-#include "Wildcards.hpp"
+#include "WildcardsMatcher.hpp"
 
 namespace CppCoverage
 {	
 	//-------------------------------------------------------------------------
 	struct WildcardCoverageFilter::Filter
-	{		
-		std::vector<Wildcards> selectedWildcards;
-		std::vector<Wildcards> excludedWildcards;
-	};
-
-	namespace
 	{
 		//---------------------------------------------------------------------
-		const Wildcards* MatchAny(
-			const std::wstring& str, 
-			const std::vector<Wildcards>& wildcardsCollection)
+		explicit Filter(const Patterns& patterns)
+			: selectedWildcards{ patterns.GetSelectedPatterns(), patterns.IsRegexCaseSensitiv() }
+			, excludedWildcards{ patterns.GetExcludedPatterns(), patterns.IsRegexCaseSensitiv() }
 		{
-			
-			for (const auto& wildcards : wildcardsCollection)
-			{				
-				if (wildcards.Match(str))
-					return &wildcards;
-			}
-
-			return nullptr;
-		}		
-				
-		//---------------------------------------------------------------------
-		std::vector<Wildcards> BuildWildcards(
-			const std::vector<std::wstring>& regexesStr,
-			bool isRegexCaseSensitiv)
-		{			
-			std::vector<Wildcards> wildcardsCollection;
-
-			for (const auto& regexStr : regexesStr)
-				wildcardsCollection.emplace_back(regexStr, isRegexCaseSensitiv);
-						
-			return wildcardsCollection;
-		}	
-	}
+		}
+
+		const WildcardsMatcher selectedWildcards;
+		const WildcardsMatcher excludedWildcards;
+	};
 
 	//-------------------------------------------------------------------------
 	WildcardCoverageFilter::WildcardCoverageFilter(const CoverageFilterSettings& settings)		
@@ -102,16 +78,7 @@ namespace CppCoverage
 	std::unique_ptr<WildcardCoverageFilter::Filter> 
 		WildcardCoverageFilter::BuildFilter(const Patterns& patterns) const
 	{
-		std::unique_ptr<Filter> filter{ new Filter()};
-
-		filter->selectedWildcards = BuildWildcards(
-			patterns.GetSelectedPatterns(), 
-			patterns.IsRegexCaseSensitiv());
-		filter->excludedWildcards = BuildWildcards(
-			patterns.GetExcludedPatterns(), 
-			patterns.IsRegexCaseSensitiv());
-
-		return filter;
+		return std::unique_ptr<Filter>{ new Filter{ patterns } };
 	}
 
 	//---------------------------------------------------------------------
@@ -120,23 +87,25 @@ namespace CppCoverage
 		const Filter& filter,
 		std::wostream& ostr) const
 	{
-		const auto* selectedRegEx = MatchAny(str, filter.selectedWildcards);
+		auto selectedIndex = filter.selectedWildcards.Match(str);
 
-		if (!selectedRegEx)
+		if (!selectedIndex)
 		{
 			ostr << L": " << str << L" is skipped because it matches no selected patterns";
 			return false;
 		}
 		
-		const auto* excludedRegEx = MatchAny(str, filter.excludedWildcards);
+		auto excludedIndex = filter.excludedWildcards.Match(str);
 
-		if (excludedRegEx)
+		if (excludedIndex)
 		{
-			ostr << L": " << str << L" is not selected because it matches excluded pattern: " << *excludedRegEx;
+			const auto& excludedPattern = filter.excludedWildcards.GetPatterns()[*excludedIndex];
+			ostr << L": " << str << L" is not selected because it matches excluded pattern: " << excludedPattern;
 			return false;
 		}
 
-		ostr << L": " << str << L" is selected because it matches selected pattern: " << *selectedRegEx;;
+		const auto& selectedPattern = filter.selectedWildcards.GetPatterns()[*selectedIndex];
+		ostr << L": " << str << L" is selected because it matches selected pattern: " << selectedPattern;
 		return true;			
 	}
 }
@@ -0,0 +1,234 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "WildcardsMatcher.hpp"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const size_t RootState = 0;
+		const size_t OtherCharClass = 0;
+
+		//---------------------------------------------------------------------
+		// '*' is translated to ".*" by Wildcards and '.' does not match a line break.
+		bool IsLineBreak(wchar_t c)
+		{
+			return c == L'\n' || c == L'\r';
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	WildcardsMatcher::WildcardsMatcher(
+		const std::vector<std::wstring>& patterns, 
+		bool isRegexCaseSensitiv)
+		: patterns_( patterns )
+		, isRegexCaseSensitiv_{ isRegexCaseSensitiv }
+		, locale_{}
+		, ctype_( std::use_facet<std::ctype<wchar_t>>(locale_) )
+		, firstPatternWithoutLiteral_{ patterns.size() }
+		, charClassCount_{ 1 }
+	{
+		std::vector<std::vector<std::wstring>> patternLiterals;
+
+		for (const auto& pattern : patterns_)
+		{
+			std::vector<std::wstring> literals{ std::wstring{} };
+
+			for (auto c : pattern)
+			{
+				if (c != L'*')
+					literals.back() += Translate(c);
+				else if (!literals.back().empty())
+					literals.emplace_back();
+			}
+			if (literals.back().empty())
+				literals.pop_back();
+
+			// A pattern with only '*' matches any string.
+			if (literals.empty())
+				firstPatternWithoutLiteral_ = std::min(firstPatternWithoutLiteral_, patternLiterals.size());
+			literalCounts_.push_back(literals.size());
+			patternLiterals.push_back(std::move(literals));
+		}
+		Build(patternLiterals);
+	}
+
+	//-------------------------------------------------------------------------
+	void WildcardsMatcher::Build(const std::vector<std::vector<std::wstring>>& patternLiterals)
+	{
+		std::vector<std::map<wchar_t, size_t>> children(1);
+		std::vector<std::vector<Literal>> stateLiterals(1);
+		std::set<wchar_t> chars;
+
+		for (size_t patternIndex = 0; patternIndex < patternLiterals.size(); ++patternIndex)
+		{
+			const auto& literals = patternLiterals[patternIndex];
+
+			for (size_t position = 0; position < literals.size(); ++position)
+			{
+				auto state = RootState;
+
+				for (auto c : literals[position])
+				{
+					auto it = children[state].find(c);
+
+					if (it == children[state].end())
+					{
+						it = children[state].emplace(c, children.size()).first;
+						children.emplace_back();
+						stateLiterals.emplace_back();
+					}
+					chars.insert(c);
+					state = it->second;
+				}
+				stateLiterals[state].push_back(Literal{ patternIndex, position, literals[position].size() });
+			}
+		}
+
+		for (auto c : chars)
+			charClasses_.emplace_back(c, charClassCount_++);
+		for (size_t c = 0; c < asciiCharClasses_.size(); ++c)
+			asciiCharClasses_[c] = GetTranslatedCharClass(Translate(static_cast<wchar_t>(c)));
+
+		// Breadth first traversal so the failure state of a state is complete
+		// before the state: its transitions and its literals are inherited.
+		std::vector<size_t> failures(children.size(), RootState);
+		std::queue<size_t> states;
+
+		transitions_.assign(children.size() * charClassCount_, RootState);
+		for (const auto& child : children[RootState])
+		{
+			transitions_[GetTranslatedCharClass(child.first)] = child.second;
+			states.push(child.second);
+		}
+
+		while (!states.empty())
+		{
+			auto state = states.front();
+			auto failure = failures[state];
+			auto* transitions = &transitions_[state * charClassCount_];
+			const auto* failureTransitions = &transitions_[failure * charClassCount_];
+
+			states.pop();
+			std::copy(failureTransitions, failureTransitions + charClassCount_, transitions);
+			for (const auto& child : children[state])
+			{
+				auto charClass = GetTranslatedCharClass(child.first);
+
+				failures[child.second] = failureTransitions[charClass];
+				transitions[charClass] = child.second;
+				states.push(child.second);
+			}
+
+			const auto& failureLiterals = stateLiterals[failure];
+			stateLiterals[state].insert(stateLiterals[state].end(), failureLiterals.begin(), failureLiterals.end());
+		}
+
+		for (const auto& literals : stateLiterals)
+		{
+			literalsBegin_.push_back(literals_.size());
+			literals_.insert(literals_.end(), literals.begin(), literals.end());
+		}
+		literalsBegin_.push_back(literals_.size());
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> WildcardsMatcher::Match(const std::wstring& str) const
+	{
+		auto matchedPattern = firstPatternWithoutLiteral_;
+
+		if (patterns_.empty())
+			return boost::none;
+		if (matchedPattern == 0)
+			return matchedPattern;
+
+		// For each pattern before the matched one: the position of the next
+		// literal to find and the end of the previous literal in str.
+		std::vector<std::pair<size_t, size_t>> progress(matchedPattern);
+		auto state = RootState;
+
+		for (size_t i = 0; i < str.size(); ++i)
+		{
+			auto c = str[i];
+
+			if (IsLineBreak(c))
+				std::fill(progress.begin(), progress.end(), std::make_pair(size_t{ 0 }, size_t{ 0 }));
+
+			state = transitions_[state * charClassCount_ + GetCharClass(c)];
+			for (auto index = literalsBegin_[state]; index < literalsBegin_[state + 1]; ++index)
+			{
+				const auto& literal = literals_[index];
+
+				if (literal.patternIndex >= matchedPattern)
+					continue;
+
+				auto& patternProgress = progress[literal.patternIndex];
+				if (patternProgress.first == literal.position && i + 1 >= patternProgress.second + literal.size)
+				{
+					patternProgress = { literal.position + 1, i + 1 };
+					if (patternProgress.first == literalCounts_[literal.patternIndex])
+					{
+						matchedPattern = literal.patternIndex;
+						if (matchedPattern == 0)
+							return matchedPattern;
+					}
+				}
+			}
+		}
+
+		if (matchedPattern == patterns_.size())
+			return boost::none;
+		return matchedPattern;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::wstring>& WildcardsMatcher::GetPatterns() const
+	{
+		return patterns_;
+	}
+
+	//-------------------------------------------------------------------------
+	// Same translation as std::regex_traits::translate_nocase.
+	wchar_t WildcardsMatcher::Translate(wchar_t c) const
+	{
+		return (isRegexCaseSensitiv_) ? c : ctype_.tolower(c);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t WildcardsMatcher::GetCharClass(wchar_t c) const
+	{
+		if (static_cast<size_t>(c) < asciiCharClasses_.size())
+			return asciiCharClasses_[static_cast<size_t>(c)];
+		return GetTranslatedCharClass(Translate(c));
+	}
+
+	//-------------------------------------------------------------------------
+	size_t WildcardsMatcher::GetTranslatedCharClass(wchar_t c) const
+	{
+		auto it = std::lower_bound(charClasses_.begin(), charClasses_.end(), c,
+			[](const std::pair<wchar_t, size_t>& charClass, wchar_t value) { return charClass.first < value; });
+
+		return (it != charClasses_.end() && it->first == c) ? it->second : OtherCharClass;
+	}
+}
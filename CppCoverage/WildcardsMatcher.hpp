@@ -0,0 +1,78 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <array>
+#include <locale>
+#include <string>
+#include <vector>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Match a string against a set of patterns with the same semantic as Wildcards
+	// but with a single pass on the string whatever the number of patterns.
+	// The literals between the '*' of all patterns are compiled into one
+	// Aho-Corasick automaton. A pattern matches when its literals are found in
+	// order, without overlap and without a line break between them.
+	class CPPCOVERAGE_DLL WildcardsMatcher
+	{
+	public:
+		WildcardsMatcher(const std::vector<std::wstring>& patterns, bool isRegexCaseSensitiv = false);
+
+		// Return the index of the first pattern matching str.
+		boost::optional<size_t> Match(const std::wstring& str) const;
+
+		const std::vector<std::wstring>& GetPatterns() const;
+
+	private:
+		WildcardsMatcher(const WildcardsMatcher&) = delete;
+		WildcardsMatcher& operator=(const WildcardsMatcher&) = delete;
+
+		struct Literal
+		{
+			size_t patternIndex;
+			size_t position;
+			size_t size;
+		};
+
+		wchar_t Translate(wchar_t) const;
+		size_t GetCharClass(wchar_t) const;
+		size_t GetTranslatedCharClass(wchar_t) const;
+		void Build(const std::vector<std::vector<std::wstring>>& patternLiterals);
+
+	private:
+		std::vector<std::wstring> patterns_;
+		const bool isRegexCaseSensitiv_;
+		const std::locale locale_;
+		const std::ctype<wchar_t>& ctype_;
+
+		std::vector<size_t> literalCounts_;
+		size_t firstPatternWithoutLiteral_;
+
+		std::array<size_t, 128> asciiCharClasses_;
+		std::vector<std::pair<wchar_t, size_t>> charClasses_;
+		size_t charClassCount_;
+
+		std::vector<size_t> transitions_;
+		std::vector<size_t> literalsBegin_;
+		std::vector<Literal> literals_;
+	};
+}
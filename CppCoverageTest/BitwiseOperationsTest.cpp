@@ -0,0 +1,111 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <random>
+
+#include "CppCoverage/BitwiseOperations.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::vector<uint64_t> CreateRandomWords(size_t wordCount, std::default_random_engine& generator)
+		{
+			std::uniform_int_distribution<uint64_t> distribution;
+			std::vector<uint64_t> words;
+
+			for (size_t i = 0; i < wordCount; ++i)
+				words.push_back(distribution(generator));
+			return words;
+		}
+
+		//---------------------------------------------------------------------
+		uint64_t Apply(cov::BitwiseOperation operation, uint64_t x, uint64_t y)
+		{
+			switch (operation)
+			{
+				case cov::BitwiseOperation::Or: return x | y;
+				case cov::BitwiseOperation::And: return x & y;
+				case cov::BitwiseOperation::AndNot: return x & ~y;
+				case cov::BitwiseOperation::Xor: return x ^ y;
+			}
+			throw std::runtime_error("Invalid operation");
+		}
+
+		//---------------------------------------------------------------------
+		void CheckBitwiseOperation(
+			cov::BitwiseOperation operation, 
+			cov::InstructionSet instructionSet)
+		{
+			std::default_random_engine generator;
+
+			// Sizes not multiple of the vector width use the scalar loop for the tail.
+			for (size_t wordCount = 0; wordCount < 20; ++wordCount)
+			{
+				auto source = CreateRandomWords(wordCount, generator);
+				auto destination = CreateRandomWords(wordCount, generator);
+				auto expectedDestination = destination;
+
+				for (size_t i = 0; i < wordCount; ++i)
+					expectedDestination[i] = Apply(operation, expectedDestination[i], source[i]);
+
+				cov::ApplyBitwiseOperation(operation, destination.data(), source.data(), wordCount, instructionSet);
+				ASSERT_EQ(expectedDestination, destination);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void CheckBitwiseOperation(cov::BitwiseOperation operation)
+		{
+			auto supportedInstructionSet = cov::GetSupportedInstructionSet();
+
+			CheckBitwiseOperation(operation, cov::InstructionSet::Scalar);
+			if (supportedInstructionSet != cov::InstructionSet::Scalar)
+				CheckBitwiseOperation(operation, cov::InstructionSet::Sse2);
+			if (supportedInstructionSet == cov::InstructionSet::Avx2)
+				CheckBitwiseOperation(operation, cov::InstructionSet::Avx2);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BitwiseOperationsTest, Or)
+	{
+		CheckBitwiseOperation(cov::BitwiseOperation::Or);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BitwiseOperationsTest, And)
+	{
+		CheckBitwiseOperation(cov::BitwiseOperation::And);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BitwiseOperationsTest, AndNot)
+	{
+		CheckBitwiseOperation(cov::BitwiseOperation::AndNot);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BitwiseOperationsTest, Xor)
+	{
+		CheckBitwiseOperation(cov::BitwiseOperation::Xor);
+	}
+}
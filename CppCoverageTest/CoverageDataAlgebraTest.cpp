@@ -0,0 +1,174 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/CoverageDataAlgebra.hpp"
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		const fs::path modulePath = L"modulePath";
+		const fs::path filePath = L"filePath";
+
+		//---------------------------------------------------------------------
+		void AddLines(
+			cov::ModuleCoverage& module,
+			const fs::path& path,
+			const std::vector<std::pair<unsigned int, bool>>& lines)
+		{
+			auto& file = module.AddFile(path);
+
+			for (const auto& line : lines)
+				file.AddLine(line.first, line.second);
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateCoverageData1()
+		{
+			cov::CoverageData coverageData{ L"1", 1 };
+			auto& module = coverageData.AddModule(modulePath);
+
+			AddLines(module, filePath, { { 1, true }, { 2, true }, { 3, false }, { 4, true } });
+			AddLines(module, L"onlyIn1", { { 1, true } });
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateCoverageData2()
+		{
+			cov::CoverageData coverageData{ L"2", 2 };
+			auto& module = coverageData.AddModule(modulePath);
+
+			AddLines(module, filePath, { { 2, true }, { 3, true }, { 4, false }, { 5, true } });
+			AddLines(coverageData.AddModule(L"onlyIn2"), filePath, { { 1, true } });
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<unsigned int> GetExecutedLines(const cov::FileCoverage& file)
+		{
+			std::vector<unsigned int> executedLines;
+
+			for (const auto& line : file.GetLines())
+			{
+				if (line.HasBeenExecuted())
+					executedLines.push_back(line.GetLineNumber());
+			}
+
+			return executedLines;
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData Compute(cov::CoverageDataOperation operation)
+		{
+			return cov::CoverageDataAlgebra{}.Compute(operation, CreateCoverageData1(), CreateCoverageData2());
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<unsigned int> ComputeSparseExecutedLines(cov::CoverageDataOperation operation)
+		{
+			const unsigned int lastLine = 4000000000;
+			cov::CoverageData coverageData1{ L"1", 0 };
+			cov::CoverageData coverageData2{ L"2", 0 };
+
+			AddLines(coverageData1.AddModule(modulePath), filePath, { { 1, true }, { lastLine - 10, true } });
+			AddLines(coverageData2.AddModule(modulePath), filePath, { { lastLine - 10, true }, { lastLine, true } });
+
+			auto coverageData = cov::CoverageDataAlgebra{}.Compute(operation, coverageData1, coverageData2);
+			return GetExecutedLines(*coverageData.GetModules().at(0)->GetFiles().at(0));
+		}
+
+		//---------------------------------------------------------------------
+		void CheckExecutedLines(
+			cov::CoverageDataOperation operation,
+			const std::vector<unsigned int>& expectedExecutedLines)
+		{
+			auto coverageData = Compute(operation);
+			const auto& modules = coverageData.GetModules();
+
+			ASSERT_EQ(2, modules.size());
+			ASSERT_EQ(L"1", coverageData.GetName());
+			ASSERT_EQ(1, coverageData.GetExitCode());
+
+			const auto& files = modules.at(0)->GetFiles();
+			ASSERT_EQ(2, files.size());
+			ASSERT_EQ(filePath, files.at(0)->GetPath());
+			ASSERT_EQ(5, files.at(0)->GetLines().size());
+			ASSERT_EQ(expectedExecutedLines, GetExecutedLines(*files.at(0)));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataAlgebraTest, Difference)
+	{
+		CheckExecutedLines(cov::CoverageDataOperation::Difference, { 1, 4 });
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataAlgebraTest, Intersection)
+	{
+		CheckExecutedLines(cov::CoverageDataOperation::Intersection, { 2 });
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataAlgebraTest, SymmetricDifference)
+	{
+		CheckExecutedLines(cov::CoverageDataOperation::SymmetricDifference, { 1, 3, 4, 5 });
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataAlgebraTest, NewlyUncovered)
+	{
+		auto coverageData = Compute(cov::CoverageDataOperation::NewlyUncovered);
+		const auto& modules = coverageData.GetModules();
+
+		ASSERT_EQ(L"2", coverageData.GetName());
+		ASSERT_EQ(2, coverageData.GetExitCode());
+		ASSERT_EQ(2, modules.size());
+
+		const auto& files = modules.at(0)->GetFiles();
+		ASSERT_EQ(1, files.size());
+		ASSERT_EQ(4, files.at(0)->GetLines().size());
+		ASSERT_EQ(std::vector<unsigned int>{ 4 }, GetExecutedLines(*files.at(0)));
+
+		const auto& otherModuleFiles = modules.at(1)->GetFiles();
+		ASSERT_EQ(1, otherModuleFiles.size());
+		ASSERT_TRUE(GetExecutedLines(*otherModuleFiles.at(0)).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataAlgebraTest, SparseLines)
+	{
+		const unsigned int lastLine = 4000000000;
+
+		ASSERT_EQ(std::vector<unsigned int>{ 1 }, ComputeSparseExecutedLines(cov::CoverageDataOperation::Difference));
+		ASSERT_EQ(std::vector<unsigned int>{ lastLine - 10 }, ComputeSparseExecutedLines(cov::CoverageDataOperation::Intersection));
+		ASSERT_EQ((std::vector<unsigned int>{ 1, lastLine }), ComputeSparseExecutedLines(cov::CoverageDataOperation::SymmetricDifference));
+		ASSERT_TRUE(ComputeSparseExecutedLines(cov::CoverageDataOperation::NewlyUncovered).empty());
+	}
+}
@@ -17,6 +17,7 @@
 #include "stdafx.h"
 
 #include <random>
+#include <chrono>
 #include <boost/filesystem.hpp>
 
 #include "CppCoverage/CoverageDataMerger.hpp"
@@ -200,4 +201,110 @@ namespace CppCoverageTest
 			CheckLineHasBeenExecuted(mergedFile, 3, true);
 		}
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, MergeFileCoverageLargeLineRange)
+	{
+		cov::CoverageData coverageData{ L"test", 0 };
+
+		auto& fileCoverage1 = coverageData.AddModule(modulePath).AddFile(filePath);
+		auto& fileCoverage2 = coverageData.AddModule(L"otherModule").AddFile(filePath);
+
+		AddLinesToFileCoverage(fileCoverage1, { { 63, false }, { 64, true }, { 1000, false } });
+		AddLinesToFileCoverage(fileCoverage2, { { 500, false }, { 1000, true }, { 5000, true } });
+		cov::CoverageDataMerger{}.MergeFileCoverage(coverageData);
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			auto& mergedFile = module->GetFiles().at(0);
+			ASSERT_EQ(5, mergedFile->GetLines().size());
+			CheckLineHasBeenExecuted(mergedFile, 63, false);
+			CheckLineHasBeenExecuted(mergedFile, 64, true);
+			CheckLineHasBeenExecuted(mergedFile, 500, false);
+			CheckLineHasBeenExecuted(mergedFile, 1000, true);
+			CheckLineHasBeenExecuted(mergedFile, 5000, true);
+			ASSERT_EQ(3, mergedFile->GetCoverageRate().GetExecutedLinesCount());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, MergeFileCoverageSparseLines)
+	{
+		cov::CoverageData coverageData{ L"test", 0 };
+		const int lastLine = 2000000000;
+
+		auto& fileCoverage1 = coverageData.AddModule(modulePath).AddFile(filePath);
+		auto& fileCoverage2 = coverageData.AddModule(L"otherModule").AddFile(filePath);
+
+		AddLinesToFileCoverage(fileCoverage1, { { 1, true }, { lastLine, false } });
+		AddLinesToFileCoverage(fileCoverage2, { { lastLine, true } });
+		cov::CoverageDataMerger{}.MergeFileCoverage(coverageData);
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			auto& mergedFile = module->GetFiles().at(0);
+			ASSERT_EQ(2, mergedFile->GetLines().size());
+			CheckLineHasBeenExecuted(mergedFile, 1, true);
+			CheckLineHasBeenExecuted(mergedFile, lastLine, true);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, MergeFileCoverageUpdateSharedLines)
+	{
+		cov::CoverageData coverageData{ L"test", 0 };
+
+		auto& fileCoverage1 = coverageData.AddModule(modulePath).AddFile(filePath);
+		auto& fileCoverage2 = coverageData.AddModule(L"otherModule").AddFile(filePath);
+
+		AddLinesToFileCoverage(fileCoverage1, { { 0, false } });
+		AddLinesToFileCoverage(fileCoverage2, { { 1, false } });
+		cov::CoverageDataMerger{}.MergeFileCoverage(coverageData);
+		fileCoverage1.UpdateLine(0, true);
+		fileCoverage2.AddLine(2, true);
+
+		ASSERT_TRUE(fileCoverage1[0]->HasBeenExecuted());
+		ASSERT_FALSE(fileCoverage2[0]->HasBeenExecuted());
+		ASSERT_EQ(2, fileCoverage1.GetLines().size());
+		ASSERT_EQ(3, fileCoverage2.GetLines().size());
+	}
+
+	//-------------------------------------------------------------------------
+	// Microbenchmark: the same headers included in many modules.
+	// The duration is recorded as a test property.
+	TEST(CoverageDataMergerTest, DISABLED_MergeFileCoverageBenchmark)
+	{
+		const int moduleCount = 300;
+		const int headerCount = 200;
+		const unsigned int lineCount = 2000;
+		cov::CoverageData coverageData{ L"test", 0 };
+		std::default_random_engine generator;
+		std::uniform_int_distribution<int> distribution(0, 3);
+
+		for (int moduleIndex = 0; moduleIndex < moduleCount; ++moduleIndex)
+		{
+			auto& module = coverageData.AddModule(std::to_wstring(moduleIndex));
+
+			for (int headerIndex = 0; headerIndex < headerCount; ++headerIndex)
+			{
+				auto& file = module.AddFile(std::to_wstring(headerIndex) + L".h");
+				std::vector<cov::LineCoverage> lines;
+
+				for (unsigned int line = 1; line < lineCount; ++line)
+				{
+					auto value = distribution(generator);
+					if (value)
+						lines.emplace_back(line, value == 1);
+				}
+				file.AddLines(std::move(lines));
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		cov::CoverageDataMerger{}.MergeFileCoverage(coverageData);
+		auto duration = std::chrono::steady_clock::now() - start;
+
+		RecordProperty("MergeFileCoverageMs",
+			static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+
+#include "CppCoverage/CoverageJournal.hpp"
+#include "CppCoverage/CoverageJournalReader.hpp"
+#include "CppCoverage/ExecutedAddressManager.hpp"
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/Address.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/CoverageDataComparer.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const std::chrono::milliseconds NoFlushInterval{ std::chrono::hours{ 1 } };
+
+		//---------------------------------------------------------------------
+		void WriteJournal(cov::CoverageJournal& journal)
+		{
+			auto module1 = journal.AddModule(L"module1");
+			auto module2 = journal.AddModule(L"module2");
+			auto file1 = journal.AddFile(module1, L"file1");
+			auto file2 = journal.AddFile(module2, L"file2");
+
+			journal.AddLine(file1, 10);
+			auto line12 = journal.AddLine(file1, 12);
+			auto line11 = journal.AddLine(file1, 11);
+			auto line20 = journal.AddLine(file2, 20);
+
+			journal.OnLineExecuted(line12);
+			journal.OnLineExecuted(line11);
+			journal.OnLineExecuted(line20);
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateExpectedCoverageData(int exitCode)
+		{
+			cov::CoverageData coverageData{ L"name", exitCode };
+			auto& file1 = coverageData.AddModule(L"module1").AddFile(L"file1");
+			auto& file2 = coverageData.AddModule(L"module2").AddFile(L"file2");
+
+			file1.AddLine(10, false);
+			file1.AddLine(11, true);
+			file1.AddLine(12, true);
+			file2.AddLine(20, true);
+
+			return coverageData;
+		}
+
+		#pragma warning(push)
+		#pragma warning(disable: 4312) // 'reinterpret_cast': conversion from 'int' to 'void *' of greater size
+		//---------------------------------------------------------------------
+		cov::Address CreateAddress(int addressValue)
+		{
+			return cov::Address{ nullptr, reinterpret_cast<void*>(addressValue) };
+		}
+		#pragma warning(pop)
+
+		//---------------------------------------------------------------------
+		void RegisterAndExecuteAddresses(cov::ExecutedAddressManager& manager, int addressCount)
+		{
+			const int linesByFile = 1000;
+
+			manager.AddModule(L"module", nullptr);
+			for (int i = 0; i < addressCount; ++i)
+				manager.RegisterAddress(CreateAddress(i), L"file" + std::to_wstring(i / linesByFile), i % linesByFile, 0);
+			for (int i = 0; i < addressCount; i += 2)
+				manager.MarkAddressAsExecuted(CreateAddress(i));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, WriteAndRead)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			cov::CoverageJournal journal{ path, L"name", NoFlushInterval, true };
+
+			WriteJournal(journal);
+			journal.Close(42);
+		}
+
+		ASSERT_TRUE(cov::CoverageJournalReader::IsCoverageJournal(path));
+		auto coverageData = cov::CoverageJournalReader{}.Read(path);
+		TestHelper::CoverageDataComparer().AssertEquals(CreateExpectedCoverageData(42), coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, NotClosed)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			cov::CoverageJournal journal{ path, L"name", NoFlushInterval, false };
+
+			WriteJournal(journal);
+		}
+
+		auto coverageData = cov::CoverageJournalReader{}.Read(path);
+		TestHelper::CoverageDataComparer().AssertEquals(
+			CreateExpectedCoverageData(cov::CoverageJournalReader::IncompleteJournalExitCode), coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, IncompleteRecord)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			// Each entry is written in its own record.
+			cov::CoverageJournal journal{ path, L"name", std::chrono::milliseconds{ 0 }, false };
+
+			WriteJournal(journal);
+			journal.Close(42);
+		}
+
+		// The exit record is only partially written.
+		fs::resize_file(path, fs::file_size(path) - 1);
+
+		auto coverageData = cov::CoverageJournalReader{}.Read(path);
+		TestHelper::CoverageDataComparer().AssertEquals(
+			CreateExpectedCoverageData(cov::CoverageJournalReader::IncompleteJournalExitCode), coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, NotAJournal)
+	{
+		TestHelper::TemporaryPath path{ TestHelper::TemporaryPathOption::CreateAsFile };
+
+		ASSERT_FALSE(cov::CoverageJournalReader::IsCoverageJournal(path));
+		ASSERT_THROW(cov::CoverageJournalReader{}.Read(path), std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, ExecutedAddressManager)
+	{
+		TestHelper::TemporaryPath path;
+		cov::ExecutedAddressManager manager;
+		auto journal = std::make_shared<cov::CoverageJournal>(path, L"name", NoFlushInterval, false);
+
+		manager.SetJournal(journal);
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(CreateAddress(1), L"file", 42, 0);
+		manager.RegisterAddress(CreateAddress(2), L"file", 43, 0);
+		manager.RegisterAddress(CreateAddress(3), L"file", 43, 0);
+		manager.MarkAddressAsExecuted(CreateAddress(2));
+		manager.MarkAddressAsExecuted(CreateAddress(3));
+		journal->Close(0);
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+			manager.CreateCoverageData(L"name", 0),
+			cov::CoverageJournalReader{}.Read(path));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, ExecutedAddressManagerNewJournal)
+	{
+		TestHelper::TemporaryPath path1;
+		TestHelper::TemporaryPath path2;
+		cov::ExecutedAddressManager manager;
+		auto journal1 = std::make_shared<cov::CoverageJournal>(path1, L"name", NoFlushInterval, false);
+
+		manager.SetJournal(journal1);
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(CreateAddress(1), L"file", 42, 0);
+		manager.MarkAddressAsExecuted(CreateAddress(1));
+		journal1->Close(0);
+
+		manager.SetJournal(nullptr);
+		manager.RegisterAddress(CreateAddress(2), L"file", 43, 0);
+
+		auto journal2 = std::make_shared<cov::CoverageJournal>(path2, L"name", NoFlushInterval, false);
+		manager.SetJournal(journal2);
+		manager.RegisterAddress(CreateAddress(3), L"file", 44, 0);
+		manager.MarkAddressAsExecuted(CreateAddress(3));
+		journal2->Close(0);
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+			manager.CreateCoverageData(L"name", 0),
+			cov::CoverageJournalReader{}.Read(path2));
+	}
+
+	//-------------------------------------------------------------------------
+	// Durations and journal sizes are recorded as test properties.
+	TEST(CoverageJournalTest, DISABLED_JournalBenchmark)
+	{
+		const int addressCount = 1000000;
+		std::vector<std::pair<std::string, std::function<void(cov::ExecutedAddressManager&, const fs::path&)>>> modes = {
+			{ "NoJournal", [](cov::ExecutedAddressManager&, const fs::path&) {} },
+			{ "Journal", [](cov::ExecutedAddressManager& manager, const fs::path& path)
+				{
+					manager.SetJournal(std::make_shared<cov::CoverageJournal>(path, L"name", std::chrono::milliseconds{ 1000 }, false));
+				} },
+			{ "JournalWithSync", [](cov::ExecutedAddressManager& manager, const fs::path& path)
+				{
+					manager.SetJournal(std::make_shared<cov::CoverageJournal>(path, L"name", std::chrono::milliseconds{ 1000 }, true));
+				} } };
+
+		for (const auto& mode : modes)
+		{
+			TestHelper::TemporaryPath path;
+			auto start = std::chrono::steady_clock::now();
+			{
+				cov::ExecutedAddressManager manager;
+
+				mode.second(manager, path);
+				RegisterAndExecuteAddresses(manager, addressCount);
+			}
+			auto end = std::chrono::steady_clock::now();
+			auto fileSize = fs::exists(path) ? fs::file_size(path) : 0;
+
+			RecordProperty(mode.first + "Ms",
+				static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+			RecordProperty(mode.first + "KB", static_cast<int>(fileSize / 1024));
+		}
+	}
+}
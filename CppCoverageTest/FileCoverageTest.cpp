@@ -60,4 +60,61 @@ namespace CppCoverageTest
 		
 		ASSERT_THROW(file.UpdateLine(0, false), cov::CppCoverageException);
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, AddLinesUnordered)
+	{
+		cov::FileCoverage file{ L"" };
+
+		file.AddLine(10, false);
+		file.AddLine(2, true);
+		file.AddLines({ { 5, true }, { 1, false } });
+
+		const auto& lines = file.GetLines();
+		ASSERT_EQ(4, lines.size());
+		ASSERT_EQ(1, lines[0].GetLineNumber());
+		ASSERT_EQ(2, lines[1].GetLineNumber());
+		ASSERT_EQ(5, lines[2].GetLineNumber());
+		ASSERT_EQ(10, lines[3].GetLineNumber());
+		ASSERT_TRUE(file[5]->HasBeenExecuted());
+		ASSERT_FALSE(file[10]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, AddLinesSorted)
+	{
+		cov::FileCoverage file{ L"" };
+
+		file.AddLines({ { 1, true }, { 3, false }, { 7, true } });
+
+		ASSERT_EQ(3, file.GetLines().size());
+		ASSERT_EQ(nullptr, file[2]);
+		ASSERT_FALSE(file[3]->HasBeenExecuted());
+		ASSERT_TRUE(file[7]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, AddLineAlreadyExists)
+	{
+		cov::FileCoverage file{ L"" };
+
+		file.AddLines({ { 1, true }, { 3, false } });
+		ASSERT_THROW(file.AddLine(1, false), cov::CppCoverageException);
+		ASSERT_THROW(file.AddLines({ { 3, true } }), cov::CppCoverageException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, CoverageRate)
+	{
+		cov::FileCoverage file{ L"" };
+
+		file.AddLines({ { 1, true }, { 2, false } });
+		file.AddLine(3, false);
+		file.UpdateLine(2, true);
+		file.UpdateLine(1, true);
+
+		const auto& coverageRate = file.GetCoverageRate();
+		ASSERT_EQ(2, coverageRate.GetExecutedLinesCount());
+		ASSERT_EQ(1, coverageRate.GetUnExecutedLinesCount());
+	}
+}
@@ -85,6 +85,34 @@ namespace CppCoverageTest
 		{ cov::OptionsExport{ cov::OptionsExportType::Cobertura } });
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesCompactHtml)
+	{
+		TestExportTypes(
+		{ cov::ProgramOptions::ExportTypeCompactHtmlValue },
+		{ cov::OptionsExport{ cov::OptionsExportType::CompactHtml } });
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesLcov)
+	{
+		TestExportTypes(
+		{ cov::ProgramOptions::ExportTypeLcovValue },
+		{ cov::OptionsExport{ cov::OptionsExportType::Lcov } });
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesBinary)
+	{
+		TestExportTypes(
+		{ cov::ProgramOptions::ExportTypeBinaryValue, 
+		  cov::ProgramOptions::ExportTypeBinaryV2Value, 
+		  cov::ProgramOptions::ExportTypeBinaryV2CompressedValue },
+		{ cov::OptionsExport{ cov::OptionsExportType::Binary }, 
+		  cov::OptionsExport{ cov::OptionsExportType::BinaryV2 },
+		  cov::OptionsExport{ cov::OptionsExportType::BinaryV2Compressed } });
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(OptionsParserExportTest, ExportTypesBoth)
 	{
@@ -49,6 +49,9 @@ namespace CppCoverageTest
 		ASSERT_FALSE(options->IsContinueAfterCppExceptionModeEnabled());
 		ASSERT_FALSE(options->IsOptimizedBuildSupportEnabled());
 		ASSERT_TRUE(options->GetExcludedLineRegexes().empty());
+		ASSERT_FALSE(options->GetJournalPath());
+		ASSERT_FALSE(options->IsStatModeEnabled());
+		ASSERT_FALSE(options->GetMinCoverage());
 	}
 
 	//-------------------------------------------------------------------------
@@ -229,4 +232,75 @@ namespace CppCoverageTest
 			option->GetExcludedLineRegexes(), 
 			testing::ElementsAre(Tools::LocalToWString(excludedLineRegex)));
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CoverageOperation)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath path1{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath path2{ TestHelper::TemporaryPathOption::CreateAsFile };
+
+		auto options = TestTools::Parse(parser,
+			{ TestTools::OptionPrefix + cov::ProgramOptions::InputCoverageValue, path1.GetPath().string(),
+			  TestTools::OptionPrefix + cov::ProgramOptions::InputCoverageValue, path2.GetPath().string(),
+			  TestTools::OptionPrefix + cov::ProgramOptions::CoverageOperationOption,
+			  cov::ProgramOptions::CoverageOperationNewlyUncoveredValue }, false);
+
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->GetCoverageDataOperation() == cov::CoverageDataOperation::NewlyUncovered);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InvalidCoverageOperation)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath path{ TestHelper::TemporaryPathOption::CreateAsFile };
+		auto pathStr = path.GetPath().string();
+		const auto coverageOperation = TestTools::OptionPrefix + cov::ProgramOptions::CoverageOperationOption;
+		const auto inputCoverage = TestTools::OptionPrefix + cov::ProgramOptions::InputCoverageValue;
+
+		ASSERT_FALSE(TestTools::Parse(parser, { inputCoverage, pathStr, inputCoverage, pathStr, 
+			coverageOperation, "invalid" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { inputCoverage, pathStr, 
+			coverageOperation, cov::ProgramOptions::CoverageOperationDifferenceValue }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { inputCoverage, pathStr, inputCoverage, pathStr,
+			coverageOperation, cov::ProgramOptions::CoverageOperationDifferenceValue }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Journal)
+	{
+		cov::OptionsParser parser;
+		const std::string journalPath = "journal";
+		const auto journal = TestTools::OptionPrefix + cov::ProgramOptions::JournalOption;
+		const auto journalSync = TestTools::OptionPrefix + cov::ProgramOptions::JournalSyncOption;
+
+		auto options = TestTools::Parse(parser, { journal, journalPath, journalSync });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(journalPath, options->GetJournalPath()->string());
+		ASSERT_TRUE(options->IsJournalSyncModeEnabled());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { journalSync }));
+		ASSERT_FALSE(TestTools::Parse(parser, { journal, journalPath }, false));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Stat)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath path{ TestHelper::TemporaryPathOption::CreateAsFile };
+		auto pathStr = path.GetPath().string();
+		const auto inputCoverage = TestTools::OptionPrefix + cov::ProgramOptions::InputCoverageValue;
+		const auto stat = TestTools::OptionPrefix + cov::ProgramOptions::StatOption;
+		const auto minCoverage = TestTools::OptionPrefix + cov::ProgramOptions::MinCoverageOption;
+
+		auto options = TestTools::Parse(parser, { inputCoverage, pathStr, stat, minCoverage, "75.5" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsStatModeEnabled());
+		ASSERT_EQ(75.5, *options->GetMinCoverage());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { stat }));
+		ASSERT_FALSE(TestTools::Parse(parser, { inputCoverage, pathStr, minCoverage, "75" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { inputCoverage, pathStr, stat, minCoverage, "101" }, false));
+	}
 }
\ No newline at end of file
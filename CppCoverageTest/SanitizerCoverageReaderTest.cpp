@@ -0,0 +1,186 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "CppCoverage/SanitizerCoverageReader.hpp"
+#include "CppCoverage/DebugInformationEnumerator.hpp"
+#include "CppCoverage/CoverageFilterManager.hpp"
+#include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "SanitizerCoverageRuntime/SanitizerCoverageFile.hpp"
+
+#include "TestCoverageConsole/TestDebugInformationEnumerator.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+namespace sancov = SanitizerCoverageRuntime;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct DebugInformationHandlerMock : cov::IDebugInformationHandler
+		{
+			//-----------------------------------------------------------------
+			bool IsSourceFileSelected(const fs::path& sourceFile) override
+			{
+				return sourceFile.filename() == TestCoverageConsole::GetDebugInformationEnumeratorTestPath();
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFile(const fs::path&, const std::vector<Line>& lines) override
+			{
+				lines_.insert(lines_.end(), lines.begin(), lines.end());
+			}
+
+			std::vector<Line> lines_;
+		};
+
+		//---------------------------------------------------------------------
+		// Lines of TestDebugInformationEnumerator.cpp sorted by address.
+		std::vector<cov::IDebugInformationHandler::Line> GetSortedLines()
+		{
+			DebugInformationHandlerMock debugInformationHandler;
+
+			cov::DebugInformationEnumerator{}.Enumerate(
+				TestCoverageConsole::GetOutputBinaryPath(), debugInformationHandler);
+			auto lines = debugInformationHandler.lines_;
+			std::sort(lines.begin(), lines.end(), [](const auto& line1, const auto& line2)
+			{
+				return line1.virtualAddress_ < line2.virtualAddress_;
+			});
+			return lines;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteFile(
+			const fs::path& path,
+			const std::wstring& modulePath,
+			const std::vector<sancov::Block>& blocks)
+		{
+			sancov::FileHeader header = {};
+			std::memcpy(header.magic, sancov::FileMagic, sizeof(header.magic));
+			header.version = sancov::FileVersion;
+			header.modulePathSize = static_cast<uint32_t>(modulePath.size());
+			header.blockCount = static_cast<uint32_t>(blocks.size());
+
+			std::ofstream ofs{ path.string(), std::ios::binary };
+			ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			ofs.write(reinterpret_cast<const char*>(modulePath.c_str()), modulePath.size() * sizeof(wchar_t));
+			ofs.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(sancov::Block));
+		}
+
+		//---------------------------------------------------------------------
+		sancov::Block CreateBlock(const cov::IDebugInformationHandler::Line& line, uint32_t flags)
+		{
+			return sancov::Block{ static_cast<uint32_t>(line.virtualAddress_), flags };
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData Read(const fs::path& path)
+		{
+			cov::Patterns patterns;
+			patterns.AddSelectedPatterns(L"*");
+			cov::CoverageFilterManager coverageFilterManager{
+				cov::CoverageFilterSettings{ patterns, patterns }, {}, {}, false };
+
+			return cov::SanitizerCoverageReader{}.Read(path, coverageFilterManager);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SanitizerCoverageReaderTest, Read)
+	{
+		auto lines = GetSortedLines();
+		ASSERT_EQ(4, lines.size());
+
+		// The guards are not in the order of the addresses.
+		TestHelper::TemporaryPath path;
+		WriteFile(path, TestCoverageConsole::GetOutputBinaryPath().wstring(), {
+			CreateBlock(lines[3], sancov::Executed),
+			CreateBlock(lines[0], sancov::FunctionEntry | sancov::Executed),
+			CreateBlock(lines[2], 0) });
+
+		ASSERT_TRUE(cov::SanitizerCoverageReader::IsSanitizerCoverageFile(path));
+		auto coverageData = Read(path);
+
+		ASSERT_EQ(1, coverageData.GetModules().size());
+		const auto& module = *coverageData.GetModules().at(0);
+		ASSERT_EQ(TestCoverageConsole::GetOutputBinaryPath(), module.GetPath());
+		ASSERT_EQ(1, module.GetFiles().size());
+		const auto& file = *module.GetFiles().at(0);
+		ASSERT_EQ(TestCoverageConsole::GetDebugInformationEnumeratorTestPath(), file.GetPath().filename());
+
+		const std::vector<bool> expectedExecutions = { true, true, false, true };
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			const auto* line = file[static_cast<unsigned int>(lines[i].lineNumber_)];
+			ASSERT_NE(nullptr, line);
+			ASSERT_EQ(expectedExecutions[i], line->HasBeenExecuted());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SanitizerCoverageReaderTest, NoFunctionEntry)
+	{
+		auto lines = GetSortedLines();
+		ASSERT_FALSE(lines.empty());
+
+		TestHelper::TemporaryPath path;
+		WriteFile(path, TestCoverageConsole::GetOutputBinaryPath().wstring(), {
+			CreateBlock(lines[0], sancov::Executed) });
+
+		auto coverageData = Read(path);
+		ASSERT_EQ(1, coverageData.GetModules().size());
+		ASSERT_TRUE(coverageData.GetModules().at(0)->GetFiles().empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SanitizerCoverageReaderTest, InvalidFile)
+	{
+		TestHelper::TemporaryPath path;
+		std::ofstream{ path.GetPath().string() } << "Invalid";
+
+		ASSERT_FALSE(cov::SanitizerCoverageReader::IsSanitizerCoverageFile(path));
+		ASSERT_THROW(Read(path), cov::CppCoverageException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SanitizerCoverageReaderTest, TruncatedFile)
+	{
+		TestHelper::TemporaryPath path;
+		WriteFile(path, L"module", { sancov::Block{ 0, sancov::FunctionEntry } });
+		fs::resize_file(path, fs::file_size(path) - 1);
+
+		ASSERT_TRUE(cov::SanitizerCoverageReader::IsSanitizerCoverageFile(path));
+		ASSERT_THROW(Read(path), cov::CppCoverageException);
+	}
+}
@@ -0,0 +1,202 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <random>
+
+#include "CppCoverage/WildcardsMatcher.hpp"
+#include "CppCoverage/Wildcards.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		// Index of the first Wildcards matching str as WildcardCoverageFilter
+		// computed it before WildcardsMatcher.
+		boost::optional<size_t> MatchWithRegex(
+			const std::vector<cov::Wildcards>& wildcardsCollection,
+			const std::wstring& str)
+		{
+			for (size_t i = 0; i < wildcardsCollection.size(); ++i)
+			{
+				if (wildcardsCollection[i].Match(str))
+					return i;
+			}
+			return boost::none;
+		}
+
+		//---------------------------------------------------------------------
+		int ToIndex(const boost::optional<size_t>& patternIndex)
+		{
+			return (patternIndex) ? static_cast<int>(*patternIndex) : -1;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<cov::Wildcards> BuildWildcards(const std::vector<std::wstring>& patterns)
+		{
+			std::vector<cov::Wildcards> wildcardsCollection;
+
+			for (const auto& pattern : patterns)
+				wildcardsCollection.emplace_back(pattern);
+			return wildcardsCollection;
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GenerateString(std::mt19937& generator, const std::wstring& chars, size_t maxSize)
+		{
+			std::uniform_int_distribution<size_t> sizeDistribution{ 0, maxSize };
+			std::uniform_int_distribution<size_t> charDistribution{ 0, chars.size() - 1 };
+			std::wstring str(sizeDistribution(generator), L'\0');
+
+			for (auto& c : str)
+				c = chars[charDistribution(generator)];
+			return str;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::wstring> GenerateSourcePaths(size_t count)
+		{
+			std::vector<std::wstring> paths;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				paths.push_back(L"C:\\Dev\\Project" + std::to_wstring(i % 7) + L"\\Module" + std::to_wstring(i % 50)
+					+ L"\\Src\\Folder" + std::to_wstring(i % 13) + L"\\File" + std::to_wstring(i) + L".cpp");
+			}
+			return paths;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, FirstMatchingPattern)
+	{
+		cov::WildcardsMatcher matcher{ { L"abc", L"b", L"a*c" } };
+
+		ASSERT_EQ(0, *matcher.Match(L"xabcx"));
+		ASSERT_EQ(1, *matcher.Match(L"ab"));
+		ASSERT_EQ(2, *matcher.Match(L"axxc"));
+		ASSERT_FALSE(matcher.Match(L"ca"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, NoPattern)
+	{
+		cov::WildcardsMatcher matcher{ {} };
+
+		ASSERT_FALSE(matcher.Match(L""));
+		ASSERT_FALSE(matcher.Match(L"a"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, Stars)
+	{
+		ASSERT_EQ(1, *cov::WildcardsMatcher({ L"b", L"**" }).Match(L""));
+		ASSERT_EQ(0, *cov::WildcardsMatcher({ L"**a**b**" }).Match(L"xaxbx"));
+		ASSERT_FALSE(cov::WildcardsMatcher({ L"a*b" }).Match(L"ba"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, LiteralsDoNotOverlap)
+	{
+		cov::WildcardsMatcher matcher{ { L"aba*aba" } };
+
+		ASSERT_FALSE(matcher.Match(L"ababa"));
+		ASSERT_TRUE(matcher.Match(L"abaaba"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, LineBreak)
+	{
+		cov::WildcardsMatcher matcher{ { L"a*b" } };
+
+		ASSERT_FALSE(matcher.Match(L"a\nb"));
+		ASSERT_FALSE(matcher.Match(L"a\rb"));
+		ASSERT_TRUE(matcher.Match(L"a\nab"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, CaseSensitivity)
+	{
+		ASSERT_TRUE(cov::WildcardsMatcher({ L"AbC" }).Match(L"aBc"));
+		ASSERT_FALSE(cov::WildcardsMatcher({ L"AbC" }, true).Match(L"aBc"));
+		ASSERT_TRUE(cov::WildcardsMatcher({ L"AbC" }, true).Match(L"AbC"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, SpecialChars)
+	{
+		std::wstring specialChars{ cov::Wildcards::EscapedChars.begin(), cov::Wildcards::EscapedChars.end() };
+
+		ASSERT_TRUE(cov::WildcardsMatcher({ specialChars }).Match(specialChars));
+		ASSERT_FALSE(cov::WildcardsMatcher({ L"a.c" }).Match(L"abc"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, SameResultAsWildcards)
+	{
+		std::mt19937 generator{ 42 };
+
+		for (int i = 0; i < 200; ++i)
+		{
+			std::vector<std::wstring> patterns;
+			for (int j = 0; j < 5; ++j)
+				patterns.push_back(GenerateString(generator, L"abAB*.\\", 6));
+
+			cov::WildcardsMatcher matcher{ patterns };
+			auto wildcardsCollection = BuildWildcards(patterns);
+
+			for (int j = 0; j < 50; ++j)
+			{
+				auto str = GenerateString(generator, L"abAB.\\\n", 12);
+				ASSERT_EQ(ToIndex(MatchWithRegex(wildcardsCollection, str)), ToIndex(matcher.Match(str))) << str;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// Durations are recorded as test properties.
+	TEST(WildcardsMatcherTest, DISABLED_MatchBenchmark)
+	{
+		const size_t patternCount = 40;
+		std::vector<std::wstring> patterns;
+
+		for (size_t i = 0; i < patternCount; ++i)
+			patterns.push_back(L"*\\Module" + std::to_wstring(i + 30) + L"\\*\\Folder*.cpp");
+		auto paths = GenerateSourcePaths(200000);
+		auto wildcardsCollection = BuildWildcards(patterns);
+		cov::WildcardsMatcher matcher{ patterns };
+		size_t regexMatchCount = 0;
+		size_t matcherMatchCount = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& path : paths)
+			regexMatchCount += MatchWithRegex(wildcardsCollection, path) ? 1 : 0;
+		auto middle = std::chrono::steady_clock::now();
+		for (const auto& path : paths)
+			matcherMatchCount += matcher.Match(path) ? 1 : 0;
+		auto end = std::chrono::steady_clock::now();
+
+		ASSERT_EQ(regexMatchCount, matcherMatchCount);
+		RecordProperty("WildcardsMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()));
+		RecordProperty("WildcardsMatcherMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count()));
+	}
+}
@@ -21,12 +21,16 @@
 
 #include <boost/filesystem.hpp>
 
-#include "CoverageDataSerializer.hpp"
-
 #include "Tools/Tool.hpp"
 
 namespace Exporter
 {
+	//-------------------------------------------------------------------------
+	BinaryExporter::BinaryExporter(BinaryFormat format)
+		: format_{ format }
+	{
+	}
+
 	//-------------------------------------------------------------------------
 	boost::filesystem::path BinaryExporter::GetDefaultPath(const std::wstring& prefix) const
 	{
@@ -42,7 +46,7 @@ namespace Exporter
 		const CppCoverage::CoverageData& coverageData, 
 		const boost::filesystem::path& output)
 	{
-		CoverageDataSerializer coverageDataSerializer;
+		CoverageDataSerializer coverageDataSerializer{ format_ };
 
 		coverageDataSerializer.Serialize(coverageData, output);
 		Tools::ShowOutputMessage(L"Coverage binary generated in file: ", output);
@@ -18,13 +18,14 @@
 
 #include "../ExporterExport.hpp"
 #include "../IExporter.hpp"
+#include "CoverageDataSerializer.hpp"
 
 namespace Exporter
 {
 	class EXPORTER_DLL BinaryExporter : public IExporter
 	{
 	public:
-		BinaryExporter() = default;
+		explicit BinaryExporter(BinaryFormat format = BinaryFormat::V1);
 
 		boost::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
 		void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& output) override;
@@ -32,6 +33,8 @@ namespace Exporter
 	private:
 		BinaryExporter(const BinaryExporter&) = delete;
 		BinaryExporter& operator=(const BinaryExporter&) = delete;
+
+		BinaryFormat format_;
 	};
 }
 
@@ -17,103 +17,168 @@
 #include "stdafx.h"
 #include "CoverageDataDeserializer.hpp"
 
-#include "CoverageData.pb.h"
-
 #include "CppCoverage/CoverageData.hpp"
 #include "CppCoverage/ModuleCoverage.hpp"
 #include "CppCoverage/FileCoverage.hpp"
 
-#include "../ExporterException.hpp"
-
 #include "Tools/Tool.hpp"
+#include "Tools/ParallelFor.hpp"
 
-#include "CoverageDataSerializer.hpp"
-#include "ProtoBuff.hpp"
+#include "CoverageDataReader.hpp"
 
-namespace pb = ProtoBuff;
 namespace cov = CppCoverage;
 
 namespace Exporter
 {
 	namespace
 	{
+		// Modules are decoded by batches to bound the memory used by the
+		// bytes of modules not decoded yet.
+		const size_t MaxBatchSize = 64 * 1024 * 1024;
+
 		//---------------------------------------------------------------------
-		void ReadMessage(
-			google::protobuf::io::CodedInputStream& input,
-			google::protobuf::MessageLite& message)
+		cov::CoverageRate ToCoverageRate(unsigned int executedLinesCount, unsigned int unexecutedLinesCount)
 		{
-			unsigned int size = 0;
-
-			if (!input.ReadVarint32(&size))
-				THROW(L"Cannot read message size.");
-			auto limit = input.PushLimit(size);
+			return cov::CoverageRate{ static_cast<int>(executedLinesCount), static_cast<int>(unexecutedLinesCount) };
+		}
 
-			if (!message.ParseFromCodedStream(&input))
-				THROW(L"Cannot parse message.");
+		//---------------------------------------------------------------------
+		ModuleCoverageSummary CreateModuleSummary(const TableOfContentsEntry& entry, const PathTable& pathTable)
+		{
+			ModuleCoverageSummary moduleSummary{
+				pathTable.GetPath(entry.pathIndex),
+				ToCoverageRate(entry.executedLinesCount, entry.unexecutedLinesCount), {} };
 
-			input.PopLimit(limit);
+			moduleSummary.files.reserve(entry.files.size());
+			for (const auto& file : entry.files)
+			{
+				moduleSummary.files.push_back(FileCoverageSummary{
+					pathTable.GetPath(file.pathIndex),
+					ToCoverageRate(file.executedLinesCount, file.unexecutedLinesCount) });
+			}
+			return moduleSummary;
 		}
 
 		//---------------------------------------------------------------------
-		void InitCoverageDataFrom(
-			google::protobuf::io::CodedInputStream&  input,
-			const pb::CoverageData& coverageDataProtoBuff,
-			cov::CoverageData& coverageData)
+		ModuleCoverageSummary CreateModuleSummary(const cov::ModuleCoverage& module)
 		{
-			auto moduleCount = coverageDataProtoBuff.modulecount();
+			ModuleCoverageSummary moduleSummary{ module.GetPath(), cov::CoverageRate{}, {} };
 
-			for (size_t i = 0; i < moduleCount; ++i)
+			moduleSummary.files.reserve(module.GetFiles().size());
+			for (const auto& file : module.GetFiles())
 			{
-				pb::ModuleCoverage moduleProtoBuff;
+				moduleSummary.coverageRate += file->GetCoverageRate();
+				moduleSummary.files.push_back(FileCoverageSummary{ file->GetPath(), file->GetCoverageRate() });
+			}
+			return moduleSummary;
+		}
+	}
 
-				ReadMessage(input, moduleProtoBuff);				
-				auto& module = coverageData.AddModule(Tools::Utf8ToWString(moduleProtoBuff.path()));
+	//-------------------------------------------------------------------------
+	CoverageDataDeserializer::CoverageDataDeserializer(size_t maxThreadCount)
+		: maxThreadCount_{ maxThreadCount }
+	{
+	}
 
-				for (const auto& fileProtoBuff : moduleProtoBuff.files())
-				{
-					auto& file = module.AddFile(Tools::Utf8ToWString(fileProtoBuff.path()));
+	//-------------------------------------------------------------------------
+	CppCoverage::CoverageData CoverageDataDeserializer::Deserialize(
+		const boost::filesystem::path& path, 
+		const std::string& errorIfNotCorrectFormat) const
+	{
+		CoverageDataReader reader{ path, errorIfNotCorrectFormat };
+		cov::CoverageData coverageData{ Tools::Utf8ToWString(reader.GetName()), reader.GetExitCode() };
+		auto moduleCount = reader.GetModuleCount();
+		std::vector<ModulePayload> payloads;
+		std::vector<std::unique_ptr<cov::ModuleCoverage>> modules;
+
+		coverageData.ReserveModules(static_cast<size_t>(moduleCount));
+		for (google::protobuf::uint64 i = 0; i < moduleCount;)
+		{
+			size_t batchSize = 0;
 
-					for (const auto& line : fileProtoBuff.lines())
-						file.AddLine(line.linenumber(), line.hasbeenexecuted());
-				}
+			// Reading is sequential, only decoding is done in parallel.
+			payloads.clear();
+			for (; i < moduleCount && batchSize < MaxBatchSize; ++i)
+			{
+				payloads.push_back(reader.ReadModulePayload());
+				batchSize += payloads.back().bytes.size();
 			}
-		}		
 
-		//-------------------------------------------------------------------------
-		cov::CoverageData DeserializeFromStream(
-			std::istream& istr,
-			const std::string& errorIfNotCorrectFormat)
-		{
-			google::protobuf::io::IstreamInputStream outputStream(&istr);
-			google::protobuf::io::CodedInputStream  codedInputStream(&outputStream);
-
-			unsigned int fileTypeId;
-			if (!codedInputStream.ReadVarint32(&fileTypeId) || fileTypeId != CoverageDataSerializer::FileTypeId)
-				throw std::runtime_error(errorIfNotCorrectFormat);
+			modules.clear();
+			modules.resize(payloads.size());
+			Tools::ParallelFor(payloads.size(), [&](size_t j)
+			{
+				modules[j] = reader.DecodeModule(payloads[j]);
+			}, maxThreadCount_);
 
-			pb::CoverageData coverageDataProtoBuff;
+			// Keep the order of the file.
+			for (auto& module : modules)
+				coverageData.AddModule(std::move(module));
+		}
 
-			ReadMessage(codedInputStream, coverageDataProtoBuff);
+		return coverageData;
+	}
 
-			cov::CoverageData coverageData{
-				Tools::Utf8ToWString(coverageDataProtoBuff.name()),
-				coverageDataProtoBuff.exitcode() };
+	//-------------------------------------------------------------------------
+	CppCoverage::CoverageData CoverageDataDeserializer::DeserializeModules(
+		const boost::filesystem::path& path,
+		const T_IsModuleSelected& isModuleSelected,
+		const std::string& errorIfNotCorrectFormat) const
+	{
+		CoverageDataReader reader{ path, errorIfNotCorrectFormat };
+		cov::CoverageData coverageData{ Tools::Utf8ToWString(reader.GetName()), reader.GetExitCode() };
+		TableOfContents tableOfContents;
 
-			InitCoverageDataFrom(codedInputStream, coverageDataProtoBuff, coverageData);
+		if (reader.ReadTableOfContents(tableOfContents))
+		{
+			for (const auto& entry : tableOfContents.entries)
+			{
+				if (isModuleSelected(reader.GetPathTable().GetPath(entry.pathIndex)))
+					reader.ReadModuleAt(entry.offset, coverageData);
+			}
+		}
+		else
+		{
+			// The path of a module is only known once the module is decoded.
+			for (google::protobuf::uint64 i = 0; i < reader.GetModuleCount(); ++i)
+			{
+				auto module = reader.DecodeModule(reader.ReadModulePayload());
 
-			return coverageData;
+				if (isModuleSelected(module->GetPath()))
+					coverageData.AddModule(std::move(module));
+			}
 		}
+
+		return coverageData;
 	}
-		
+
 	//-------------------------------------------------------------------------
-	CppCoverage::CoverageData CoverageDataDeserializer::Deserialize(
-		const boost::filesystem::path& path, 
+	CoverageDataSummary CoverageDataDeserializer::DeserializeSummary(
+		const boost::filesystem::path& path,
 		const std::string& errorIfNotCorrectFormat) const
 	{
-		std::ifstream ifs(path.string(), std::ios::binary);
+		CoverageDataReader reader{ path, errorIfNotCorrectFormat };
+		CoverageDataSummary summary{ Tools::Utf8ToWString(reader.GetName()), reader.GetExitCode(), cov::CoverageRate{}, {} };
+		TableOfContents tableOfContents;
+
+		if (reader.ReadTableOfContents(tableOfContents) && tableOfContents.hasFileSummaries)
+		{
+			summary.modules.reserve(tableOfContents.entries.size());
+			for (const auto& entry : tableOfContents.entries)
+				summary.modules.push_back(CreateModuleSummary(entry, reader.GetPathTable()));
+		}
+		else
+		{
+			for (google::protobuf::uint64 i = 0; i < reader.GetModuleCount(); ++i)
+			{
+				cov::CoverageData moduleCoverageData{ L"", 0 };
+
+				summary.modules.push_back(CreateModuleSummary(reader.ReadModule(moduleCoverageData)));
+			}
+		}
 
-		if (!ifs)
-			THROW(L"Cannot open file " + path.wstring());
-		return DeserializeFromStream(ifs, errorIfNotCorrectFormat);
+		for (const auto& module : summary.modules)
+			summary.coverageRate += module.coverageRate;
+		return summary;
 	}
 }
@@ -16,15 +16,14 @@
 
 #pragma once
 
-#include "../ExporterExport.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
 
-namespace boost
-{
-	namespace filesystem
-	{
-		class path;
-	}
-}
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "../ExporterExport.hpp"
 
 namespace CppCoverage
 {
@@ -33,16 +32,56 @@ namespace CppCoverage
 
 namespace Exporter
 {	
+	//-------------------------------------------------------------------------
+	struct FileCoverageSummary
+	{
+		boost::filesystem::path path;
+		CppCoverage::CoverageRate coverageRate;
+	};
+
+	//-------------------------------------------------------------------------
+	struct ModuleCoverageSummary
+	{
+		boost::filesystem::path path;
+		CppCoverage::CoverageRate coverageRate;
+		std::vector<FileCoverageSummary> files;
+	};
+
+	//-------------------------------------------------------------------------
+	struct CoverageDataSummary
+	{
+		std::wstring name;
+		int exitCode;
+		CppCoverage::CoverageRate coverageRate;
+		std::vector<ModuleCoverageSummary> modules;
+	};
+
 	class EXPORTER_DLL CoverageDataDeserializer
 	{
 	public:		
-		CoverageDataDeserializer() = default;
+		typedef std::function<bool(const boost::filesystem::path&)> T_IsModuleSelected;
+
+		// maxThreadCount is the number of threads decoding modules, 0 means
+		// one thread per hardware core.
+		explicit CoverageDataDeserializer(size_t maxThreadCount = 0);
 
 		CppCoverage::CoverageData Deserialize(const boost::filesystem::path&, const std::string& errorIfNotCorrectFormat) const;
+
+		// Deserialize only the modules accepted by isModuleSelected.
+		// The table of contents is used to skip the other modules when available.
+		CppCoverage::CoverageData DeserializeModules(
+			const boost::filesystem::path&,
+			const T_IsModuleSelected& isModuleSelected,
+			const std::string& errorIfNotCorrectFormat) const;
+
+		// Read the coverage rate of each module and file from the table of contents,
+		// without reading the lines. Files without table of contents are fully read.
+		CoverageDataSummary DeserializeSummary(const boost::filesystem::path&, const std::string& errorIfNotCorrectFormat) const;
 		
 	private:
 		CoverageDataDeserializer(const CoverageDataDeserializer&) = delete;
 		CoverageDataDeserializer& operator=(const CoverageDataDeserializer&) = delete;
+
+		size_t maxThreadCount_;
 	};
 }
-
@@ -0,0 +1,480 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataFormatV2.hpp"
+
+#include <fstream>
+#include <zlib.h>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+namespace io = google::protobuf::io;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		unsigned int ReadVarint32(io::CodedInputStream& input)
+		{
+			unsigned int value = 0;
+
+			if (!input.ReadVarint32(&value))
+				THROW(L"Cannot read value.");
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteString(const std::string& str, io::CodedOutputStream& output)
+		{
+			output.WriteVarint32(static_cast<unsigned int>(str.size()));
+			output.WriteString(str);
+		}
+
+		//---------------------------------------------------------------------
+		std::string ReadString(io::CodedInputStream& input)
+		{
+			std::string str;
+
+			if (!input.ReadString(&str, ReadVarint32(input)))
+				THROW(L"Cannot read string.");
+			return str;
+		}
+
+		//---------------------------------------------------------------------
+		// Return false when trailer is not a valid table of contents trailer.
+		bool DecodeTrailer(
+			const char* trailer,
+			google::protobuf::uint64 fileSize,
+			google::protobuf::uint64& offset,
+			google::protobuf::uint32& entryCount,
+			bool& hasFileSummaries)
+		{
+			io::CodedInputStream input{
+				reinterpret_cast<const google::protobuf::uint8*>(trailer), TableOfContentsTrailerSize };
+			google::protobuf::uint32 magic;
+
+			input.ReadLittleEndian64(&offset);
+			input.ReadLittleEndian32(&entryCount);
+			input.ReadLittleEndian32(&magic);
+			hasFileSummaries = magic == TableOfContentsWithFilesMagic;
+
+			if (magic != TableOfContentsMagic && !hasFileSummaries)
+				return false;
+
+			auto tableSize = fileSize - TableOfContentsTrailerSize;
+			auto minTableSize = static_cast<google::protobuf::uint64>(entryCount) * TableOfContentsEntrySize;
+
+			if (offset > tableSize)
+				return false;
+			tableSize -= offset;
+			return hasFileSummaries ? tableSize >= minTableSize : tableSize == minTableSize;
+		}
+
+		//---------------------------------------------------------------------
+		void DecodeEntries(
+			const char* table,
+			google::protobuf::uint64 tableSize,
+			google::protobuf::uint32 entryCount,
+			TableOfContents& tableOfContents)
+		{
+			io::CodedInputStream input{
+				reinterpret_cast<const google::protobuf::uint8*>(table), static_cast<int>(tableSize) };
+			auto& entries = tableOfContents.entries;
+
+			entries.resize(entryCount);
+			for (auto& entry : entries)
+			{
+				input.ReadLittleEndian64(&entry.offset);
+				input.ReadLittleEndian64(&entry.size);
+				input.ReadLittleEndian32(&entry.pathIndex);
+				input.ReadLittleEndian32(&entry.fileCount);
+				input.ReadLittleEndian32(&entry.executedLinesCount);
+				input.ReadLittleEndian32(&entry.unexecutedLinesCount);
+
+				if (!tableOfContents.hasFileSummaries)
+					continue;
+				if (entry.fileCount > (tableSize - input.CurrentPosition()) / FileSummaryEntrySize)
+					THROW(L"Invalid table of contents.");
+				entry.files.resize(entry.fileCount);
+				for (auto& file : entry.files)
+				{
+					input.ReadLittleEndian32(&file.pathIndex);
+					input.ReadLittleEndian32(&file.executedLinesCount);
+					input.ReadLittleEndian32(&file.unexecutedLinesCount);
+				}
+			}
+			if (static_cast<google::protobuf::uint64>(input.CurrentPosition()) != tableSize)
+				THROW(L"Invalid table of contents.");
+		}
+
+		//---------------------------------------------------------------------
+		// Each line takes at least one byte in a block.
+		void CheckCount(unsigned int count, const io::CodedInputStream& input, size_t blockSize)
+		{
+			if (count > blockSize - input.CurrentPosition())
+				THROW(L"Invalid module block.");
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int PathTable::Add(const fs::path& path)
+	{
+		auto result = indexes_.emplace(path.wstring(), static_cast<unsigned int>(paths_.size()));
+
+		if (result.second)
+			paths_.push_back(path);
+		return result.first->second;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int PathTable::GetIndex(const fs::path& path) const
+	{
+		auto it = indexes_.find(path.wstring());
+
+		if (it == indexes_.end())
+			THROW(L"Cannot find path " + path.wstring());
+		return it->second;
+	}
+
+	//-------------------------------------------------------------------------
+	const fs::path& PathTable::GetPath(unsigned int index) const
+	{
+		if (index >= paths_.size())
+			THROW(L"Invalid path index.");
+		return paths_[index];
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<fs::path>& PathTable::GetPaths() const
+	{
+		return paths_;
+	}
+
+	//-------------------------------------------------------------------------
+	void PathTable::Write(io::CodedOutputStream& output) const
+	{
+		output.WriteVarint32(static_cast<unsigned int>(paths_.size()));
+		for (const auto& path : paths_)
+			WriteString(Tools::ToUtf8String(path.wstring()), output);
+	}
+
+	//-------------------------------------------------------------------------
+	void PathTable::Read(io::CodedInputStream& input)
+	{
+		auto pathCount = ReadVarint32(input);
+
+		for (unsigned int i = 0; i < pathCount; ++i)
+			Add(Tools::Utf8ToWString(ReadString(input)));
+	}
+
+	//-------------------------------------------------------------------------
+	void WriteHeaderV2(
+		const CoverageDataHeaderV2& header,
+		io::CodedOutputStream& output)
+	{
+		WriteString(header.name, output);
+		output.WriteLittleEndian32(static_cast<google::protobuf::uint32>(header.exitCode));
+		output.WriteVarint32(static_cast<unsigned int>(header.compression));
+		output.WriteVarint64(header.moduleCount);
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataHeaderV2 ReadHeaderV2(io::CodedInputStream& input)
+	{
+		CoverageDataHeaderV2 header;
+		google::protobuf::uint32 exitCode;
+
+		header.name = ReadString(input);
+		if (!input.ReadLittleEndian32(&exitCode))
+			THROW(L"Cannot read exit code.");
+		header.exitCode = static_cast<int>(exitCode);
+
+		auto compression = ReadVarint32(input);
+		if (compression > static_cast<unsigned int>(BlockCompression::Deflate))
+			THROW(L"Unknown block compression.");
+		header.compression = static_cast<BlockCompression>(compression);
+
+		if (!input.ReadVarint64(&header.moduleCount))
+			THROW(L"Cannot read module count.");
+		return header;
+	}
+
+	//-------------------------------------------------------------------------
+	std::string EncodeModuleV2(
+		const fs::path& modulePath,
+		const std::vector<const cov::FileCoverage*>& files,
+		const PathTable& pathTable)
+	{
+		std::string block;
+		{
+			io::StringOutputStream blockStream(&block);
+			io::CodedOutputStream output(&blockStream);
+			std::string executedLines;
+
+			output.WriteVarint32(pathTable.GetIndex(modulePath));
+			output.WriteVarint32(static_cast<unsigned int>(files.size()));
+			for (const auto* file : files)
+			{
+				const auto& lines = file->GetLines();
+
+				output.WriteVarint32(pathTable.GetIndex(file->GetPath()));
+				output.WriteVarint32(static_cast<unsigned int>(lines.size()));
+
+				executedLines.assign((lines.size() + 7) / 8, '\0');
+				for (size_t i = 0; i < lines.size(); ++i)
+				{
+					if (lines[i].HasBeenExecuted())
+						executedLines[i / 8] |= static_cast<char>(1 << (i % 8));
+				}
+				output.WriteString(executedLines);
+
+				// Lines are sorted so deltas are small.
+				unsigned int previousLineNumber = 0;
+				for (const auto& line : lines)
+				{
+					output.WriteVarint32(line.GetLineNumber() - previousLineNumber);
+					previousLineNumber = line.GetLineNumber();
+				}
+			}
+		}
+
+		return block;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int DecodeModulePathIndexV2(const std::string& block)
+	{
+		io::CodedInputStream input{
+			reinterpret_cast<const google::protobuf::uint8*>(block.data()),
+			static_cast<int>(block.size()) };
+
+		return ReadVarint32(input);
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<cov::ModuleCoverage> DecodeModuleV2(
+		const std::string& block,
+		const T_GetPath& getPath)
+	{
+		io::CodedInputStream input{
+			reinterpret_cast<const google::protobuf::uint8*>(block.data()),
+			static_cast<int>(block.size()) };
+		auto module = std::make_unique<cov::ModuleCoverage>(getPath(ReadVarint32(input)));
+		auto fileCount = ReadVarint32(input);
+		std::string executedLines;
+
+		CheckCount(fileCount, input, block.size());
+		module->ReserveFiles(fileCount);
+		for (unsigned int fileIndex = 0; fileIndex < fileCount; ++fileIndex)
+		{
+			auto& file = module->AddFile(getPath(ReadVarint32(input)));
+			auto lineCount = ReadVarint32(input);
+
+			CheckCount(lineCount, input, block.size());
+			if (!input.ReadString(&executedLines, (lineCount + 7) / 8))
+				THROW(L"Invalid module block.");
+
+			std::vector<cov::LineCoverage> lines;
+			unsigned int lineNumber = 0;
+
+			lines.reserve(lineCount);
+			for (unsigned int i = 0; i < lineCount; ++i)
+			{
+				lineNumber += ReadVarint32(input);
+				lines.emplace_back(lineNumber, ((executedLines[i / 8] >> (i % 8)) & 1) != 0);
+			}
+			file.AddLines(std::move(lines));
+		}
+
+		return module;
+	}
+
+	//-------------------------------------------------------------------------
+	TableOfContentsEntry WriteModuleV2(
+		const fs::path& modulePath,
+		const std::vector<const cov::FileCoverage*>& files,
+		const PathTable& pathTable,
+		BlockCompression compression,
+		io::ZeroCopyOutputStream& output)
+	{
+		TableOfContentsEntry entry{};
+		cov::CoverageRate coverageRate;
+
+		entry.offset = output.ByteCount();
+		{
+			io::CodedOutputStream codedOutput(&output);
+			WriteBlock(EncodeModuleV2(modulePath, files, pathTable), compression, codedOutput);
+		}
+		entry.size = output.ByteCount() - entry.offset;
+
+		entry.files.reserve(files.size());
+		for (const auto* file : files)
+		{
+			const auto& fileCoverageRate = file->GetCoverageRate();
+
+			coverageRate += fileCoverageRate;
+			entry.files.push_back(FileSummaryEntry{
+				pathTable.GetIndex(file->GetPath()),
+				static_cast<unsigned int>(fileCoverageRate.GetExecutedLinesCount()),
+				static_cast<unsigned int>(fileCoverageRate.GetUnExecutedLinesCount()) });
+		}
+		entry.pathIndex = pathTable.GetIndex(modulePath);
+		entry.fileCount = static_cast<unsigned int>(files.size());
+		entry.executedLinesCount = coverageRate.GetExecutedLinesCount();
+		entry.unexecutedLinesCount = coverageRate.GetUnExecutedLinesCount();
+
+		return entry;
+	}
+
+	//-------------------------------------------------------------------------
+	void WriteTableOfContents(
+		const std::vector<TableOfContentsEntry>& entries,
+		io::ZeroCopyOutputStream& output)
+	{
+		google::protobuf::uint64 offset = output.ByteCount();
+		io::CodedOutputStream codedOutput(&output);
+
+		for (const auto& entry : entries)
+		{
+			codedOutput.WriteLittleEndian64(entry.offset);
+			codedOutput.WriteLittleEndian64(entry.size);
+			codedOutput.WriteLittleEndian32(entry.pathIndex);
+			codedOutput.WriteLittleEndian32(entry.fileCount);
+			codedOutput.WriteLittleEndian32(entry.executedLinesCount);
+			codedOutput.WriteLittleEndian32(entry.unexecutedLinesCount);
+			for (const auto& file : entry.files)
+			{
+				codedOutput.WriteLittleEndian32(file.pathIndex);
+				codedOutput.WriteLittleEndian32(file.executedLinesCount);
+				codedOutput.WriteLittleEndian32(file.unexecutedLinesCount);
+			}
+		}
+		codedOutput.WriteLittleEndian64(offset);
+		codedOutput.WriteLittleEndian32(static_cast<google::protobuf::uint32>(entries.size()));
+		codedOutput.WriteLittleEndian32(TableOfContentsWithFilesMagic);
+	}
+
+	//-------------------------------------------------------------------------
+	bool ReadTableOfContents(
+		const fs::path& path,
+		TableOfContents& tableOfContents)
+	{
+		std::ifstream ifs(path.string(), std::ios::binary | std::ios::ate);
+		std::string trailer(TableOfContentsTrailerSize, '\0');
+
+		if (!ifs)
+			THROW(L"Cannot open file " + path.wstring());
+		google::protobuf::uint64 fileSize = ifs.tellg();
+		google::protobuf::uint64 offset;
+		google::protobuf::uint32 entryCount;
+
+		if (fileSize < TableOfContentsTrailerSize ||
+			!ifs.seekg(fileSize - TableOfContentsTrailerSize) ||
+			!ifs.read(&trailer[0], TableOfContentsTrailerSize) ||
+			!DecodeTrailer(trailer.data(), fileSize, offset, entryCount, tableOfContents.hasFileSummaries))
+		{
+			return false;
+		}
+
+		std::string table(static_cast<size_t>(fileSize - TableOfContentsTrailerSize - offset), '\0');
+		if (!ifs.seekg(offset) || !ifs.read(&table[0], table.size()))
+			THROW(L"Cannot read table of contents from " + path.wstring());
+		DecodeEntries(table.data(), table.size(), entryCount, tableOfContents);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool ParseTableOfContents(
+		const char* data,
+		google::protobuf::uint64 size,
+		TableOfContents& tableOfContents)
+	{
+		google::protobuf::uint64 offset;
+		google::protobuf::uint32 entryCount;
+
+		if (size < TableOfContentsTrailerSize ||
+			!DecodeTrailer(data + size - TableOfContentsTrailerSize, size, offset, entryCount, tableOfContents.hasFileSummaries))
+		{
+			return false;
+		}
+		DecodeEntries(data + offset, size - TableOfContentsTrailerSize - offset, entryCount, tableOfContents);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void WriteBlock(
+		const std::string& block,
+		BlockCompression compression,
+		io::CodedOutputStream& output)
+	{
+		auto blockSize = static_cast<uLong>(block.size());
+
+		output.WriteVarint32(blockSize);
+		if (compression == BlockCompression::None)
+		{
+			WriteString(block, output);
+			return;
+		}
+
+		auto storedSize = compressBound(blockSize);
+		std::string storedBlock(storedSize, '\0');
+
+		// Favor speed over ratio: coverage files are written after each run.
+		if (compress2(reinterpret_cast<Bytef*>(&storedBlock[0]), &storedSize,
+			reinterpret_cast<const Bytef*>(block.data()), blockSize, Z_BEST_SPEED) != Z_OK)
+		{
+			THROW(L"Cannot compress module block.");
+		}
+		storedBlock.resize(storedSize);
+		WriteString(storedBlock, output);
+	}
+
+	//-------------------------------------------------------------------------
+	std::string DecompressBlock(
+		const char* storedBlock,
+		size_t storedSize,
+		unsigned int blockSize)
+	{
+		// Deflate cannot compress more than 1032:1.
+		if (blockSize / 1032 > storedSize)
+			THROW(L"Invalid module block.");
+
+		std::string block(blockSize, '\0');
+		uLongf size = blockSize;
+
+		if (uncompress(reinterpret_cast<Bytef*>(&block[0]), &size,
+			reinterpret_cast<const Bytef*>(storedBlock),
+			static_cast<uLong>(storedSize)) != Z_OK || size != blockSize)
+		{
+			THROW(L"Cannot decompress module block.");
+		}
+		return block;
+	}
+}
@@ -0,0 +1,175 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <boost/filesystem/path.hpp>
+
+#include "ProtoBuff.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+	class ModuleCoverage;
+	class FileCoverage;
+}
+
+namespace Exporter
+{
+	// Version 2 of the binary format:
+	//   varint FileTypeIdV2
+	//   header: name, exit code, block compression and module count
+	//   path table: all module and file paths, written once
+	//   module blocks: varint raw size, varint stored size and stored bytes
+	//   table of contents: one fixed size entry for each module followed by
+	//     the coverage rate of its files
+	//   trailer: fixed64 offset of the table of contents, fixed32 entry count
+	//     and fixed32 TableOfContentsWithFilesMagic
+	// Files with TableOfContentsMagic have no file summary in the table of contents.
+	// A raw module block contains the index of the module path, the file count
+	// and for each file: the index of its path, the line count, a bitmap of
+	// the executed lines and the delta-encoded line numbers.
+	enum class BlockCompression
+	{
+		None = 0,
+		Deflate = 1
+	};
+
+	//-------------------------------------------------------------------------
+	class PathTable
+	{
+	public:
+		PathTable() = default;
+		PathTable(PathTable&&) = default;
+
+		unsigned int Add(const boost::filesystem::path&);
+		unsigned int GetIndex(const boost::filesystem::path&) const;
+		const boost::filesystem::path& GetPath(unsigned int index) const;
+		const std::vector<boost::filesystem::path>& GetPaths() const;
+
+		void Write(google::protobuf::io::CodedOutputStream&) const;
+		void Read(google::protobuf::io::CodedInputStream&);
+
+	private:
+		PathTable(const PathTable&) = delete;
+		PathTable& operator=(const PathTable&) = delete;
+
+		std::vector<boost::filesystem::path> paths_;
+		std::unordered_map<std::wstring, unsigned int> indexes_;
+	};
+
+	//-------------------------------------------------------------------------
+	struct CoverageDataHeaderV2
+	{
+		std::string name;
+		int exitCode;
+		BlockCompression compression;
+		google::protobuf::uint64 moduleCount;
+	};
+
+	//-------------------------------------------------------------------------
+	struct FileSummaryEntry
+	{
+		unsigned int pathIndex;
+		unsigned int executedLinesCount;
+		unsigned int unexecutedLinesCount;
+	};
+
+	//-------------------------------------------------------------------------
+	// Location and coverage rate of a module block.
+	struct TableOfContentsEntry
+	{
+		google::protobuf::uint64 offset;
+		google::protobuf::uint64 size;
+		unsigned int pathIndex;
+		unsigned int fileCount;
+		unsigned int executedLinesCount;
+		unsigned int unexecutedLinesCount;
+		std::vector<FileSummaryEntry> files;
+	};
+
+	//-------------------------------------------------------------------------
+	struct TableOfContents
+	{
+		std::vector<TableOfContentsEntry> entries;
+		bool hasFileSummaries;
+	};
+
+	const int TableOfContentsEntrySize = 32;
+	const int FileSummaryEntrySize = 12;
+	const int TableOfContentsTrailerSize = 16;
+	const unsigned int TableOfContentsMagic = 0x434F5443; // "CTOC"
+	const unsigned int TableOfContentsWithFilesMagic = 0x464F5443; // "CTOF"
+
+	typedef std::function<const boost::filesystem::path& (unsigned int)> T_GetPath;
+
+	void WriteHeaderV2(
+		const CoverageDataHeaderV2& header,
+		google::protobuf::io::CodedOutputStream& output);
+
+	CoverageDataHeaderV2 ReadHeaderV2(google::protobuf::io::CodedInputStream& input);
+
+	std::string EncodeModuleV2(
+		const boost::filesystem::path& modulePath,
+		const std::vector<const CppCoverage::FileCoverage*>& files,
+		const PathTable& pathTable);
+
+	std::unique_ptr<CppCoverage::ModuleCoverage> DecodeModuleV2(
+		const std::string& block,
+		const T_GetPath& getPath);
+
+	// Only decode the path index of the module, files are skipped.
+	unsigned int DecodeModulePathIndexV2(const std::string& block);
+
+	// Encode and write a module block with its own coded stream so offsets
+	// are not limited to 2 GB.
+	TableOfContentsEntry WriteModuleV2(
+		const boost::filesystem::path& modulePath,
+		const std::vector<const CppCoverage::FileCoverage*>& files,
+		const PathTable& pathTable,
+		BlockCompression compression,
+		google::protobuf::io::ZeroCopyOutputStream& output);
+
+	void WriteTableOfContents(
+		const std::vector<TableOfContentsEntry>& entries,
+		google::protobuf::io::ZeroCopyOutputStream& output);
+
+	// Return false when the file has no table of contents.
+	bool ReadTableOfContents(
+		const boost::filesystem::path& path,
+		TableOfContents& tableOfContents);
+
+	// Same as ReadTableOfContents for a file already in memory.
+	bool ParseTableOfContents(
+		const char* data,
+		google::protobuf::uint64 size,
+		TableOfContents& tableOfContents);
+
+	void WriteBlock(
+		const std::string& block,
+		BlockCompression compression,
+		google::protobuf::io::CodedOutputStream& output);
+
+	std::string DecompressBlock(
+		const char* storedBlock,
+		size_t storedSize,
+		unsigned int blockSize);
+}
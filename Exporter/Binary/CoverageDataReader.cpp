@@ -0,0 +1,234 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataReader.hpp"
+
+#include "CoverageData.pb.h"
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "CoverageDataSerializer.hpp"
+#include "ProtoBuffTools.hpp"
+
+namespace pb = ProtoBuff;
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+namespace io = google::protobuf::io;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		ModulePayload ReadModulePayloadFrom(
+			io::CodedInputStream& input,
+			const CoverageDataFileFormat& format)
+		{
+			ModulePayload payload{ {}, 0 };
+			unsigned int size = 0;
+
+			if (format.fileTypeId == CoverageDataSerializer::FileTypeIdV2 && !input.ReadVarint32(&payload.blockSize))
+				THROW(L"Cannot read module block size.");
+			if (!input.ReadVarint32(&size) || !input.ReadString(&payload.bytes, size))
+				THROW(L"Cannot read module.");
+			return payload;
+		}
+
+		//---------------------------------------------------------------------
+		std::unique_ptr<cov::ModuleCoverage> DecodeModulePayload(
+			const ModulePayload& payload,
+			const CoverageDataFileFormat& format,
+			const T_GetPath& getPath)
+		{
+			if (format.fileTypeId == CoverageDataSerializer::FileTypeIdV2)
+			{
+				if (format.compression == BlockCompression::Deflate)
+				{
+					auto block = DecompressBlock(payload.bytes.data(), payload.bytes.size(), payload.blockSize);
+					return DecodeModuleV2(block, getPath);
+				}
+				if (payload.bytes.size() != payload.blockSize)
+					THROW(L"Invalid module block.");
+				return DecodeModuleV2(payload.bytes, getPath);
+			}
+
+			pb::ModuleCoverage moduleProtoBuff;
+			if (!moduleProtoBuff.ParseFromString(payload.bytes))
+				THROW(L"Cannot parse message.");
+			return CreateModuleFrom(moduleProtoBuff);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataReader::CoverageDataReader(
+		const fs::path& path,
+		const std::string& errorIfNotCorrectFormat)
+		: path_{ path }
+		, ifs_{ path.string(), std::ios::binary }
+		, inputStream_{ &ifs_ }
+	{
+		if (!ifs_)
+			THROW(L"Cannot open file " + path.wstring());
+
+		io::CodedInputStream input(&inputStream_);
+		unsigned int fileTypeId;
+
+		if (!input.ReadVarint32(&fileTypeId) ||
+			(fileTypeId != CoverageDataSerializer::FileTypeId && fileTypeId != CoverageDataSerializer::FileTypeIdV2))
+		{
+			throw std::runtime_error(errorIfNotCorrectFormat);
+		}
+
+		if (fileTypeId == CoverageDataSerializer::FileTypeIdV2)
+		{
+			header_ = ReadHeaderV2(input);
+			pathTable_.Read(input);
+		}
+		else
+		{
+			pb::CoverageData coverageDataProtoBuff;
+
+			ReadMessage(input, coverageDataProtoBuff);
+			header_ = CoverageDataHeaderV2{
+				coverageDataProtoBuff.name(),
+				coverageDataProtoBuff.exitcode(),
+				BlockCompression::None,
+				coverageDataProtoBuff.modulecount() };
+		}
+
+		// Each module takes at least one byte: an invalid count must not be
+		// used to reserve memory.
+		if (header_.moduleCount > fs::file_size(path))
+			throw std::runtime_error(errorIfNotCorrectFormat);
+		format_ = CoverageDataFileFormat{ fileTypeId, header_.compression };
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string& CoverageDataReader::GetName() const
+	{
+		return header_.name;
+	}
+
+	//-------------------------------------------------------------------------
+	int CoverageDataReader::GetExitCode() const
+	{
+		return header_.exitCode;
+	}
+
+	//-------------------------------------------------------------------------
+	google::protobuf::uint64 CoverageDataReader::GetModuleCount() const
+	{
+		return header_.moduleCount;
+	}
+
+	//-------------------------------------------------------------------------
+	const CoverageDataFileFormat& CoverageDataReader::GetFormat() const
+	{
+		return format_;
+	}
+
+	//-------------------------------------------------------------------------
+	const PathTable& CoverageDataReader::GetPathTable() const
+	{
+		return pathTable_;
+	}
+
+	//-------------------------------------------------------------------------
+	google::protobuf::int64 CoverageDataReader::GetPosition() const
+	{
+		return inputStream_.ByteCount();
+	}
+
+	//-------------------------------------------------------------------------
+	cov::ModuleCoverage& CoverageDataReader::ReadModule(cov::CoverageData& coverageData)
+	{
+		return coverageData.AddModule(DecodeModule(ReadModulePayload()));
+	}
+
+	//-------------------------------------------------------------------------
+	ModulePayload CoverageDataReader::ReadModulePayload()
+	{
+		// A new coded stream for each module avoids protobuf's total bytes limit.
+		io::CodedInputStream input(&inputStream_);
+
+		return ReadModulePayloadFrom(input, format_);
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<cov::ModuleCoverage> CoverageDataReader::DecodeModule(const ModulePayload& payload) const
+	{
+		return DecodeModulePayload(payload, format_, [this](unsigned int index) -> const fs::path&
+		{
+			return pathTable_.GetPath(index);
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path CoverageDataReader::DecodeModulePath(const ModulePayload& payload) const
+	{
+		if (format_.fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+			return DecodeModule(payload)->GetPath();
+
+		if (format_.compression == BlockCompression::Deflate)
+		{
+			auto block = DecompressBlock(payload.bytes.data(), payload.bytes.size(), payload.blockSize);
+			return pathTable_.GetPath(DecodeModulePathIndexV2(block));
+		}
+		return pathTable_.GetPath(DecodeModulePathIndexV2(payload.bytes));
+	}
+
+	//-------------------------------------------------------------------------
+	cov::ModuleCoverage& CoverageDataReader::ReadModuleAt(
+		google::protobuf::int64 position,
+		cov::CoverageData& coverageData) const
+	{
+		return Exporter::ReadModuleAt(path_, position, format_, [this](unsigned int index) -> const fs::path&
+		{
+			return pathTable_.GetPath(index);
+		}, coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageDataReader::ReadTableOfContents(TableOfContents& tableOfContents) const
+	{
+		if (format_.fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+			return false;
+		return Exporter::ReadTableOfContents(path_, tableOfContents);
+	}
+
+	//-------------------------------------------------------------------------
+	cov::ModuleCoverage& ReadModuleAt(
+		const fs::path& path,
+		google::protobuf::int64 position,
+		const CoverageDataFileFormat& format,
+		const T_GetPath& getPath,
+		cov::CoverageData& coverageData)
+	{
+		std::ifstream ifs(path.string(), std::ios::binary);
+
+		if (!ifs || !ifs.seekg(position))
+			THROW(L"Cannot read module from " + path.wstring());
+
+		io::IstreamInputStream inputStream(&ifs);
+		io::CodedInputStream input(&inputStream);
+
+		return coverageData.AddModule(DecodeModulePayload(ReadModulePayloadFrom(input, format), format, getPath));
+	}
+}
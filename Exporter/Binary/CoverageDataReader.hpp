@@ -0,0 +1,105 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "ProtoBuff.hpp"
+#include "CoverageDataFormatV2.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+	class ModuleCoverage;
+}
+
+namespace Exporter
+{
+	//-------------------------------------------------------------------------
+	struct CoverageDataFileFormat
+	{
+		unsigned int fileTypeId;
+		BlockCompression compression;
+	};
+
+	//-------------------------------------------------------------------------
+	// Bytes of a module as stored in the file. blockSize is the size of
+	// a version 2 block once decompressed.
+	struct ModulePayload
+	{
+		std::string bytes;
+		unsigned int blockSize;
+	};
+
+	// Read the modules of a binary coverage file one at a time.
+	// Both versions of the binary format are supported.
+	class CoverageDataReader
+	{
+	public:
+		CoverageDataReader(
+			const boost::filesystem::path&,
+			const std::string& errorIfNotCorrectFormat);
+
+		const std::string& GetName() const;
+		int GetExitCode() const;
+		google::protobuf::uint64 GetModuleCount() const;
+		const CoverageDataFileFormat& GetFormat() const;
+
+		// Always empty for the version 1.
+		const PathTable& GetPathTable() const;
+
+		// Position of the next module in the file.
+		google::protobuf::int64 GetPosition() const;
+
+		CppCoverage::ModuleCoverage& ReadModule(CppCoverage::CoverageData&);
+
+		// Split ReadModule so payloads can be decoded on several threads:
+		// DecodeModule does not use the file.
+		ModulePayload ReadModulePayload();
+		std::unique_ptr<CppCoverage::ModuleCoverage> DecodeModule(const ModulePayload&) const;
+
+		// Faster than DecodeModule for the version 2: lines are not decoded.
+		boost::filesystem::path DecodeModulePath(const ModulePayload&) const;
+		CppCoverage::ModuleCoverage& ReadModuleAt(google::protobuf::int64 position, CppCoverage::CoverageData&) const;
+
+		// Return false when the file has no table of contents.
+		bool ReadTableOfContents(TableOfContents&) const;
+
+	private:
+		CoverageDataReader(const CoverageDataReader&) = delete;
+		CoverageDataReader& operator=(const CoverageDataReader&) = delete;
+
+		boost::filesystem::path path_;
+		std::ifstream ifs_;
+		google::protobuf::io::IstreamInputStream inputStream_;
+		CoverageDataFileFormat format_;
+		CoverageDataHeaderV2 header_;
+		PathTable pathTable_;
+	};
+
+	// Read the module at a position returned by CoverageDataReader::GetPosition.
+	// getPath resolves the path indexes of the version 2.
+	CppCoverage::ModuleCoverage& ReadModuleAt(
+		const boost::filesystem::path&,
+		google::protobuf::int64 position,
+		const CoverageDataFileFormat&,
+		const T_GetPath& getPath,
+		CppCoverage::CoverageData&);
+}
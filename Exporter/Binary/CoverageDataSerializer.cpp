@@ -22,13 +22,13 @@
 #include "CppCoverage/CoverageData.hpp"
 #include "CppCoverage/ModuleCoverage.hpp"
 #include "CppCoverage/FileCoverage.hpp"
-#include "CppCoverage/LineCoverage.hpp"
 
 #include "../ExporterException.hpp"
 
 #include "Tools/Tool.hpp"
 
-#include "ProtoBuff.hpp"
+#include "ProtoBuffTools.hpp"
+#include "CoverageDataFormatV2.hpp"
 
 namespace pb = ProtoBuff;
 namespace cov = CppCoverage;
@@ -38,84 +38,108 @@ namespace Exporter
 	namespace
 	{
 		//---------------------------------------------------------------------
-		void InitializeProtoBuffFrom(
-			const cov::FileCoverage& file,
-			pb::FileCoverage& fileProtoBuff)
+		void FillCoverageDataProtoBuffFrom(
+			const cov::CoverageData& coverageData,
+			pb::CoverageData& coverageDataProtoBuff)
 		{
-			fileProtoBuff.set_path(Tools::ToUtf8String(file.GetPath().wstring()));
-
-			for (const auto& line : file.GetLines())
-			{
-				auto lineProtoBuff = fileProtoBuff.add_lines();
-				
-				lineProtoBuff->set_linenumber(line.GetLineNumber());
-				lineProtoBuff->set_hasbeenexecuted(line.HasBeenExecuted());
-			}
+			coverageDataProtoBuff.set_name(Tools::ToUtf8String(coverageData.GetName()));
+			coverageDataProtoBuff.set_exitcode(coverageData.GetExitCode());
+			coverageDataProtoBuff.set_modulecount(coverageData.GetModules().size());			
 		}
 
 		//---------------------------------------------------------------------
-		void InitializeModuleProtoBuffFrom(
-			const cov::ModuleCoverage& module,
-			pb::ModuleCoverage& moduleProtoBuff)
+		void SerializeV1(
+			const cov::CoverageData& coverageData,
+			google::protobuf::io::ZeroCopyOutputStream& outputStream)
 		{
-			moduleProtoBuff.set_path(Tools::ToUtf8String(module.GetPath().wstring()));
-			
-			for (const auto& file : module.GetFiles())
+			google::protobuf::io::CodedOutputStream output(&outputStream);
+			pb::CoverageData coverageDataProtoBuff;
+
+			output.WriteVarint32(CoverageDataSerializer::FileTypeId);
+
+			FillCoverageDataProtoBuffFrom(coverageData, coverageDataProtoBuff);
+			WriteMessage(coverageDataProtoBuff, output);
+
+			// Here we serialize manually modules because protobuff's limit.
+			// See https://developers.google.com/protocol-buffers/docs/techniques#large-data
+			for (const auto& module : coverageData.GetModules())
 			{
-				auto fileProtoBuff = moduleProtoBuff.add_files();
-				InitializeProtoBuffFrom(*file, *fileProtoBuff);
+				pb::ModuleCoverage moduleProtoBuff;
+				InitializeModuleProtoBuffFrom(*module, moduleProtoBuff);
+
+				WriteMessage(moduleProtoBuff, output);
 			}
 		}
 
 		//---------------------------------------------------------------------
-		void FillCoverageDataProtoBuffFrom(
+		void SerializeV2(
 			const cov::CoverageData& coverageData,
-			pb::CoverageData& coverageDataProtoBuff)
+			BlockCompression compression,
+			google::protobuf::io::ZeroCopyOutputStream& output)
 		{
-			coverageDataProtoBuff.set_name(Tools::ToUtf8String(coverageData.GetName()));
-			coverageDataProtoBuff.set_exitcode(coverageData.GetExitCode());
-			coverageDataProtoBuff.set_modulecount(coverageData.GetModules().size());			
-		}
+			const auto& modules = coverageData.GetModules();
+			PathTable pathTable;
 
-		//---------------------------------------------------------------------
-		void WriteMessage(
-			const google::protobuf::MessageLite& message, 
-			google::protobuf::io::CodedOutputStream& output)
-		{
-			output.WriteVarint32(message.ByteSize());
-			if (!message.SerializeToCodedStream(&output))
-				THROW(L"Cannot serialize message to stream");
+			for (const auto& module : modules)
+			{
+				pathTable.Add(module->GetPath());
+				for (const auto& file : module->GetFiles())
+					pathTable.Add(file->GetPath());
+			}
+
+			{
+				google::protobuf::io::CodedOutputStream codedOutput(&output);
+
+				codedOutput.WriteVarint32(CoverageDataSerializer::FileTypeIdV2);
+				WriteHeaderV2(CoverageDataHeaderV2{
+					Tools::ToUtf8String(coverageData.GetName()),
+					coverageData.GetExitCode(),
+					compression,
+					modules.size() }, codedOutput);
+				pathTable.Write(codedOutput);
+			}
+
+			std::vector<const cov::FileCoverage*> files;
+			std::vector<TableOfContentsEntry> entries;
+
+			entries.reserve(modules.size());
+			for (const auto& module : modules)
+			{
+				files.clear();
+				for (const auto& file : module->GetFiles())
+					files.push_back(file.get());
+				entries.push_back(WriteModuleV2(module->GetPath(), files, pathTable, compression, output));
+			}
+			WriteTableOfContents(entries, output);
 		}
 	}
 
 	//-------------------------------------------------------------------------
 	const unsigned int CoverageDataSerializer::FileTypeId = 1351727964; // random number
-	
+	const unsigned int CoverageDataSerializer::FileTypeIdV2 = 1351727965;
+
+	//-------------------------------------------------------------------------
+	CoverageDataSerializer::CoverageDataSerializer(BinaryFormat format)
+		: format_{ format }
+	{
+	}
+
 	//-------------------------------------------------------------------------
 	void CoverageDataSerializer::Serialize(
 		const cov::CoverageData& coverageData,
 		const boost::filesystem::path& output) const
 	{		
-		pb::CoverageData coverageDataProtoBuff;
 		Tools::CreateParentFolderIfNeeded(output);
 
 		std::ofstream ofs(output.string(), std::ios::binary);		
 		google::protobuf::io::OstreamOutputStream outputStream(&ofs);
-		google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
 
-		codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeId);
-
-		FillCoverageDataProtoBuffFrom(coverageData, coverageDataProtoBuff);
-		WriteMessage(coverageDataProtoBuff, codedOutputStream);
-				 			
-		// Here we serialize manually modules because protobuff's limit.
-		// See https://developers.google.com/protocol-buffers/docs/techniques#large-data
-		for (const auto& module : coverageData.GetModules())
+		if (format_ == BinaryFormat::V1)
+			SerializeV1(coverageData, outputStream);
+		else
 		{
-			pb::ModuleCoverage moduleProtoBuff;
-			InitializeModuleProtoBuffFrom(*module, moduleProtoBuff);
-
-			WriteMessage(moduleProtoBuff, codedOutputStream);
+			auto compression = (format_ == BinaryFormat::V2Compressed) ? BlockCompression::Deflate : BlockCompression::None;
+			SerializeV2(coverageData, compression, outputStream);
 		}
 	}
 }
@@ -33,18 +33,29 @@ namespace boost
 
 namespace Exporter
 {
+	enum class BinaryFormat
+	{
+		V1,				// One protobuf message per line.
+		V2,				// Path table, delta-encoded line numbers and executed line bitmaps.
+		V2Compressed	// V2 with deflate compressed module blocks.
+	};
+
 	class EXPORTER_DLL CoverageDataSerializer
 	{
 	public:
 		const static unsigned int FileTypeId;
+		const static unsigned int FileTypeIdV2;
 
-		CoverageDataSerializer() = default;
+		// V1 stays the default as older versions cannot read V2 files.
+		explicit CoverageDataSerializer(BinaryFormat format = BinaryFormat::V1);
 
 		void Serialize(const CppCoverage::CoverageData&, const boost::filesystem::path&) const;
 
 	private:
 		CoverageDataSerializer(const CoverageDataSerializer&) = delete;
 		CoverageDataSerializer& operator=(const CoverageDataSerializer&) = delete;
+
+		BinaryFormat format_;
 	};
 }
 
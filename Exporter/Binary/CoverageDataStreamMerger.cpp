@@ -0,0 +1,386 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataStreamMerger.hpp"
+
+#include <map>
+#include <set>
+#include <algorithm>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageDataMerger.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "CoverageDataSerializer.hpp"
+#include "CoverageDataReader.hpp"
+#include "CoverageDataView.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		// A module is located by its index when its input has a view, by its
+		// offset otherwise.
+		struct ModuleLocation
+		{
+			size_t inputIndex;
+			google::protobuf::int64 offset;
+			size_t moduleIndex;
+		};
+
+		//---------------------------------------------------------------------
+		// pathIndexes maps the path table of a version 2 input to the output one.
+		// Inputs with a table of contents are read from their mapped view.
+		struct InputFormat
+		{
+			CoverageDataFileFormat format;
+			std::vector<unsigned int> pathIndexes;
+			std::unique_ptr<CoverageDataView> view;
+		};
+
+		typedef std::map<fs::path, std::unique_ptr<cov::FileCoverage>> T_FileCoverageByPath;
+		typedef std::map<fs::path, std::set<const cov::FileCoverage*>> T_FilesByModule;
+
+		//---------------------------------------------------------------------
+		class Index
+		{
+		public:
+			Index()
+				: name_{}
+				, exitCode_{ 0 }
+			{
+			}
+
+			void SetName(const std::string& name) { name_ = name; }
+			void SetExitCode(int exitCode) { exitCode_ = exitCode; }
+			void AddInput(InputFormat&& input) 
+			{ 
+				inputs_.push_back(std::move(input));
+				remainingModuleCounts_.push_back(0);
+			}
+			void AddModule(const fs::path& path, const ModuleLocation& location) 
+			{ 
+				locations_[path].push_back(location);
+				++remainingModuleCounts_.at(location.inputIndex);
+			}
+
+			// The view of an input is released once all its modules are merged.
+			void OnModuleMerged(size_t inputIndex)
+			{
+				if (--remainingModuleCounts_.at(inputIndex) == 0)
+					inputs_.at(inputIndex).view.reset();
+			}
+
+			const std::string& GetName() const { return name_; }
+			int GetExitCode() const { return exitCode_; }
+			const InputFormat& GetInput(size_t inputIndex) const { return inputs_.at(inputIndex); }
+			const std::map<fs::path, std::vector<ModuleLocation>>& GetLocations() const { return locations_; }
+			PathTable& GetPathTable() { return pathTable_; }
+			const PathTable& GetPathTable() const { return pathTable_; }
+
+		private:
+			std::string name_;
+			int exitCode_;
+			std::vector<InputFormat> inputs_;
+			std::vector<size_t> remainingModuleCounts_;
+			std::map<fs::path, std::vector<ModuleLocation>> locations_;
+			PathTable pathTable_;
+		};
+
+		//---------------------------------------------------------------------
+		void AddFilesTo(
+			const cov::ModuleCoverage& module,
+			T_FileCoverageByPath& files,
+			std::set<const cov::FileCoverage*>* moduleFiles)
+		{
+			cov::CoverageDataMerger merger;
+
+			for (const auto& file : module.GetFiles())
+			{
+				auto& mergedFile = files[file->GetPath()];
+
+				if (!mergedFile)
+					mergedFile = std::make_unique<cov::FileCoverage>(file->GetPath());
+				merger.Merge(*file, *mergedFile);
+				if (moduleFiles)
+					moduleFiles->insert(mergedFile.get());
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Linear merge of the sorted lines of a file and of a file view.
+		std::vector<cov::LineCoverage> MergeLines(
+			const std::vector<cov::LineCoverage>& lines,
+			const FileCoverageView& fileView)
+		{
+			std::vector<cov::LineCoverage> output;
+			auto it = lines.begin();
+			auto itView = fileView.begin();
+			auto itViewEnd = fileView.end();
+
+			output.reserve(lines.size() + fileView.GetLineCount());
+			while (it != lines.end() && itView != itViewEnd)
+			{
+				auto lineNumber = it->GetLineNumber();
+				auto viewLineNumber = itView.GetLineNumber();
+
+				if (lineNumber < viewLineNumber)
+					output.push_back(*it++);
+				else if (viewLineNumber < lineNumber)
+				{
+					output.emplace_back(viewLineNumber, itView.HasBeenExecuted());
+					++itView;
+				}
+				else
+				{
+					output.emplace_back(lineNumber, it->HasBeenExecuted() || itView.HasBeenExecuted());
+					++it;
+					++itView;
+				}
+			}
+			output.insert(output.end(), it, lines.end());
+			for (; itView != itViewEnd; ++itView)
+				output.emplace_back(itView.GetLineNumber(), itView.HasBeenExecuted());
+
+			return output;
+		}
+
+		//---------------------------------------------------------------------
+		// Lines are read from the mapped input without decoding the module
+		// and merged directly with the lines already merged.
+		void AddFilesTo(
+			const ModuleCoverageView& module,
+			T_FileCoverageByPath& files,
+			std::set<const cov::FileCoverage*>* moduleFiles)
+		{
+			static const std::vector<cov::LineCoverage> noLines;
+
+			for (const auto& fileView : module.GetFiles())
+			{
+				auto& mergedFile = files[fileView.GetPath()];
+				cov::FileCoverage file{ fileView.GetPath() };
+
+				file.AddLines(MergeLines(mergedFile ? mergedFile->GetLines() : noLines, fileView));
+				// Files of moduleFiles are referenced by pointer: mergedFile is updated in place.
+				if (!mergedFile)
+					mergedFile = std::make_unique<cov::FileCoverage>(fileView.GetPath());
+				*mergedFile = file;
+				if (moduleFiles)
+					moduleFiles->insert(mergedFile.get());
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Read the header and the position of each module of an input.
+		// When aggregatedFiles is not null, module files are also merged in
+		// aggregatedFiles and filesByModule.
+		void IndexInput(
+			const fs::path& path,
+			size_t inputIndex,
+			Index& index,
+			T_FileCoverageByPath* aggregatedFiles,
+			T_FilesByModule& filesByModule)
+		{
+			CoverageDataReader reader{ path, "Cannot extract coverage data from " + path.string() };
+			auto& pathTable = index.GetPathTable();
+			InputFormat input{ reader.GetFormat(), {}, nullptr };
+
+			index.SetName(reader.GetName());
+			if (reader.GetExitCode())
+				index.SetExitCode(reader.GetExitCode());
+
+			for (const auto& inputPath : reader.GetPathTable().GetPaths())
+				input.pathIndexes.push_back(pathTable.Add(inputPath));
+
+			TableOfContents tableOfContents;
+
+			if (reader.ReadTableOfContents(tableOfContents))
+			{
+				auto view = std::make_unique<CoverageDataView>(path);
+				const auto& viewRef = *view;
+
+				// Aggregated files are merged now: the view is not needed after this function.
+				if (!aggregatedFiles)
+					input.view = std::move(view);
+				index.AddInput(std::move(input));
+				for (size_t i = 0; i < viewRef.GetModuleCount(); ++i)
+				{
+					index.AddModule(viewRef.GetModulePath(i), ModuleLocation{ inputIndex, 0, i });
+					if (aggregatedFiles)
+						AddFilesTo(viewRef.GetModule(i), *aggregatedFiles, &filesByModule[viewRef.GetModulePath(i)]);
+				}
+				return;
+			}
+			index.AddInput(std::move(input));
+
+			// All the paths of a version 2 input are in its path table: the
+			// lines of a module are only needed to aggregate the files.
+			auto isV2 = reader.GetFormat().fileTypeId == CoverageDataSerializer::FileTypeIdV2;
+
+			for (google::protobuf::uint64 i = 0; i < reader.GetModuleCount(); ++i)
+			{
+				ModuleLocation location{ inputIndex, reader.GetPosition(), 0 };
+
+				if (!aggregatedFiles && isV2)
+				{
+					index.AddModule(reader.DecodeModulePath(reader.ReadModulePayload()), location);
+					continue;
+				}
+
+				cov::CoverageData coverageData{ L"", 0 };
+				const auto& module = reader.ReadModule(coverageData);
+
+				index.AddModule(module.GetPath(), location);
+				pathTable.Add(module.GetPath());
+				for (const auto& file : module.GetFiles())
+					pathTable.Add(file->GetPath());
+				if (aggregatedFiles)
+					AddFilesTo(module, *aggregatedFiles, &filesByModule[module.GetPath()]);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddModuleFilesAt(
+			const fs::path& path,
+			const ModuleLocation& location,
+			const Index& index,
+			T_FileCoverageByPath& files)
+		{
+			const auto& input = index.GetInput(location.inputIndex);
+
+			if (input.view)
+			{
+				AddFilesTo(input.view->GetModule(location.moduleIndex), files, nullptr);
+				return;
+			}
+
+			const auto& pathTable = index.GetPathTable();
+			cov::CoverageData coverageData{ L"", 0 };
+
+			const auto& module = ReadModuleAt(path, location.offset, input.format, 
+				[&](unsigned int pathIndex) -> const fs::path&
+			{
+				if (pathIndex >= input.pathIndexes.size())
+					THROW(L"Invalid path index in " + path.wstring());
+				return pathTable.GetPath(input.pathIndexes[pathIndex]);
+			}, coverageData);
+			AddFilesTo(module, files, nullptr);
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<const cov::FileCoverage*> SortByPath(const std::set<const cov::FileCoverage*>& files)
+		{
+			std::vector<const cov::FileCoverage*> sortedFiles{ files.begin(), files.end() };
+
+			std::sort(sortedFiles.begin(), sortedFiles.end(), 
+				[](const cov::FileCoverage* file1, const cov::FileCoverage* file2)
+			{
+				return file1->GetPath() < file2->GetPath();
+			});
+
+			return sortedFiles;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataStreamMerger::CoverageDataStreamMerger(BinaryFormat format)
+		: format_{ format }
+	{
+		if (format_ == BinaryFormat::V1)
+			THROW(L"Streaming merge cannot write version 1 binary files.");
+	}
+
+	//-------------------------------------------------------------------------
+	int CoverageDataStreamMerger::Merge(
+		const std::vector<fs::path>& inputs,
+		const fs::path& output,
+		bool aggregateByFile) const
+	{
+		auto compression = (format_ == BinaryFormat::V2Compressed) ? BlockCompression::Deflate : BlockCompression::None;
+		Index index;
+		T_FileCoverageByPath aggregatedFiles;
+		T_FilesByModule filesByModule;
+
+		for (size_t i = 0; i < inputs.size(); ++i)
+			IndexInput(inputs[i], i, index, aggregateByFile ? &aggregatedFiles : nullptr, filesByModule);
+
+		Tools::CreateParentFolderIfNeeded(output);
+		std::ofstream ofs(output.string(), std::ios::binary);
+
+		if (!ofs)
+			THROW(L"Cannot open file " + output.wstring());
+		{
+			google::protobuf::io::OstreamOutputStream outputStream(&ofs);
+			const auto& locationsByModule = index.GetLocations();
+			const auto& pathTable = index.GetPathTable();
+			std::vector<TableOfContentsEntry> entries;
+
+			{
+				google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
+
+				codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeIdV2);
+				WriteHeaderV2(CoverageDataHeaderV2{
+					index.GetName(),
+					index.GetExitCode(),
+					compression,
+					locationsByModule.size() }, codedOutputStream);
+				pathTable.Write(codedOutputStream);
+			}
+
+			for (const auto& pair : locationsByModule)
+			{
+				const auto& modulePath = pair.first;
+				std::vector<const cov::FileCoverage*> moduleFiles;
+				T_FileCoverageByPath files;
+
+				if (aggregateByFile)
+				{
+					// Files are shared by all modules and already merged.
+					moduleFiles = SortByPath(filesByModule.at(modulePath));
+				}
+				else
+				{
+					// Only the instances of the current module are in memory.
+					for (const auto& location : pair.second)
+					{
+						AddModuleFilesAt(inputs.at(location.inputIndex), location, index, files);
+						index.OnModuleMerged(location.inputIndex);
+					}
+					for (const auto& file : files)
+						moduleFiles.push_back(file.second.get());
+				}
+				entries.push_back(WriteModuleV2(modulePath, moduleFiles, pathTable, compression, outputStream));
+			}
+			WriteTableOfContents(entries, outputStream);
+		}
+		// outputStream writes its buffer to ofs when it is destroyed.
+		if (!ofs.flush())
+			THROW(L"Cannot write file " + output.wstring());
+
+		return index.GetExitCode();
+	}
+}
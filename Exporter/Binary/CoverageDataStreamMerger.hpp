@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+#include "../ExporterExport.hpp"
+#include "CoverageDataSerializer.hpp"
+
+namespace boost
+{
+	namespace filesystem
+	{
+		class path;
+	}
+}
+
+namespace Exporter
+{
+	// Merge binary coverage files into a binary coverage file without loading
+	// all of them in memory. Inputs are indexed first, then modules are merged
+	// one at a time. When aggregating by file, only the merged files are kept.
+	// Inputs with a table of contents are mapped in memory with CoverageDataView
+	// and their lines are read without decoding the modules. A view is released
+	// once all its modules are merged.
+	// The output is written with one of the version 2 formats.
+	class EXPORTER_DLL CoverageDataStreamMerger
+	{
+	public:
+		explicit CoverageDataStreamMerger(BinaryFormat format = BinaryFormat::V2);
+
+		// Return the exit code of the merged coverage data.
+		int Merge(
+			const std::vector<boost::filesystem::path>& inputs,
+			const boost::filesystem::path& output,
+			bool aggregateByFile) const;
+
+	private:
+		CoverageDataStreamMerger(const CoverageDataStreamMerger&) = delete;
+		CoverageDataStreamMerger& operator=(const CoverageDataStreamMerger&) = delete;
+
+		BinaryFormat format_;
+	};
+}
@@ -0,0 +1,359 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataView.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "CoverageDataSerializer.hpp"
+#include "CoverageDataFormatV2.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+namespace io = google::protobuf::io;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		unsigned int ReadVarint32(io::CodedInputStream& input)
+		{
+			unsigned int value = 0;
+
+			if (!input.ReadVarint32(&value))
+				THROW(L"Invalid module block.");
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		// Bytes are checked by ParseFiles.
+		unsigned int DecodeVarint32(const unsigned char*& buffer)
+		{
+			unsigned int value = 0;
+			int shift = 0;
+			unsigned char byte;
+
+			do
+			{
+				byte = *buffer++;
+				if (shift < 32)
+					value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+				shift += 7;
+			} while (byte & 0x80);
+
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<FileCoverageView> ParseFiles(
+			const unsigned char* block,
+			unsigned int blockSize,
+			const std::vector<fs::path>& paths)
+		{
+			io::CodedInputStream input{ block, static_cast<int>(blockSize) };
+			std::vector<FileCoverageView> files;
+
+			ReadVarint32(input); // Module path index
+			auto fileCount = ReadVarint32(input);
+
+			files.reserve(std::min(fileCount, blockSize));
+			for (unsigned int i = 0; i < fileCount; ++i)
+			{
+				auto pathIndex = ReadVarint32(input);
+				auto lineCount = ReadVarint32(input);
+				const auto* executedLines = block + input.CurrentPosition();
+
+				if (pathIndex >= paths.size() || !input.Skip((lineCount + 7) / 8))
+					THROW(L"Invalid module block.");
+
+				const auto* lineNumberDeltas = block + input.CurrentPosition();
+				const auto* blockEnd = block + blockSize;
+				const auto* current = lineNumberDeltas;
+
+				// Line numbers are variable length: find where the next file starts.
+				for (unsigned int line = 0; line < lineCount; ++current)
+				{
+					if (current == blockEnd)
+						THROW(L"Invalid module block.");
+					if ((*current & 0x80) == 0)
+						++line;
+				}
+				input.Skip(static_cast<int>(current - lineNumberDeltas));
+				files.emplace_back(paths[pathIndex], lineCount, executedLines, lineNumberDeltas);
+			}
+
+			return files;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	LineCoverageIterator::LineCoverageIterator(
+		const unsigned char* executedLines,
+		const unsigned char* lineNumberDeltas,
+		unsigned int index,
+		unsigned int lineCount)
+		: executedLines_{ executedLines }
+		, nextLineNumberDelta_{ lineNumberDeltas }
+		, index_{ index }
+		, lineCount_{ lineCount }
+		, lineNumber_{ 0 }
+	{
+		if (index_ < lineCount_)
+			lineNumber_ = DecodeVarint32(nextLineNumberDelta_);
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int LineCoverageIterator::GetLineNumber() const
+	{
+		return lineNumber_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool LineCoverageIterator::HasBeenExecuted() const
+	{
+		return ((executedLines_[index_ / 8] >> (index_ % 8)) & 1) != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	const LineCoverageIterator& LineCoverageIterator::operator*() const
+	{
+		return *this;
+	}
+
+	//-------------------------------------------------------------------------
+	LineCoverageIterator& LineCoverageIterator::operator++()
+	{
+		if (++index_ < lineCount_)
+			lineNumber_ += DecodeVarint32(nextLineNumberDelta_);
+		return *this;
+	}
+
+	//-------------------------------------------------------------------------
+	bool LineCoverageIterator::operator!=(const LineCoverageIterator& other) const
+	{
+		return index_ != other.index_;
+	}
+
+	//-------------------------------------------------------------------------
+	FileCoverageView::FileCoverageView(
+		const fs::path& path,
+		unsigned int lineCount,
+		const unsigned char* executedLines,
+		const unsigned char* lineNumberDeltas)
+		: path_{ &path }
+		, lineCount_{ lineCount }
+		, executedLines_{ executedLines }
+		, lineNumberDeltas_{ lineNumberDeltas }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	const fs::path& FileCoverageView::GetPath() const
+	{
+		return *path_;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int FileCoverageView::GetLineCount() const
+	{
+		return lineCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	LineCoverageIterator FileCoverageView::begin() const
+	{
+		return LineCoverageIterator{ executedLines_, lineNumberDeltas_, 0, lineCount_ };
+	}
+
+	//-------------------------------------------------------------------------
+	LineCoverageIterator FileCoverageView::end() const
+	{
+		return LineCoverageIterator{ executedLines_, nullptr, lineCount_, lineCount_ };
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleCoverageView::ModuleCoverageView(
+		const fs::path& path,
+		const cov::CoverageRate& coverageRate,
+		std::vector<FileCoverageView>&& files,
+		std::shared_ptr<const std::string> decompressedBlock)
+		: path_{ &path }
+		, coverageRate_{ coverageRate }
+		, files_{ std::move(files) }
+		, decompressedBlock_{ decompressedBlock }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	const fs::path& ModuleCoverageView::GetPath() const
+	{
+		return *path_;
+	}
+
+	//-------------------------------------------------------------------------
+	const cov::CoverageRate& ModuleCoverageView::GetCoverageRate() const
+	{
+		return coverageRate_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<FileCoverageView>& ModuleCoverageView::GetFiles() const
+	{
+		return files_;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataView::CoverageDataView(const fs::path& path)
+		: exitCode_{ 0 }
+		, isCompressed_{ false }
+	{
+		if (!fs::exists(path) || fs::file_size(path) == 0)
+			THROW(L"Cannot map file " + path.wstring());
+		mappedFile_ = std::make_unique<boost::iostreams::mapped_file_source>(path.string());
+
+		const auto* data = mappedFile_->data();
+		google::protobuf::uint64 size = mappedFile_->size();
+		io::CodedInputStream input{
+			reinterpret_cast<const google::protobuf::uint8*>(data),
+			static_cast<int>(std::min<google::protobuf::uint64>(size, INT_MAX)) };
+		TableOfContents tableOfContents;
+		unsigned int fileTypeId;
+
+		if (!input.ReadVarint32(&fileTypeId) ||
+			fileTypeId != CoverageDataSerializer::FileTypeIdV2 ||
+			!ParseTableOfContents(data, size, tableOfContents))
+		{
+			THROW(L"Only binary coverage files with a table of contents can be mapped: " + path.wstring());
+		}
+
+		auto header = ReadHeaderV2(input);
+		PathTable pathTable;
+
+		pathTable.Read(input);
+		name_ = Tools::Utf8ToWString(header.name);
+		exitCode_ = header.exitCode;
+		isCompressed_ = header.compression == BlockCompression::Deflate;
+		paths_ = pathTable.GetPaths();
+
+		modules_.reserve(tableOfContents.entries.size());
+		for (const auto& entry : tableOfContents.entries)
+		{
+			if (entry.pathIndex >= paths_.size() || entry.offset + entry.size > size || entry.size > INT_MAX)
+				THROW(L"Invalid table of contents in " + path.wstring());
+			modules_.push_back(ModuleEntry{ entry.offset, entry.size, entry.pathIndex,
+				cov::CoverageRate{ static_cast<int>(entry.executedLinesCount), static_cast<int>(entry.unexecutedLinesCount) } });
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataView::~CoverageDataView()
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring& CoverageDataView::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	int CoverageDataView::GetExitCode() const
+	{
+		return exitCode_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CoverageDataView::GetModuleCount() const
+	{
+		return modules_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	const fs::path& CoverageDataView::GetModulePath(size_t moduleIndex) const
+	{
+		return paths_[modules_.at(moduleIndex).pathIndex];
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleCoverageView CoverageDataView::GetModule(size_t moduleIndex) const
+	{
+		const auto& module = modules_.at(moduleIndex);
+		const auto* blockData = reinterpret_cast<const unsigned char*>(mappedFile_->data() + module.offset);
+		io::CodedInputStream input{ blockData, static_cast<int>(module.size) };
+		auto blockSize = ReadVarint32(input);
+		auto storedSize = ReadVarint32(input);
+		const auto* block = blockData + input.CurrentPosition();
+		std::shared_ptr<const std::string> decompressedBlock;
+
+		if (storedSize > module.size - input.CurrentPosition())
+			THROW(L"Invalid module block.");
+		if (isCompressed_)
+		{
+			decompressedBlock = std::make_shared<const std::string>(
+				DecompressBlock(reinterpret_cast<const char*>(block), storedSize, blockSize));
+			block = reinterpret_cast<const unsigned char*>(decompressedBlock->data());
+		}
+		else if (storedSize != blockSize)
+			THROW(L"Invalid module block.");
+
+		return ModuleCoverageView{
+			paths_[module.pathIndex],
+			module.coverageRate,
+			ParseFiles(block, blockSize, paths_),
+			decompressedBlock };
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData CoverageDataView::ToCoverageData() const
+	{
+		cov::CoverageData coverageData{ name_, exitCode_ };
+
+		coverageData.ReserveModules(modules_.size());
+		for (size_t i = 0; i < modules_.size(); ++i)
+		{
+			auto moduleView = GetModule(i);
+			auto& module = coverageData.AddModule(moduleView.GetPath());
+
+			module.ReserveFiles(moduleView.GetFiles().size());
+			for (const auto& fileView : moduleView.GetFiles())
+			{
+				auto& file = module.AddFile(fileView.GetPath());
+				std::vector<cov::LineCoverage> lines;
+
+				lines.reserve(fileView.GetLineCount());
+				for (const auto& line : fileView)
+					lines.emplace_back(line.GetLineNumber(), line.HasBeenExecuted());
+				file.AddLines(std::move(lines));
+			}
+		}
+
+		return coverageData;
+	}
+}
@@ -0,0 +1,155 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "../ExporterExport.hpp"
+
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
+
+namespace CppCoverage
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	//-------------------------------------------------------------------------
+	// Decode the lines of a file directly from its module block.
+	class EXPORTER_DLL LineCoverageIterator
+	{
+	public:
+		LineCoverageIterator(
+			const unsigned char* executedLines,
+			const unsigned char* lineNumberDeltas,
+			unsigned int index,
+			unsigned int lineCount);
+
+		unsigned int GetLineNumber() const;
+		bool HasBeenExecuted() const;
+
+		const LineCoverageIterator& operator*() const;
+		LineCoverageIterator& operator++();
+		bool operator!=(const LineCoverageIterator&) const;
+
+	private:
+		const unsigned char* executedLines_;
+		const unsigned char* nextLineNumberDelta_;
+		unsigned int index_;
+		unsigned int lineCount_;
+		unsigned int lineNumber_;
+	};
+
+	//-------------------------------------------------------------------------
+	class EXPORTER_DLL FileCoverageView
+	{
+	public:
+		FileCoverageView(
+			const boost::filesystem::path& path,
+			unsigned int lineCount,
+			const unsigned char* executedLines,
+			const unsigned char* lineNumberDeltas);
+
+		const boost::filesystem::path& GetPath() const;
+		unsigned int GetLineCount() const;
+
+		LineCoverageIterator begin() const;
+		LineCoverageIterator end() const;
+
+	private:
+		const boost::filesystem::path* path_;
+		unsigned int lineCount_;
+		const unsigned char* executedLines_;
+		const unsigned char* lineNumberDeltas_;
+	};
+
+	//-------------------------------------------------------------------------
+	// Files reference the mapped file, or the decompressed block for
+	// compressed files. They are valid as long as the module view exists.
+	class EXPORTER_DLL ModuleCoverageView
+	{
+	public:
+		ModuleCoverageView(
+			const boost::filesystem::path& path,
+			const CppCoverage::CoverageRate& coverageRate,
+			std::vector<FileCoverageView>&& files,
+			std::shared_ptr<const std::string> decompressedBlock);
+
+		const boost::filesystem::path& GetPath() const;
+		const CppCoverage::CoverageRate& GetCoverageRate() const;
+		const std::vector<FileCoverageView>& GetFiles() const;
+
+	private:
+		const boost::filesystem::path* path_;
+		CppCoverage::CoverageRate coverageRate_;
+		std::vector<FileCoverageView> files_;
+		std::shared_ptr<const std::string> decompressedBlock_;
+	};
+
+	//-------------------------------------------------------------------------
+	// Read-only view of a binary coverage file mapped in memory. Modules are
+	// decoded on demand from the mapped bytes and their lines are not copied.
+	// Requires the version 2 of the binary format with a table of contents.
+	class EXPORTER_DLL CoverageDataView
+	{
+	public:
+		explicit CoverageDataView(const boost::filesystem::path&);
+		~CoverageDataView();
+
+		const std::wstring& GetName() const;
+		int GetExitCode() const;
+
+		size_t GetModuleCount() const;
+		const boost::filesystem::path& GetModulePath(size_t moduleIndex) const;
+		ModuleCoverageView GetModule(size_t moduleIndex) const;
+
+		// Build a CoverageData for the components that do not support views,
+		// like IExporter implementations. All the lines are copied.
+		CppCoverage::CoverageData ToCoverageData() const;
+
+	private:
+		CoverageDataView(const CoverageDataView&) = delete;
+		CoverageDataView& operator=(const CoverageDataView&) = delete;
+
+		struct ModuleEntry
+		{
+			unsigned long long offset;
+			unsigned long long size;
+			unsigned int pathIndex;
+			CppCoverage::CoverageRate coverageRate;
+		};
+
+		std::unique_ptr<boost::iostreams::mapped_file_source> mappedFile_;
+		std::wstring name_;
+		int exitCode_;
+		bool isCompressed_;
+		std::vector<boost::filesystem::path> paths_;
+		std::vector<ModuleEntry> modules_;
+	};
+}
@@ -0,0 +1,112 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ProtoBuffTools.hpp"
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace pb = ProtoBuff;
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	//-------------------------------------------------------------------------
+	void WriteMessage(
+		const google::protobuf::MessageLite& message, 
+		google::protobuf::io::CodedOutputStream& output)
+	{
+		output.WriteVarint32(message.ByteSize());
+		if (!message.SerializeToCodedStream(&output))
+			THROW(L"Cannot serialize message to stream");
+	}
+
+	//-------------------------------------------------------------------------
+	void ReadMessage(
+		google::protobuf::io::CodedInputStream& input,
+		google::protobuf::MessageLite& message)
+	{
+		unsigned int size = 0;
+
+		if (!input.ReadVarint32(&size))
+			THROW(L"Cannot read message size.");
+		auto limit = input.PushLimit(size);
+
+		if (!message.ParseFromCodedStream(&input))
+			THROW(L"Cannot parse message.");
+
+		input.PopLimit(limit);
+	}
+
+	//-------------------------------------------------------------------------
+	void InitializeProtoBuffFrom(
+		const cov::FileCoverage& file,
+		pb::FileCoverage& fileProtoBuff)
+	{
+		fileProtoBuff.set_path(Tools::ToUtf8String(file.GetPath().wstring()));
+
+		const auto& lines = file.GetLines();
+		fileProtoBuff.mutable_lines()->Reserve(static_cast<int>(lines.size()));
+		for (const auto& line : lines)
+		{
+			auto lineProtoBuff = fileProtoBuff.add_lines();
+			
+			lineProtoBuff->set_linenumber(line.GetLineNumber());
+			lineProtoBuff->set_hasbeenexecuted(line.HasBeenExecuted());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void InitializeModuleProtoBuffFrom(
+		const cov::ModuleCoverage& module,
+		pb::ModuleCoverage& moduleProtoBuff)
+	{
+		moduleProtoBuff.set_path(Tools::ToUtf8String(module.GetPath().wstring()));
+		
+		for (const auto& file : module.GetFiles())
+		{
+			auto fileProtoBuff = moduleProtoBuff.add_files();
+			InitializeProtoBuffFrom(*file, *fileProtoBuff);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<cov::ModuleCoverage> CreateModuleFrom(const pb::ModuleCoverage& moduleProtoBuff)
+	{
+		auto module = std::make_unique<cov::ModuleCoverage>(Tools::Utf8ToWString(moduleProtoBuff.path()));
+
+		module->ReserveFiles(moduleProtoBuff.files_size());
+		for (const auto& fileProtoBuff : moduleProtoBuff.files())
+		{
+			auto& file = module->AddFile(Tools::Utf8ToWString(fileProtoBuff.path()));
+			std::vector<cov::LineCoverage> lines;
+
+			lines.reserve(fileProtoBuff.lines_size());
+			for (const auto& line : fileProtoBuff.lines())
+				lines.emplace_back(line.linenumber(), line.hasbeenexecuted());
+			file.AddLines(std::move(lines));
+		}
+
+		return module;
+	}
+}
@@ -0,0 +1,50 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+
+#include "CoverageData.pb.h"
+#include "ProtoBuff.hpp"
+
+namespace CppCoverage
+{
+	class ModuleCoverage;
+	class FileCoverage;
+}
+
+namespace Exporter
+{
+	void WriteMessage(
+		const google::protobuf::MessageLite& message,
+		google::protobuf::io::CodedOutputStream& output);
+
+	void ReadMessage(
+		google::protobuf::io::CodedInputStream& input,
+		google::protobuf::MessageLite& message);
+
+	void InitializeProtoBuffFrom(
+		const CppCoverage::FileCoverage& file,
+		ProtoBuff::FileCoverage& fileProtoBuff);
+
+	void InitializeModuleProtoBuffFrom(
+		const CppCoverage::ModuleCoverage& module,
+		ProtoBuff::ModuleCoverage& moduleProtoBuff);
+
+	std::unique_ptr<CppCoverage::ModuleCoverage> CreateModuleFrom(
+		const ProtoBuff::ModuleCoverage& moduleProtoBuff);
+}
@@ -16,9 +16,9 @@
 
 #include "stdafx.h"
 
+#include <cstdio>
+#include <fstream>
 #include <unordered_set>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/xml_parser.hpp>
 #include <boost/filesystem.hpp>
 
 #include "CoberturaExporter.hpp"
@@ -31,7 +31,6 @@
 #include "Tools/Tool.hpp"
 
 namespace cov = CppCoverage;
-namespace property_tree = boost::property_tree;
 namespace fs = boost::filesystem;
 
 namespace Exporter
@@ -39,59 +38,215 @@ namespace Exporter
 	namespace
 	{
 		//-------------------------------------------------------------------------
-		property_tree::wptree& AddChild(property_tree::wptree& tree, const std::wstring& name)
+		// Write indented XML elements to a stream. Elements must be closed in the
+		// reverse order of their creation. The output is buffered and written
+		// by large blocks.
+		class XmlStreamWriter
 		{
-			return tree.add_child(name, property_tree::wptree{});
-		}
+		public:
+			//---------------------------------------------------------------------
+			explicit XmlStreamWriter(std::ostream& ostr)
+				: ostr_(ostr)
+				, isStartTagOpen_{ false }
+			{
+				buffer_.reserve(MaxBufferSize + 4096);
+				buffer_ += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+			}
+
+			//---------------------------------------------------------------------
+			void StartElement(const char* name)
+			{
+				CloseStartTag();
+				Indent();
+				buffer_ += '<';
+				buffer_ += name;
+				elements_.push_back(name);
+				isStartTagOpen_ = true;
+			}
+
+			//---------------------------------------------------------------------
+			void AddAttribute(const char* name, const std::string& utf8Value)
+			{
+				buffer_ += ' ';
+				buffer_ += name;
+				buffer_ += "=\"";
+				AppendEscaped(utf8Value);
+				buffer_ += '"';
+			}
+
+			//---------------------------------------------------------------------
+			void AddAttribute(const char* name, int value)
+			{
+				AddAttribute(name, std::to_string(value));
+			}
+
+			//---------------------------------------------------------------------
+			// Same precision as boost::property_tree: the value can be read
+			// back without loss.
+			void AddAttribute(const char* name, double value)
+			{
+				char str[32];
+
+				std::snprintf(str, sizeof(str), "%.17g", value);
+				AddAttribute(name, std::string{ str });
+			}
+
+			//---------------------------------------------------------------------
+			void EndElement()
+			{
+				const char* name = elements_.back();
+
+				elements_.pop_back();
+				if (isStartTagOpen_)
+				{
+					buffer_ += "/>\n";
+					isStartTagOpen_ = false;
+				}
+				else
+				{
+					Indent();
+					buffer_ += "</";
+					buffer_ += name;
+					buffer_ += ">\n";
+				}
+				FlushIfNeeded();
+			}
+
+			//---------------------------------------------------------------------
+			void AddElement(const char* name, const std::string& utf8Text)
+			{
+				StartElement(name);
+				if (!utf8Text.empty())
+				{
+					buffer_ += '>';
+					AppendEscaped(utf8Text);
+					buffer_ += "</";
+					buffer_ += name;
+					buffer_ += ">\n";
+					elements_.pop_back();
+					isStartTagOpen_ = false;
+				}
+				else
+					EndElement();
+			}
+
+			//---------------------------------------------------------------------
+			void Flush()
+			{
+				ostr_.write(buffer_.data(), buffer_.size());
+				buffer_.clear();
+			}
+
+		private:
+			XmlStreamWriter(const XmlStreamWriter&) = delete;
+			XmlStreamWriter& operator=(const XmlStreamWriter&) = delete;
+
+			static const size_t MaxBufferSize = 1024 * 1024;
+			static const size_t IndentSize = 2;
+
+			//---------------------------------------------------------------------
+			void CloseStartTag()
+			{
+				if (isStartTagOpen_)
+				{
+					buffer_ += ">\n";
+					isStartTagOpen_ = false;
+				}
+			}
+
+			//---------------------------------------------------------------------
+			void Indent()
+			{
+				buffer_.append(elements_.size() * IndentSize, ' ');
+			}
+
+			//---------------------------------------------------------------------
+			void AppendEscaped(const std::string& str)
+			{
+				// Same rule as boost::property_tree: a string of spaces only
+				// keeps its first space visible.
+				if (!str.empty() && str.find_first_not_of(' ') == std::string::npos)
+				{
+					buffer_ += "&#32;";
+					buffer_.append(str.size() - 1, ' ');
+					return;
+				}
+
+				for (auto c : str)
+				{
+					switch (c)
+					{
+						case '&': buffer_ += "&amp;"; break;
+						case '<': buffer_ += "&lt;"; break;
+						case '>': buffer_ += "&gt;"; break;
+						case '"': buffer_ += "&quot;"; break;
+						case '\'': buffer_ += "&apos;"; break;
+						default: buffer_ += c;
+					}
+				}
+			}
+
+			//---------------------------------------------------------------------
+			void FlushIfNeeded()
+			{
+				if (buffer_.size() >= MaxBufferSize)
+					Flush();
+			}
+
+			std::ostream& ostr_;
+			std::string buffer_;
+			std::vector<const char*> elements_;
+			bool isStartTagOpen_;
+		};
 
 		//-------------------------------------------------------------------------
-		std::wstring ToUft8WString(const fs::path& path)
+		std::string ToUtf8String(const fs::path& path)
 		{
-			auto str = Tools::ToUtf8String(path.wstring());
-			auto utf8Str = Tools::LocalToWString(str);
-			return utf8Str;
+			return Tools::ToUtf8String(path.wstring());
 		}
 
 		//-------------------------------------------------------------------------
 		void SetCoverage(
-			property_tree::wptree& node,
+			XmlStreamWriter& writer,
 			const CppCoverage::CoverageRate& coverageRate)
 		{
-			node.put(L"<xmlattr>.line-rate", coverageRate.GetRate());
-			node.put(L"<xmlattr>.branch-rate", 0);
-			node.put(L"<xmlattr>.complexity", 0);
+			writer.AddAttribute("line-rate", coverageRate.GetRate());
+			writer.AddAttribute("branch-rate", 0);
+			writer.AddAttribute("complexity", 0);
 		}
 
 		//-------------------------------------------------------------------------
-		void FillFileTree(
+		void WriteFile(
 			const cov::CoverageRateComputer& coverageRateComputer,
-			property_tree::wptree& fileTree, 
+			XmlStreamWriter& writer,
 			const cov::FileCoverage& file)
 		{
 			const auto& path = file.GetPath();
-			auto res = path.relative_path();
 			const auto& coverageRate = coverageRateComputer.GetCoverageRate(file);
 
-			fileTree.put(L"<xmlattr>.name", ToUft8WString(path.filename()));
-			fileTree.put(L"<xmlattr>.filename", ToUft8WString(path.relative_path()));
-			SetCoverage(fileTree, coverageRate);
-			AddChild(fileTree, L"methods");
-
-			property_tree::wptree& linesTree = AddChild(fileTree, L"lines");
+			writer.StartElement("class");
+			writer.AddAttribute("name", ToUtf8String(path.filename()));
+			writer.AddAttribute("filename", ToUtf8String(path.relative_path()));
+			SetCoverage(writer, coverageRate);
+			writer.StartElement("methods");
+			writer.EndElement();
 
+			writer.StartElement("lines");
 			for (const auto& line : file.GetLines())
 			{
-				property_tree::wptree& lineTree = AddChild(linesTree, L"line");
-
-				lineTree.put(L"<xmlattr>.number", std::to_wstring(line.GetLineNumber()));
-				lineTree.put(L"<xmlattr>.hits", line.HasBeenExecuted() ? L"1" : L"0");
+				writer.StartElement("line");
+				writer.AddAttribute("number", std::to_string(line.GetLineNumber()));
+				writer.AddAttribute("hits", line.HasBeenExecuted() ? 1 : 0);
+				writer.EndElement();
 			}
+			writer.EndElement();
+			writer.EndElement();
 		}
 
 		//-------------------------------------------------------------------------
 		void WriteSourceRoots(
 			const CppCoverage::CoverageData& coverageData,
-			property_tree::wptree& coverageTree)
+			XmlStreamWriter& writer)
 		{
 			std::unordered_set<std::wstring> rootPaths;
 
@@ -104,56 +259,68 @@ namespace Exporter
 				}
 			}
 
-			auto& sourcesTree = AddChild(coverageTree, L"sources");
-
+			writer.StartElement("sources");
 			for (const auto& rootPath : rootPaths)
-				sourcesTree.add(L"source", rootPath);
+				writer.AddElement("source", Tools::ToUtf8String(rootPath));
+			writer.EndElement();
 		}
 
 		//-------------------------------------------------------------------------
-		void SetCoverageAttributes(property_tree::wptree& coverageTree)
+		void SetCoverageAttributes(XmlStreamWriter& writer)
 		{
-			coverageTree.put(L"<xmlattr>.branches-covered", 0);
-			coverageTree.put(L"<xmlattr>.branches-valid", 0);
-			coverageTree.put(L"<xmlattr>.timestamp", 0);
-			coverageTree.put(L"<xmlattr>.lines-covered", 0);
-			coverageTree.put(L"<xmlattr>.lines-valid", 0);
-			coverageTree.put(L"<xmlattr>.version", 0);
+			writer.AddAttribute("branches-covered", 0);
+			writer.AddAttribute("branches-valid", 0);
+			writer.AddAttribute("timestamp", 0);
+			writer.AddAttribute("lines-covered", 0);
+			writer.AddAttribute("lines-valid", 0);
+			writer.AddAttribute("version", 0);
 		}
 
 		//-------------------------------------------------------------------------
-		void FillCoverageTree(
-			property_tree::wptree& root,
-			const CppCoverage::CoverageData& coverageData)
+		void WriteCoverage(
+			XmlStreamWriter& writer,
+			const CppCoverage::CoverageData& coverageData,
+			const cov::CoverageRateComputer& coverageRateComputer)
 		{
-			cov::CoverageRateComputer coverageRateComputer(coverageData);
-			auto& coverageTree = AddChild(root, L"coverage");
-			SetCoverage(coverageTree, coverageRateComputer.GetCoverageRate());
-			SetCoverageAttributes(coverageTree);
+			writer.StartElement("coverage");
+			SetCoverage(writer, coverageRateComputer.GetCoverageRate());
+			SetCoverageAttributes(writer);
 
-			WriteSourceRoots(coverageData, coverageTree);
-
-			property_tree::wptree& packagesTree = AddChild(coverageTree, L"packages");
+			WriteSourceRoots(coverageData, writer);
 
+			writer.StartElement("packages");
 			for (const auto& module : coverageData.GetModules())
 			{
 				// Do not create package if no files exists -> Coverage will not be visible by module
 				if (!module->GetFiles().empty())
 				{
-					property_tree::wptree& packageTree = AddChild(packagesTree, L"package");
-					property_tree::wptree& classesTree = AddChild(packageTree, L"classes");
 					const auto& coverageRate = coverageRateComputer.GetCoverageRate(*module);
 
-					packageTree.put(L"<xmlattr>.name", ToUft8WString(module->GetPath()));
-					SetCoverage(packageTree, coverageRate);
+					writer.StartElement("package");
+					writer.AddAttribute("name", ToUtf8String(module->GetPath()));
+					SetCoverage(writer, coverageRate);
 
+					writer.StartElement("classes");
 					for (const auto& file : module->GetFiles())
-					{
-						property_tree::wptree& fileTree = AddChild(classesTree, L"class");
-						FillFileTree(coverageRateComputer, fileTree, *file);
-					}
+						WriteFile(coverageRateComputer, writer, *file);
+					writer.EndElement();
+					writer.EndElement();
 				}
 			}
+			writer.EndElement();
+			writer.EndElement();
+		}
+
+		//-------------------------------------------------------------------------
+		void WriteCoverage(
+			const CppCoverage::CoverageData& coverageData,
+			const cov::CoverageRateComputer& coverageRateComputer,
+			std::ostream& ostream)
+		{
+			XmlStreamWriter writer{ ostream };
+
+			WriteCoverage(writer, coverageData, coverageRateComputer);
+			writer.Flush();
 		}
 	}
 
@@ -174,25 +341,28 @@ namespace Exporter
 	void CoberturaExporter::Export(
 		const CppCoverage::CoverageData& coverageData, 
 		const boost::filesystem::path& output)
+	{
+		Export(coverageData, cov::CoverageRateComputer{ coverageData }, output);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoberturaExporter::Export(
+		const CppCoverage::CoverageData& coverageData,
+		const CppCoverage::CoverageRateComputer& coverageRateComputer,
+		const boost::filesystem::path& output)
 	{
 		Tools::CreateParentFolderIfNeeded(output);
-		std::wofstream ofs{ output.string().c_str() };
+		std::ofstream ofs{ output.string().c_str() };
 
-		Export(coverageData, ofs);
+		WriteCoverage(coverageData, coverageRateComputer, ofs);
 		Tools::ShowOutputMessage(L"Cobertura report generated: ", output);
 	}
 
 	//-------------------------------------------------------------------------
 	void CoberturaExporter::Export(
 		const CppCoverage::CoverageData& coverageData,
-		std::wostream& ostream) const
+		std::ostream& ostream) const
 	{
-		using Ptree = property_tree::wptree;
-		Ptree root;
-		
-		FillCoverageTree(root, coverageData);
-
-		property_tree::xml_writer_settings<Ptree::key_type> settings(' ', 2);
-		property_tree::xml_parser::write_xml(ostream, root, settings);
+		WriteCoverage(coverageData, cov::CoverageRateComputer{ coverageData }, ostream);
 	}
 }
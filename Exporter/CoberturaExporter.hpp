@@ -24,6 +24,7 @@
 namespace CppCoverage
 {
 	class CoverageData;
+	class CoverageRateComputer;
 }
 
 namespace boost
@@ -43,7 +44,13 @@ namespace Exporter
 
 		boost::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
 		void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& output) override;
-		void Export(const CppCoverage::CoverageData&, std::wostream&) const;
+		void Export(
+			const CppCoverage::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const boost::filesystem::path& output) override;
+
+		// Write the report as UTF-8 while iterating the coverage data.
+		void Export(const CppCoverage::CoverageData&, std::ostream&) const;
 
 	private:
 		CoberturaExporter(const CoberturaExporter&) = delete;
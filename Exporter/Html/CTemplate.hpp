@@ -23,6 +23,8 @@
 template std::vector<std::string>; // To avoid error C4251
 #define _SILENCE_STDEXT_HASH_DEPRECATION_WARNINGS
 #include <ctemplate/template.h>
+#include <ctemplate/template_cache.h>
+#include <ctemplate/template_emitter.h>
 #undef _SILENCE_STDEXT_HASH_DEPRECATION_WARNING
 
 #pragma warning(pop)
@@ -0,0 +1,366 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CompactHtmlExporter.hpp"
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <zlib.h>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "Tools/Tool.hpp"
+#include "Tools/ParallelFor.hpp"
+
+#include "../ExporterException.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		// Number of sources compressed in parallel before being written, to bound the memory.
+		const size_t SourceBatchSize = 256;
+
+		const char Base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+		//---------------------------------------------------------------------
+		std::string EncodeBase64(const unsigned char* data, size_t size)
+		{
+			std::string output;
+			size_t i = 0;
+
+			output.reserve((size + 2) / 3 * 4);
+			for (; i + 3 <= size; i += 3)
+			{
+				auto value = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+
+				output += Base64Chars[value >> 18];
+				output += Base64Chars[(value >> 12) & 0x3F];
+				output += Base64Chars[(value >> 6) & 0x3F];
+				output += Base64Chars[value & 0x3F];
+			}
+			if (i != size)
+			{
+				auto hasSecondByte = i + 1 != size;
+				auto value = (data[i] << 16) | (hasSecondByte ? data[i + 1] << 8 : 0);
+
+				output += Base64Chars[value >> 18];
+				output += Base64Chars[(value >> 12) & 0x3F];
+				output += hasSecondByte ? Base64Chars[(value >> 6) & 0x3F] : '=';
+				output += '=';
+			}
+			return output;
+		}
+
+		//---------------------------------------------------------------------
+		void AppendJsonString(const std::wstring& str, std::string& output)
+		{
+			static const char HexChars[] = "0123456789abcdef";
+
+			output += '"';
+			for (auto c : Tools::ToUtf8String(str))
+			{
+				if (c == '"' || c == '\\')
+				{
+					output += '\\';
+					output += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					output += "\\u00";
+					output += HexChars[c >> 4];
+					output += HexChars[c & 0xF];
+				}
+				else
+					output += c;
+			}
+			output += '"';
+		}
+
+		//---------------------------------------------------------------------
+		void WriteContentTo(const std::string& content, const fs::path& path)
+		{
+			std::ofstream ofs(path.string(), std::ios::binary);
+
+			if (!ofs || !ofs.write(content.data(), content.size()))
+				THROW(L"Cannot write file " + path.wstring());
+		}
+
+		//---------------------------------------------------------------------
+		// The source is stored as it is on the disk: the viewer decodes it as UTF-8
+		// or as Windows-1252 when it is not valid UTF-8.
+		boost::optional<std::string> TryCompressSource(const fs::path& path)
+		{
+			std::ifstream ifs(path.string(), std::ios::binary | std::ios::ate);
+
+			if (!ifs)
+				return boost::none;
+
+			std::string source(static_cast<size_t>(ifs.tellg()), '\0');
+			if (!ifs.seekg(0) || !ifs.read(&source[0], source.size()))
+				return boost::none;
+
+			auto compressedSize = compressBound(static_cast<uLong>(source.size()));
+			std::string compressedSource(compressedSize, '\0');
+
+			if (compress2(reinterpret_cast<Bytef*>(&compressedSource[0]), &compressedSize,
+				reinterpret_cast<const Bytef*>(source.data()), static_cast<uLong>(source.size()), Z_BEST_SPEED) != Z_OK)
+			{
+				THROW(L"Cannot compress " + path.wstring());
+			}
+			return EncodeBase64(reinterpret_cast<const unsigned char*>(compressedSource.data()), compressedSize);
+		}
+
+		//---------------------------------------------------------------------
+		struct SourceLocation
+		{
+			size_t chunk;
+			size_t index;
+		};
+
+		//---------------------------------------------------------------------
+		// Group the sources in files sourcesN.js calling coverageReport.addSources.
+		class SourceChunkWriter
+		{
+		public:
+			//-----------------------------------------------------------------
+			SourceChunkWriter(const fs::path& folder, size_t maxChunkSize)
+				: folder_{ folder }
+				, maxChunkSize_{ maxChunkSize }
+				, chunkIndex_{ 0 }
+				, sourceCount_{ 0 }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			SourceLocation Add(const std::string& compressedSource)
+			{
+				if (sourceCount_ && chunk_.size() + compressedSource.size() > maxChunkSize_)
+					Flush();
+
+				if (sourceCount_)
+					chunk_ += ",\n\"";
+				else
+					chunk_ = "coverageReport.addSources(" + std::to_string(chunkIndex_) + ", [\n\"";
+				chunk_ += compressedSource;
+				chunk_ += '"';
+
+				return SourceLocation{ chunkIndex_, sourceCount_++ };
+			}
+
+			//-----------------------------------------------------------------
+			void Flush()
+			{
+				if (!sourceCount_)
+					return;
+				chunk_ += "]);\n";
+				WriteContentTo(chunk_, folder_ / (L"sources" + std::to_wstring(chunkIndex_) + L".js"));
+				chunk_.clear();
+				sourceCount_ = 0;
+				++chunkIndex_;
+			}
+
+		private:
+			fs::path folder_;
+			size_t maxChunkSize_;
+			std::string chunk_;
+			size_t chunkIndex_;
+			size_t sourceCount_;
+		};
+
+		//---------------------------------------------------------------------
+		struct ModuleFiles
+		{
+			const cov::ModuleCoverage* module;
+			std::vector<const cov::FileCoverage*> files;
+		};
+
+		//---------------------------------------------------------------------
+		void AppendFile(
+			const cov::FileCoverage& file,
+			const cov::CoverageRate& coverageRate,
+			const boost::optional<SourceLocation>& sourceLocation,
+			std::string& output)
+		{
+			unsigned int firstLine = 0;
+			auto lines = CompactHtmlExporter::EncodeLineCoverage(file, firstLine);
+
+			output += "{\"path\":";
+			AppendJsonString(file.GetPath().wstring(), output);
+			output += ",\"executed\":" + std::to_string(coverageRate.GetExecutedLinesCount());
+			output += ",\"total\":" + std::to_string(coverageRate.GetTotalLinesCount());
+			output += ",\"firstLine\":" + std::to_string(firstLine);
+			output += ",\"lines\":\"" + lines + '"';
+			if (sourceLocation)
+			{
+				output += ",\"source\":[" + std::to_string(sourceLocation->chunk)
+					+ ',' + std::to_string(sourceLocation->index) + ']';
+			}
+			else
+				output += ",\"source\":null";
+			output += '}';
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring CompactHtmlExporter::ViewerTemplateFilename = L"CompactViewer.html";
+	const std::wstring CompactHtmlExporter::CoverageFilename = L"coverage.js";
+	const std::wstring CompactHtmlExporter::SourcesFolder = L"sources";
+	const size_t CompactHtmlExporter::DefaultMaxChunkSize = 4 * 1024 * 1024;
+
+	//-------------------------------------------------------------------------
+	CompactHtmlExporter::CompactHtmlExporter(
+		const fs::path& templateFolder,
+		size_t maxThreadCount,
+		size_t maxChunkSize)
+		: templateFolder_(templateFolder)
+		, maxThreadCount_(maxThreadCount)
+		, maxChunkSize_(maxChunkSize)
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path CompactHtmlExporter::GetDefaultPath(const std::wstring&) const
+	{
+		auto now = std::time(nullptr);
+		auto localNow = std::localtime(&now);
+		std::ostringstream ostr;
+
+		ostr << "CompactCoverageReport-" << std::put_time(localNow, "%Y-%m-%d-%Hh%Mm%Ss");
+
+		return ostr.str();
+	}
+
+	//-------------------------------------------------------------------------
+	void CompactHtmlExporter::Export(
+		const cov::CoverageData& coverageData,
+		const fs::path& outputFolderPrefix)
+	{
+		Export(coverageData, cov::CoverageRateComputer{ coverageData }, outputFolderPrefix);
+	}
+
+	//-------------------------------------------------------------------------
+	void CompactHtmlExporter::Export(
+		const cov::CoverageData& coverageData,
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const fs::path& outputFolderPrefix)
+	{
+		auto outputFolder = fs::absolute(outputFolderPrefix);
+		auto sourcesFolder = outputFolder / SourcesFolder;
+		std::vector<ModuleFiles> modulesFiles;
+		std::vector<const cov::FileCoverage*> files;
+
+		fs::create_directories(sourcesFolder);
+		fs::copy_file(templateFolder_ / ViewerTemplateFilename, outputFolder / L"index.html",
+			fs::copy_option::overwrite_if_exists);
+
+		for (const auto& module : coverageRateComputer.SortModulesByCoverageRate())
+		{
+			if (coverageRateComputer.GetCoverageRate(*module).GetTotalLinesCount())
+			{
+				auto moduleFiles = coverageRateComputer.SortFilesByCoverageRate(*module);
+
+				modulesFiles.push_back(ModuleFiles{ module, { moduleFiles.begin(), moduleFiles.end() } });
+				files.insert(files.end(), moduleFiles.begin(), moduleFiles.end());
+			}
+		}
+
+		SourceChunkWriter sourceChunkWriter{ sourcesFolder, maxChunkSize_ };
+		std::vector<boost::optional<SourceLocation>> sourceLocations(files.size());
+
+		for (size_t batchBegin = 0; batchBegin < files.size(); batchBegin += SourceBatchSize)
+		{
+			auto batchSize = std::min(SourceBatchSize, files.size() - batchBegin);
+			std::vector<boost::optional<std::string>> compressedSources(batchSize);
+
+			Tools::ParallelFor(batchSize, [&](size_t i)
+			{
+				compressedSources[i] = TryCompressSource(files[batchBegin + i]->GetPath());
+			}, maxThreadCount_);
+
+			// Sources are added in the report order so that the output does not
+			// depend on the thread scheduling.
+			for (size_t i = 0; i < batchSize; ++i)
+			{
+				if (compressedSources[i])
+					sourceLocations[batchBegin + i] = sourceChunkWriter.Add(*compressedSources[i]);
+			}
+		}
+		sourceChunkWriter.Flush();
+
+		std::string coverage = "coverageReport.setCoverage({\"name\":";
+		size_t fileIndex = 0;
+
+		AppendJsonString(coverageData.GetName(), coverage);
+		coverage += ",\"exitCode\":" + std::to_string(coverageData.GetExitCode());
+		coverage += ",\"modules\":[";
+		for (const auto& moduleFiles : modulesFiles)
+		{
+			coverage += (&moduleFiles == &modulesFiles.front()) ? "\n{\"path\":" : ",\n{\"path\":";
+			AppendJsonString(moduleFiles.module->GetPath().wstring(), coverage);
+			coverage += ",\"files\":[";
+			for (const auto* file : moduleFiles.files)
+			{
+				coverage += (file == moduleFiles.files.front()) ? "\n" : ",\n";
+				AppendFile(*file, coverageRateComputer.GetCoverageRate(*file), sourceLocations[fileIndex++], coverage);
+			}
+			coverage += "]}";
+		}
+		coverage += "]});\n";
+		WriteContentTo(coverage, outputFolder / CoverageFilename);
+
+		Tools::ShowOutputMessage(L"Coverage generated in Folder ", outputFolder);
+	}
+
+	//-------------------------------------------------------------------------
+	std::string CompactHtmlExporter::EncodeLineCoverage(
+		const cov::FileCoverage& fileCoverage,
+		unsigned int& firstLine)
+	{
+		const auto& lines = fileCoverage.GetLines();
+
+		if (lines.empty())
+		{
+			firstLine = 0;
+			return "";
+		}
+
+		firstLine = lines.front().GetLineNumber();
+		std::vector<unsigned char> bitmap((lines.back().GetLineNumber() - firstLine) / 4 + 1);
+
+		for (const auto& line : lines)
+		{
+			auto offset = line.GetLineNumber() - firstLine;
+			unsigned char value = line.HasBeenExecuted() ? 3 : 1;
+
+			bitmap[offset / 4] |= value << (offset % 4 * 2);
+		}
+		return EncodeBase64(bitmap.data(), bitmap.size());
+	}
+}
@@ -0,0 +1,76 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "../ExporterExport.hpp"
+#include "../IExporter.hpp"
+
+namespace CppCoverage
+{
+	class FileCoverage;
+	class CoverageRateComputer;
+}
+
+namespace Exporter
+{
+	// Html report made of a single static viewer page and a compact payload
+	// rendered by the browser:
+	//  - index.html: the viewer, copied from the template folder.
+	//  - coverage.js: modules and files with a bitmap of the line coverage.
+	//  - sources/sourcesN.js: sources compressed with zlib and grouped in chunks,
+	//    loaded only when a file is opened.
+	class EXPORTER_DLL CompactHtmlExporter : public IExporter
+	{
+	public:
+		static const std::wstring ViewerTemplateFilename;
+		static const std::wstring CoverageFilename;
+		static const std::wstring SourcesFolder;
+		static const size_t DefaultMaxChunkSize;
+
+	public:
+		// maxThreadCount is the number of threads compressing sources,
+		// 0 means one thread per hardware core.
+		// A new chunk of sources is started when the current one exceeds maxChunkSize bytes.
+		explicit CompactHtmlExporter(
+			const boost::filesystem::path& templateFolder,
+			size_t maxThreadCount = 0,
+			size_t maxChunkSize = DefaultMaxChunkSize);
+
+		boost::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
+		void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& outputFolder) override;
+		void Export(
+			const CppCoverage::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const boost::filesystem::path& outputFolder) override;
+
+		// Coverage of the lines from firstLine, 2 bits per line encoded in base64:
+		// 0 for a line without code, 1 for an unexecuted line and 3 for an executed line.
+		static std::string EncodeLineCoverage(const CppCoverage::FileCoverage&, unsigned int& firstLine);
+
+	private:
+		CompactHtmlExporter(const CompactHtmlExporter&) = delete;
+		CompactHtmlExporter& operator=(const CompactHtmlExporter&) = delete;
+
+	private:
+		boost::filesystem::path templateFolder_;
+		size_t maxThreadCount_;
+		size_t maxChunkSize_;
+	};
+}
@@ -0,0 +1,415 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CppLexer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace Exporter
+{
+	namespace
+	{
+		const char* const Keywords[] = {
+			"alignas", "alignof", "asm", "auto", "bool", "break", "case", "catch", "char",
+			"char16_t", "char32_t", "char8_t", "class", "co_await", "co_return", "co_yield",
+			"concept", "const", "const_cast", "consteval", "constexpr", "constinit", "continue",
+			"decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+			"explicit", "export", "extern", "false", "final", "float", "for", "friend", "goto",
+			"if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "nullptr",
+			"operator", "override", "private", "protected", "public", "register",
+			"reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+			"static_assert", "static_cast", "struct", "switch", "template", "this",
+			"thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+			"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while" };
+
+		const size_t MaxKeywordSize = 16;
+		const size_t MaxRawStringDelimiterSize = 16;
+
+		enum CharClass : unsigned char
+		{
+			IdentifierChar = 1,
+			DigitChar = 2,
+			SpaceChar = 4
+		};
+
+		//---------------------------------------------------------------------
+		std::array<unsigned char, 256> CreateCharClasses()
+		{
+			std::array<unsigned char, 256> charClasses = {};
+
+			// Non ASCII chars are part of UTF-8 identifiers.
+			for (int c = 0x80; c < 0x100; ++c)
+				charClasses[c] = IdentifierChar;
+			for (int c = 'a'; c <= 'z'; ++c)
+				charClasses[c] = IdentifierChar;
+			for (int c = 'A'; c <= 'Z'; ++c)
+				charClasses[c] = IdentifierChar;
+			for (int c = '0'; c <= '9'; ++c)
+				charClasses[c] = IdentifierChar | DigitChar;
+			charClasses['_'] = IdentifierChar;
+			for (auto c : " \t\r\f\v")
+				charClasses[static_cast<unsigned char>(c)] = SpaceChar;
+			// The loop above includes the terminating null char.
+			charClasses[0] = 0;
+			return charClasses;
+		}
+
+		const auto CharClasses = CreateCharClasses();
+
+		//---------------------------------------------------------------------
+		bool HasCharClass(char c, CharClass charClass)
+		{
+			return (CharClasses[static_cast<unsigned char>(c)] & charClass) != 0;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsIdentifierChar(char c)
+		{
+			return HasCharClass(c, IdentifierChar);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsDigit(char c)
+		{
+			return HasCharClass(c, DigitChar);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsSpace(char c)
+		{
+			return HasCharClass(c, SpaceChar);
+		}
+
+		//---------------------------------------------------------------------
+		// Keywords start with a lower case letter and are grouped by first
+		// letter and size, so a lookup compares at most a few keywords.
+		size_t GetKeywordBucket(char firstChar, size_t size)
+		{
+			return (firstChar - 'a') * (MaxKeywordSize + 1) + size;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::vector<const char*>> CreateKeywordBuckets()
+		{
+			std::vector<std::vector<const char*>> buckets(GetKeywordBucket('z' + 1, 0));
+
+			for (const auto* keyword : Keywords)
+				buckets[GetKeywordBucket(keyword[0], std::strlen(keyword))].push_back(keyword);
+			return buckets;
+		}
+
+		const auto KeywordBuckets = CreateKeywordBuckets();
+
+		//---------------------------------------------------------------------
+		bool IsKeyword(const char* begin, const char* end)
+		{
+			auto size = static_cast<size_t>(end - begin);
+
+			if (size < 2 || size > MaxKeywordSize || *begin < 'a' || *begin > 'z')
+				return false;
+			for (const auto* keyword : KeywordBuckets[GetKeywordBucket(*begin, size)])
+			{
+				if (std::memcmp(keyword, begin, size) == 0)
+					return true;
+			}
+			return false;
+		}
+
+		//---------------------------------------------------------------------
+		// L, u, U, u8 and the same prefixes followed by R for raw strings.
+		bool IsStringPrefix(const char* begin, const char* end, bool& isRaw)
+		{
+			isRaw = begin != end && end[-1] == 'R';
+			if (isRaw)
+				--end;
+
+			switch (end - begin)
+			{
+				case 0: return isRaw;
+				case 1: return *begin == 'L' || *begin == 'u' || *begin == 'U';
+				case 2: return begin[0] == 'u' && begin[1] == '8';
+			}
+			return false;
+		}
+
+		//---------------------------------------------------------------------
+		// Skip a backslash and the new line following it if any.
+		const char* SkipEscapedChar(const char* backslash, const char* end)
+		{
+			auto current = backslash + 1;
+
+			if (current != end && *current == '\r' && current + 1 != end && current[1] == '\n')
+				++current;
+			return current != end ? current + 1 : current;
+		}
+
+		//---------------------------------------------------------------------
+		// The new line, including a '\r' before it, is not part of the token.
+		const char* ExcludeCarriageReturn(const char* begin, const char* newLine)
+		{
+			return (newLine != begin && newLine[-1] == '\r') ? newLine - 1 : newLine;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CppLexer::CppLexer(const char* begin, const char* end)
+		: current_{ begin }
+		, end_{ end }
+		, nextToken_{}
+		, hasNextToken_{ false }
+		, isLineStart_{ true }
+		, isIncludeDirective_{ false }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool CppLexer::Next(CppToken& token)
+	{
+		if (hasNextToken_)
+		{
+			token = nextToken_;
+			hasNextToken_ = false;
+			return true;
+		}
+		if (current_ == end_)
+			return false;
+
+		const auto* plainBegin = current_;
+
+		while (current_ != end_)
+		{
+			auto tokenBegin = current_;
+
+			if (TryReadHighlightedToken(nextToken_))
+			{
+				if (tokenBegin == plainBegin)
+				{
+					token = nextToken_;
+					return true;
+				}
+				hasNextToken_ = true;
+				token = { CppTokenType::Plain, plainBegin, tokenBegin };
+				return true;
+			}
+		}
+
+		token = { CppTokenType::Plain, plainBegin, end_ };
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool CppLexer::TryReadHighlightedToken(CppToken& token)
+	{
+		auto c = *current_;
+		auto type = CppTokenType::Plain;
+		const char* tokenEnd = nullptr;
+
+		if (c == '\n')
+		{
+			isLineStart_ = true;
+			isIncludeDirective_ = false;
+			++current_;
+			return false;
+		}
+		if (IsSpace(c))
+		{
+			do
+				++current_;
+			while (current_ != end_ && IsSpace(*current_));
+			return false;
+		}
+
+		auto isLineStart = isLineStart_;
+		isLineStart_ = false;
+
+		if (IsIdentifierChar(c) && !IsDigit(c))
+			tokenEnd = ReadIdentifierOrKeyword(type);
+		else if (IsDigit(c) || (c == '.' && current_ + 1 != end_ && IsDigit(current_[1])))
+		{
+			type = CppTokenType::Literal;
+			tokenEnd = ReadNumber();
+		}
+		else if (c == '"' || c == '\'')
+		{
+			type = CppTokenType::String;
+			tokenEnd = ReadString(current_);
+		}
+		else if (c == '/' && current_ + 1 != end_ && current_[1] == '/')
+		{
+			type = CppTokenType::Comment;
+			tokenEnd = ReadLineComment();
+		}
+		else if (c == '/' && current_ + 1 != end_ && current_[1] == '*')
+		{
+			type = CppTokenType::Comment;
+			tokenEnd = ReadBlockComment();
+		}
+		else if (c == '#' && isLineStart)
+		{
+			type = CppTokenType::Preprocessor;
+			tokenEnd = ReadPreprocessorDirective();
+		}
+		else if (c == '<' && isIncludeDirective_)
+		{
+			type = CppTokenType::String;
+			tokenEnd = std::find_if(current_, end_, [](char next) { return next == '>' || next == '\n'; });
+			if (tokenEnd != end_ && *tokenEnd == '>')
+				++tokenEnd;
+		}
+		else
+			tokenEnd = current_ + 1;
+
+		token = { type, current_, tokenEnd };
+		current_ = tokenEnd;
+		return type != CppTokenType::Plain;
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadIdentifierOrKeyword(CppTokenType& type)
+	{
+		auto identifierEnd = std::find_if_not(current_, end_, IsIdentifierChar);
+		bool isRaw = false;
+
+		if (identifierEnd != end_ && (*identifierEnd == '"' || *identifierEnd == '\'')
+			&& IsStringPrefix(current_, identifierEnd, isRaw))
+		{
+			type = CppTokenType::String;
+			if (isRaw && *identifierEnd == '"')
+				return ReadRawString(identifierEnd);
+			return ReadString(identifierEnd);
+		}
+
+		type = IsKeyword(current_, identifierEnd) ? CppTokenType::Keyword : CppTokenType::Plain;
+		return identifierEnd;
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadNumber() const
+	{
+		auto current = current_ + 1;
+
+		// Preprocessing number: digits, letters, digit separators and exponent signs.
+		while (current != end_)
+		{
+			auto c = *current;
+
+			if (IsIdentifierChar(c) || c == '.')
+				++current;
+			else if (c == '\'' && current + 1 != end_ && IsIdentifierChar(current[1]))
+				current += 2;
+			else if ((c == '+' || c == '-') && std::strchr("eEpP", current[-1]))
+				++current;
+			else
+				break;
+		}
+		return current;
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadString(const char* quote) const
+	{
+		auto current = quote + 1;
+
+		while (current != end_)
+		{
+			auto c = *current;
+
+			if (c == '\\')
+				current = SkipEscapedChar(current, end_);
+			else if (c == *quote)
+				return current + 1;
+			else if (c == '\n')
+				return ExcludeCarriageReturn(quote, current);
+			else
+				++current;
+		}
+		return current;
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadRawString(const char* quote) const
+	{
+		auto delimiterBegin = quote + 1;
+		auto maxDelimiterEnd = delimiterBegin + std::min<size_t>(MaxRawStringDelimiterSize, end_ - delimiterBegin);
+		auto delimiterEnd = std::find(delimiterBegin, maxDelimiterEnd, '(');
+
+		if (delimiterEnd == maxDelimiterEnd)
+			return ReadString(quote);
+
+		// R"delimiter( ... )delimiter"
+		std::string terminator = ")" + std::string{ delimiterBegin, delimiterEnd } + "\"";
+		auto stringEnd = std::search(delimiterEnd + 1, end_, terminator.begin(), terminator.end());
+
+		return stringEnd == end_ ? end_ : stringEnd + terminator.size();
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadLineComment() const
+	{
+		auto current = current_ + 2;
+
+		while (true)
+		{
+			auto newLine = static_cast<const char*>(std::memchr(current, '\n', end_ - current));
+
+			if (!newLine)
+				return end_;
+
+			auto lineEnd = ExcludeCarriageReturn(current, newLine);
+
+			// A backslash at the end of the line continues the comment.
+			if (lineEnd == current || lineEnd[-1] != '\\')
+				return lineEnd;
+			current = newLine + 1;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadBlockComment() const
+	{
+		auto current = current_ + 2;
+
+		while (current != end_)
+		{
+			auto star = static_cast<const char*>(std::memchr(current, '*', end_ - current));
+
+			if (!star || star + 1 == end_)
+				return end_;
+			if (star[1] == '/')
+				return star + 2;
+			current = star + 1;
+		}
+		return end_;
+	}
+
+	//-------------------------------------------------------------------------
+	const char* CppLexer::ReadPreprocessorDirective()
+	{
+		auto directiveBegin = std::find_if_not(current_ + 1, end_, IsSpace);
+		auto directiveEnd = std::find_if_not(directiveBegin, end_, IsIdentifierChar);
+		std::string directive{ directiveBegin, directiveEnd };
+
+		isIncludeDirective_ = directive == "include" || directive == "include_next" || directive == "import";
+		return directiveEnd;
+	}
+
+}
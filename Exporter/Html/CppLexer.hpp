@@ -0,0 +1,73 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	enum class CppTokenType
+	{
+		Plain,
+		Keyword,
+		Literal,
+		String,
+		Comment,
+		Preprocessor
+	};
+
+	struct CppToken
+	{
+		CppTokenType type;
+		const char* begin;
+		const char* end;
+	};
+
+	// Split a C or C++ source into tokens for the syntax highlighting.
+	// Tokens cover the whole source: identifiers, punctuation, spaces and new
+	// lines are grouped in Plain tokens. Comments, strings and preprocessor lines can
+	// contain several lines.
+	// The source is not validated: invalid code still produces tokens.
+	class EXPORTER_DLL CppLexer
+	{
+	public:
+		CppLexer(const char* begin, const char* end);
+
+		// Return false when there is no more token.
+		bool Next(CppToken&);
+
+	private:
+		CppLexer(const CppLexer&) = delete;
+		CppLexer& operator=(const CppLexer&) = delete;
+
+		bool TryReadHighlightedToken(CppToken&);
+		const char* ReadIdentifierOrKeyword(CppTokenType&);
+		const char* ReadNumber() const;
+		const char* ReadString(const char* quote) const;
+		const char* ReadRawString(const char* quote) const;
+		const char* ReadLineComment() const;
+		const char* ReadBlockComment() const;
+		const char* ReadPreprocessorDirective();
+
+		const char* current_;
+		const char* end_;
+		CppToken nextToken_;
+		bool hasNextToken_;
+		bool isLineStart_;
+		bool isIncludeDirective_;
+	};
+}
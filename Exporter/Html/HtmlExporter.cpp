@@ -17,6 +17,7 @@
 #include "stdafx.h"
 #include "HtmlExporter.hpp"
 
+#include <atomic>
 #include <sstream>
 #include <iomanip>
 #include "CTemplate.hpp"
@@ -29,10 +30,13 @@
 
 #include "Tools/Log.hpp"
 #include "Tools/Tool.hpp"
+#include "Tools/ParallelFor.hpp"
 
 #include "TemplateHtmlExporter.hpp"
 #include "HtmlFileCoverageExporter.hpp"
 #include "HtmlFolderStructure.hpp"
+#include "HtmlFile.hpp"
+#include "HtmlReportManifest.hpp"
 namespace cov = CppCoverage;
 
 namespace Exporter
@@ -40,6 +44,9 @@ namespace Exporter
 
 	namespace
 	{
+		const std::wstring MainTemplateFilename = L"MainTemplate.html";
+		const std::wstring SourceTemplateFilename = L"SourceTemplate.html";
+
 		//-------------------------------------------------------------------------
 		std::wstring GetMainMessage(const CppCoverage::CoverageData& coverageData)
 		{
@@ -49,16 +56,35 @@ namespace Exporter
 				return HtmlExporter::WarningExitCodeMessage + std::to_wstring(exitCode);
 			return L"";
 		}
+
+		//-------------------------------------------------------------------------
+		struct SourcePage
+		{
+			const cov::FileCoverage* file;
+			HtmlFile htmlFile;
+			boost::optional<fs::path> generatedOutput;
+			HtmlReportManifest::T_Hash hash;
+			HtmlReportManifest::SourceHash sourceHash;
+		};
+
+		//-------------------------------------------------------------------------
+		struct ModulePages
+		{
+			const cov::ModuleCoverage* module;
+			HtmlFile htmlModulePath;
+			std::vector<SourcePage> pages;
+		};
 	}
 	
 	//-------------------------------------------------------------------------
 	const std::wstring HtmlExporter::WarningExitCodeMessage = L"Warning: Your program has exited with error code: ";
 
 	//-------------------------------------------------------------------------
-	HtmlExporter::HtmlExporter(const fs::path& templateFolder)
-		: exporter_(templateFolder / "MainTemplate.html", templateFolder / "SourceTemplate.html")
+	HtmlExporter::HtmlExporter(const fs::path& templateFolder, size_t maxThreadCount)
+		: exporter_(templateFolder / MainTemplateFilename, templateFolder / SourceTemplateFilename)
 		, fileCoverageExporter_()
 		, templateFolder_(templateFolder)
+		, maxThreadCount_(maxThreadCount)
 	{
 	}
 
@@ -78,74 +104,122 @@ namespace Exporter
 	void HtmlExporter::Export(
 		const CppCoverage::CoverageData& coverageData, 
 		const boost::filesystem::path& outputFolderPrefix)
+	{
+		Export(coverageData, cov::CoverageRateComputer{ coverageData }, outputFolderPrefix);
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlExporter::Export(
+		const CppCoverage::CoverageData& coverageData,
+		const CppCoverage::CoverageRateComputer& coverageRateComputer,
+		const boost::filesystem::path& outputFolderPrefix)
 	{	
 		HtmlFolderStructure htmlFolderStructure{templateFolder_};
-		cov::CoverageRateComputer coverageRateComputer{ coverageData };
+
+		// Templates are parsed once, before the pages are generated in parallel.
+		exporter_.LoadTemplates();
 
 		auto mainMessage = GetMainMessage(coverageData);
 
 		auto projectDictionary = exporter_.CreateTemplateDictionary(coverageData.GetName(), mainMessage);
 		auto outputFolder = htmlFolderStructure.CreateCurrentRoot(outputFolderPrefix);
+		std::vector<ModulePages> modulesPages;
+		std::vector<SourcePage*> sourcePages;
 
+		// Html paths are chosen in the same order as the report so that
+		// names of conflicting files do not depend on the thread scheduling.
 		for (const auto& module : coverageRateComputer.SortModulesByCoverageRate())
 		{			
-			const auto& moduleCoverageRate = coverageRateComputer.GetCoverageRate(*module);
+			if (coverageRateComputer.GetCoverageRate(*module).GetTotalLinesCount())
+			{
+				modulesPages.push_back(ModulePages{ module, htmlFolderStructure.CreateCurrentModule(module->GetPath()), {} });
+				auto& pages = modulesPages.back().pages;
+
+				for (const auto& file : coverageRateComputer.SortFilesByCoverageRate(*module))
+					pages.push_back(SourcePage{ file, htmlFolderStructure.GetHtmlFilePath(file->GetPath()), boost::none, 0, {} });
+			}
+		}
+		for (auto& modulePages : modulesPages)
+		{
+			for (auto& page : modulePages.pages)
+				sourcePages.push_back(&page);
+		}
+
+		// Pages with the same source, coverage and template as in the previous
+		// report in outputFolder are not generated again.
+		HtmlReportManifest manifest{ outputFolder };
+		auto templateHash = HtmlReportManifest::ComputeFileHash(templateFolder_ / SourceTemplateFilename);
+		std::atomic<size_t> upToDatePageCount{ 0 };
 
-			if (moduleCoverageRate.GetTotalLinesCount())
+		Tools::ParallelFor(sourcePages.size(), [&](size_t i)
+		{
+			auto& page = *sourcePages[i];
+			const auto& file = *page.file;
+
+			if (!fs::exists(file.GetPath()))
+				return;
+			page.sourceHash = manifest.ComputeSourceHash(page.htmlFile.GetAbsolutePath(), file.GetPath());
+			page.hash = HtmlReportManifest::ComputePageHash(file, templateHash, page.sourceHash.content);
+			if (manifest.IsUpToDate(page.htmlFile.GetAbsolutePath(), page.hash))
 			{
-				const auto& modulePath = module->GetPath();
-				auto moduleFilename = module->GetPath().filename();
-				auto moduleTemplateDictionary = exporter_.CreateTemplateDictionary(moduleFilename.wstring(), L"");
+				page.generatedOutput = page.htmlFile.GetRelativeLinkPath();
+				++upToDatePageCount;
+			}
+			else
+				page.generatedOutput = ExportFile(page.htmlFile, file);
+		}, maxThreadCount_);
 
-				auto htmlModulePath = htmlFolderStructure.CreateCurrentModule(modulePath);
-				ExportFiles(coverageRateComputer, *module, htmlFolderStructure, *moduleTemplateDictionary);
+		for (const auto* page : sourcePages)
+		{
+			if (page->generatedOutput)
+				manifest.SetPageHash(page->htmlFile.GetAbsolutePath(), page->hash, page->sourceHash);
+		}
+		manifest.Save();
+		LOG_DEBUG << upToDatePageCount << L" source pages are up to date.";
+
+		for (const auto& modulePages : modulesPages)
+		{
+			const auto& module = *modulePages.module;
+			auto moduleFilename = module.GetPath().filename();
+			auto moduleTemplateDictionary = exporter_.CreateTemplateDictionary(moduleFilename.wstring(), L"");
 
-				exporter_.GenerateModuleTemplate(*moduleTemplateDictionary, htmlModulePath.GetAbsolutePath());				
-				exporter_.AddModuleSectionToDictionary(module->GetPath(), moduleCoverageRate, htmlModulePath.GetRelativeLinkPath(), *projectDictionary);
+			for (const auto& page : modulePages.pages)
+			{
+				exporter_.AddFileSectionToDictionary(
+					page.file->GetPath(),
+					coverageRateComputer.GetCoverageRate(*page.file),
+					page.generatedOutput.get_ptr(),
+					*moduleTemplateDictionary);
 			}
+
+			const auto& htmlModulePath = modulePages.htmlModulePath;
+			exporter_.GenerateModuleTemplate(*moduleTemplateDictionary, htmlModulePath.GetAbsolutePath());
+			exporter_.AddModuleSectionToDictionary(
+				module.GetPath(), 
+				coverageRateComputer.GetCoverageRate(module), 
+				htmlModulePath.GetRelativeLinkPath(), 
+				*projectDictionary);
 		}
 
 		exporter_.GenerateProjectTemplate(*projectDictionary, outputFolder / L"index.html");
 		Tools::ShowOutputMessage(L"Coverage generated in Folder ", outputFolder);
 	}	
 
-	//---------------------------------------------------------------------
-	void HtmlExporter::ExportFiles(
-		cov::CoverageRateComputer& coverageRateComputer,
-		const cov::ModuleCoverage& module,
-		const HtmlFolderStructure& htmlFolderStructure, 
-		ctemplate::TemplateDictionary& moduleTemplateDictionary)
-	{
-		for (const auto& file : coverageRateComputer.SortFilesByCoverageRate(module))
-		{
-			const auto& fileCoverageRate = coverageRateComputer.GetCoverageRate(*file);
-			boost::optional<fs::path> generatedOutput = ExportFile(htmlFolderStructure, *file);
-			exporter_.AddFileSectionToDictionary(
-				file->GetPath(), 
-				fileCoverageRate, 
-				generatedOutput.get_ptr(), 
-				moduleTemplateDictionary);
-		}
-	}
-
 	//---------------------------------------------------------------------
 	boost::optional<fs::path> HtmlExporter::ExportFile(
-		const HtmlFolderStructure& htmlFolderStructure,
+		const HtmlFile& htmlFilePath,
 		const cov::FileCoverage& fileCoverage) const
 	{
-		auto htmlFilePath = htmlFolderStructure.GetHtmlFilePath(fileCoverage.GetPath());
-		std::wostringstream ostr;
+		std::string codeContent;
 		
 		if (!fs::exists(fileCoverage.GetPath()))
 			return boost::optional<fs::path>();
 
-		auto enableCodePrettify = fileCoverageExporter_.Export(fileCoverage, ostr);
+		fileCoverageExporter_.Export(fileCoverage, codeContent);
 
 		auto title = fileCoverage.GetPath().filename().wstring();
-		exporter_.GenerateSourceTemplate(
-			title, ostr.str(), enableCodePrettify, htmlFilePath.GetAbsolutePath());
+		exporter_.GenerateSourceTemplate(title, codeContent, htmlFilePath.GetAbsolutePath());
 
 		return htmlFilePath.GetRelativeLinkPath();
 	}	
 }
-
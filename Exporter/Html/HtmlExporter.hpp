@@ -43,6 +43,7 @@ namespace boost
 namespace Exporter
 {
 	class HtmlFolderStructure;
+	class HtmlFile;
 
 	class EXPORTER_DLL HtmlExporter: public IExporter
 	{
@@ -50,29 +51,30 @@ namespace Exporter
 		static const std::wstring WarningExitCodeMessage;
 
 	public:
-		explicit HtmlExporter(const boost::filesystem::path& templateFolder);
+		// maxThreadCount is the number of threads generating source pages,
+		// 0 means one thread per hardware core.
+		explicit HtmlExporter(const boost::filesystem::path& templateFolder, size_t maxThreadCount = 0);
 
 		boost::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
 		void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& outputFolder) override;
+		void Export(
+			const CppCoverage::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const boost::filesystem::path& outputFolder) override;
 
 	private:
 		HtmlExporter(const HtmlExporter&) = delete;
 		HtmlExporter& operator=(const HtmlExporter&) = delete;
 
 		boost::optional<boost::filesystem::path> ExportFile(
-			const HtmlFolderStructure& htmlFolderStructure,
+			const HtmlFile& htmlFile,
 			const CppCoverage::FileCoverage& fileCoverage) const;
 
-		void ExportFiles(
-			CppCoverage::CoverageRateComputer&,
-			const CppCoverage::ModuleCoverage& module,
-			const HtmlFolderStructure& htmlFolderStructure,
-			ctemplate::TemplateDictionary& moduleTemplateDictionary);
-
 	private:
 		TemplateHtmlExporter exporter_;
 		HtmlFileCoverageExporter fileCoverageExporter_;
 		boost::filesystem::path templateFolder_;
+		size_t maxThreadCount_;
 	};
 }
 
@@ -17,14 +17,18 @@
 #include "stdafx.h"
 #include "HtmlFileCoverageExporter.hpp"
 
-#include <fstream>
+#include <algorithm>
+#include <intrin.h>
+#include <emmintrin.h>
 #include <boost/filesystem.hpp>
-#include <boost/spirit/include/classic.hpp>
-#include <boost/spirit/include/classic_tree_to_xml.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 
 #include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/BitwiseOperations.hpp"
 
 #include "../ExporterException.hpp"
+#include "CppLexer.hpp"
 
 namespace fs = boost::filesystem;
 namespace cov = CppCoverage;
@@ -33,121 +37,372 @@ namespace Exporter
 {
 	namespace
 	{
+		const std::string Utf8Bom = "\xEF\xBB\xBF";
+
+		//---------------------------------------------------------------------
+		bool IsSpecialChar(char c)
+		{
+			return c == '\n' || c == '\r' || c == '&' || c == '<' || c == '>';
+		}
+
 		//---------------------------------------------------------------------
-		bool HaveSameCoverage(
-			const cov::LineCoverage* lineCoverage,
-			const cov::LineCoverage* otherLineCoverage)
+		const char* FindSpecialCharScalar(const char* begin, const char* end)
 		{
-			if (!lineCoverage || !otherLineCoverage)
-				return lineCoverage == otherLineCoverage;
-			return lineCoverage->HasBeenExecuted() == otherLineCoverage->HasBeenExecuted();
+			while (begin != end && !IsSpecialChar(*begin))
+				++begin;
+			return begin;
 		}
 
 		//---------------------------------------------------------------------
-		std::wstring GetStyle(const cov::LineCoverage* lineCoverage)
+		// Compare 16 bytes at once with each special char.
+		const char* FindSpecialCharSse2(const char* begin, const char* end)
 		{
-			if (!lineCoverage)
-				return L"";
+			const auto newLine = _mm_set1_epi8('\n');
+			const auto carriageReturn = _mm_set1_epi8('\r');
+			const auto ampersand = _mm_set1_epi8('&');
+			const auto lessThan = _mm_set1_epi8('<');
+			const auto greaterThan = _mm_set1_epi8('>');
 
-			return (lineCoverage->HasBeenExecuted())
-				? HtmlFileCoverageExporter::StyleBackgroundColorExecuted
-				: HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted;
+			for (; end - begin >= 16; begin += 16)
+			{
+				auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+				auto matches = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(block, newLine), _mm_cmpeq_epi8(block, carriageReturn)),
+					_mm_or_si128(_mm_cmpeq_epi8(block, ampersand), 
+						_mm_or_si128(_mm_cmpeq_epi8(block, lessThan), _mm_cmpeq_epi8(block, greaterThan))));
+				auto mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+
+				if (mask)
+				{
+					unsigned long index = 0;
+
+					_BitScanForward(&index, mask);
+					return begin + index;
+				}
+			}
+			return FindSpecialCharScalar(begin, end);
 		}
 
 		//---------------------------------------------------------------------
-		void AddEndStyleIfNeeded(
-			std::wostream& output,
-			const cov::LineCoverage* previousLineCoverage)
+		bool IsAscii(const char* begin, const char* end, bool useSse2)
 		{
-			if (previousLineCoverage)
-				output << HtmlFileCoverageExporter::EndStyle;
+			for (; useSse2 && end - begin >= 16; begin += 16)
+			{
+				auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+				if (_mm_movemask_epi8(block))
+					return false;
+			}
+			for (; begin != end; ++begin)
+			{
+				if (static_cast<unsigned char>(*begin) >= 0x80)
+					return false;
+			}
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsValidUtf8(const char* begin, const char* end)
+		{
+			while (begin != end)
+			{
+				auto c = static_cast<unsigned char>(*begin++);
+				int continuationCount = 0;
+				unsigned int codePoint = 0;
+
+				if (c < 0x80)
+					continue;
+				else if (c >= 0xC2 && c <= 0xDF)
+				{
+					continuationCount = 1;
+					codePoint = c & 0x1F;
+				}
+				else if (c >= 0xE0 && c <= 0xEF)
+				{
+					continuationCount = 2;
+					codePoint = c & 0x0F;
+				}
+				else if (c >= 0xF0 && c <= 0xF4)
+				{
+					continuationCount = 3;
+					codePoint = c & 0x07;
+				}
+				else
+					return false;
+
+				if (end - begin < continuationCount)
+					return false;
+				for (int i = 0; i < continuationCount; ++i)
+				{
+					auto continuation = static_cast<unsigned char>(*begin++);
+
+					if ((continuation & 0xC0) != 0x80)
+						return false;
+					codePoint = (codePoint << 6) | (continuation & 0x3F);
+				}
+
+				// Reject overlong encodings, surrogates and values after U+10FFFF.
+				if ((continuationCount == 2 && codePoint < 0x800) ||
+					(continuationCount == 3 && (codePoint < 0x10000 || codePoint > 0x10FFFF)) ||
+					(codePoint >= 0xD800 && codePoint <= 0xDFFF))
+				{
+					return false;
+				}
+			}
+			return true;
 		}
 
 		//---------------------------------------------------------------------
-		bool AddLineCoverageColor(
-			std::wostream& output,
-			const std::wstring& line, 
-			const cov::LineCoverage* lineCoverage,
-			const cov::LineCoverage* previousLineCoverage)
+		std::string Latin1ToUtf8(const char* begin, const char* end)
 		{
-			if (HaveSameCoverage(lineCoverage, previousLineCoverage))
+			std::string utf8;
+
+			utf8.reserve((end - begin) * 2);
+			for (; begin != end; ++begin)
 			{
-				output << std::endl << line;
-				return false;
+				auto c = static_cast<unsigned char>(*begin);
+
+				if (c < 0x80)
+					utf8 += static_cast<char>(c);
+				else
+				{
+					utf8 += static_cast<char>(0xC0 | (c >> 6));
+					utf8 += static_cast<char>(0x80 | (c & 0x3F));
+				}
 			}
-			
-			AddEndStyleIfNeeded(output, previousLineCoverage);
-			auto style = GetStyle(lineCoverage);
+			return utf8;
+		}
 
-			output << std::endl;			
-			output << style << line;
+		//---------------------------------------------------------------------
+		// Same CSS classes as prettify.
+		const std::string* GetTokenStyle(CppTokenType tokenType)
+		{
+			static const std::string KeywordStyle = "<span class=\"kwd\">";
+			static const std::string LiteralStyle = "<span class=\"lit\">";
+			static const std::string StringStyle = "<span class=\"str\">";
+			static const std::string CommentStyle = "<span class=\"com\">";
+			static const std::string PreprocessorStyle = "<span class=\"dec\">";
 
-			return !style.empty();
+			switch (tokenType)
+			{
+				case CppTokenType::Keyword: return &KeywordStyle;
+				case CppTokenType::Literal: return &LiteralStyle;
+				case CppTokenType::String: return &StringStyle;
+				case CppTokenType::Comment: return &CommentStyle;
+				case CppTokenType::Preprocessor: return &PreprocessorStyle;
+				default: return nullptr;
+			}
 		}
 
-		const std::wstring StyleBackgroundColor = L"<span style = \"background-color:#";
-	}
+		//---------------------------------------------------------------------
+		class SourceColorizer
+		{
+		public:
+			//-----------------------------------------------------------------
+			SourceColorizer(const cov::FileCoverage& fileCoverage, std::string& output, bool useSse2)
+				: output_(output)
+				, currentLine_{ fileCoverage.GetLines().begin() }
+				, endLine_{ fileCoverage.GetLines().end() }
+				, previousLineCoverage_{ nullptr }
+				, sourceEnd_{ nullptr }
+				, useSse2_{ useSse2 }
+				, isLineStarted_{ false }
+				, lineCount_{ 0 }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			void Colorize(const char* begin, const char* end)
+			{
+				// Size of the source, the syntax highlighting and the coverage styles.
+				output_.reserve(output_.size() + 2 * (end - begin));
 
-	const std::wstring HtmlFileCoverageExporter::StyleBackgroundColorExecuted = 
-		StyleBackgroundColor + L"dfd" + L"\">";
-	const std::wstring HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted = 
-		StyleBackgroundColor + L"fdd" + L"\">";
-	const std::wstring HtmlFileCoverageExporter::EndStyle = L"</span>";
+				CppLexer lexer{ begin, end };
+				CppToken token;
 
-	//-------------------------------------------------------------------------
-	HtmlFileCoverageExporter::HtmlFileCoverageExporter(
-		int maxSourceLineCount,
-		int maxSourceLineStyleChangesCount,
-		int maxStyleChangesCount)
-		: maxSourceLineCount_{ maxSourceLineCount }
-		, maxSourceLineStyleChangesCount_{ maxSourceLineStyleChangesCount }
-		, maxStyleChangesCount_{ maxStyleChangesCount }
-	{
+				sourceEnd_ = end;
+				while (lexer.Next(token))
+					AppendToken(token);
+				if (previousLineCoverage_)
+					output_ += HtmlFileCoverageExporter::EndStyle;
+			}
+
+		private:
+			SourceColorizer(const SourceColorizer&) = delete;
+			SourceColorizer& operator=(const SourceColorizer&) = delete;
+
+			//-----------------------------------------------------------------
+			// Coverage lines are sorted so there is no lookup.
+			const cov::LineCoverage* GetLineCoverage(unsigned int lineNumber)
+			{
+				while (currentLine_ != endLine_ && currentLine_->GetLineNumber() < lineNumber)
+					++currentLine_;
+				if (currentLine_ != endLine_ && currentLine_->GetLineNumber() == lineNumber)
+					return &*currentLine_;
+				return nullptr;
+			}
+
+			//-----------------------------------------------------------------
+			void StartLine()
+			{
+				auto lineCoverage = GetLineCoverage(++lineCount_);
+				auto isSameCoverage = HaveSameCoverage(lineCoverage, previousLineCoverage_);
+
+				if (!isSameCoverage && previousLineCoverage_)
+					output_ += HtmlFileCoverageExporter::EndStyle;
+				output_ += '\n';
+				AppendLineNumber();
+				if (!isSameCoverage && lineCoverage)
+				{
+					output_ += (lineCoverage->HasBeenExecuted())
+						? HtmlFileCoverageExporter::StyleBackgroundColorExecuted
+						: HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted;
+				}
+				previousLineCoverage_ = lineCoverage;
+				isLineStarted_ = true;
+			}
+
+			//-----------------------------------------------------------------
+			void AppendLineNumber()
+			{
+				char digits[16];
+				auto digitsEnd = std::end(digits);
+				auto digitsBegin = digitsEnd;
+
+				for (auto value = lineCount_; value != 0; value /= 10)
+					*--digitsBegin = static_cast<char>('0' + value % 10);
+
+				output_ += HtmlFileCoverageExporter::StyleLineNumber;
+				output_.append(digitsBegin, digitsEnd);
+				output_ += HtmlFileCoverageExporter::EndStyle;
+			}
+
+			//-----------------------------------------------------------------
+			// Token styles are closed at the end of each line so that they are
+			// nested in the coverage styles which can contain several lines.
+			void AppendToken(const CppToken& token)
+			{
+				const auto* tokenStyle = GetTokenStyle(token.type);
+				auto begin = token.begin;
+
+				while (begin != token.end)
+				{
+					if (!isLineStarted_)
+						StartLine();
+					if (tokenStyle)
+						output_ += *tokenStyle;
+					begin = AppendLine(begin, token.end);
+					if (tokenStyle)
+						output_ += HtmlFileCoverageExporter::EndStyle;
+				}
+			}
+
+			//-----------------------------------------------------------------
+			// Append the escaped text until the end of the line and return the
+			// start of the next line or end.
+			// "\r\n" ends a line like '\n', other '\r' are written as "\r".
+			const char* AppendLine(const char* begin, const char* end)
+			{
+				while (true)
+				{
+					auto special = useSse2_ ? FindSpecialCharSse2(begin, end) : FindSpecialCharScalar(begin, end);
+
+					output_.append(begin, special);
+					if (special == end)
+						return end;
+					begin = special + 1;
+					switch (*special)
+					{
+						case '\n': 
+							isLineStarted_ = false;
+							return begin;
+						case '\r':
+							// The '\n' can be in the next token.
+							if (begin == sourceEnd_ || *begin != '\n')
+								output_ += "\\r";
+							break;
+						case '&': output_ += "&amp;"; break;
+						case '<': output_ += "&lt;"; break;
+						case '>': output_ += "&gt;"; break;
+					}
+				}
+			}
+
+			//-----------------------------------------------------------------
+			static bool HaveSameCoverage(
+				const cov::LineCoverage* lineCoverage,
+				const cov::LineCoverage* otherLineCoverage)
+			{
+				if (!lineCoverage || !otherLineCoverage)
+					return lineCoverage == otherLineCoverage;
+				return lineCoverage->HasBeenExecuted() == otherLineCoverage->HasBeenExecuted();
+			}
+
+			std::string& output_;
+			std::vector<cov::LineCoverage>::const_iterator currentLine_;
+			std::vector<cov::LineCoverage>::const_iterator endLine_;
+			const cov::LineCoverage* previousLineCoverage_;
+			const char* sourceEnd_;
+			bool useSse2_;
+			bool isLineStarted_;
+			unsigned int lineCount_;
+		};
+
+		const std::string StyleBackgroundColor = "<span style = \"background-color:#";
 	}
 
+	const std::string HtmlFileCoverageExporter::StyleBackgroundColorExecuted = 
+		StyleBackgroundColor + "dfd" + "\">";
+	const std::string HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted = 
+		StyleBackgroundColor + "fdd" + "\">";
+	const std::string HtmlFileCoverageExporter::StyleLineNumber = "<span class=\"lno\">";
+	const std::string HtmlFileCoverageExporter::EndStyle = "</span>";
+
 	//-------------------------------------------------------------------------
-	bool HtmlFileCoverageExporter::Export(
+	void HtmlFileCoverageExporter::Export(
 		const cov::FileCoverage& fileCoverage,
-		std::wostream& output) const
+		std::string& output) const
 	{
-		auto filePath = fileCoverage.GetPath();
+		const auto& filePath = fileCoverage.GetPath();
+		boost::system::error_code error;
+		auto fileSize = fs::file_size(filePath, error);
 
-		std::wifstream ifs{filePath.string()};
-		if (!ifs)
+		if (error)
 			THROW(L"Cannot open file : " + filePath.wstring());
 
-		std::wstring line;
-		const cov::LineCoverage* previousLineCoverage = nullptr;
-		int styleChangesCount = 0;
-		int lineCount = 0;
-		for (int i = 1; std::getline(ifs, line); ++i)
-		{			
-			auto lineCoverage = fileCoverage[i];
-			
-			line = boost::spirit::classic::xml::encode(line);				
-			if (AddLineCoverageColor(output, line, lineCoverage, previousLineCoverage))
-				++styleChangesCount;
-			++lineCount;
-			previousLineCoverage = lineCoverage;
-		}
-		AddEndStyleIfNeeded(output, previousLineCoverage);
-		output.flush();
+		auto useSse2 = cov::GetSupportedInstructionSet() != cov::InstructionSet::Scalar;
+		SourceColorizer colorizer{ fileCoverage, output, useSse2 };
 
-		return MustEnableCodePrettify(lineCount, styleChangesCount);
-	}
+		// An empty file cannot be mapped.
+		if (fileSize != 0)
+		{
+			boost::iostreams::mapped_file_source mappedFile;
 
-	//-------------------------------------------------------------------------
-	bool HtmlFileCoverageExporter::MustEnableCodePrettify(
-		int lineCount,
-		int styleChangesCount) const
-	{
-		if (lineCount > maxSourceLineCount_)
-			return false;
-
-		auto ratio = static_cast<double>(maxSourceLineStyleChangesCount_ - maxStyleChangesCount_) 
-			/ (maxSourceLineCount_ - maxStyleChangesCount_);
-		auto maxStyleChanges = maxStyleChangesCount_ + (lineCount - maxStyleChangesCount_) * ratio;
-		
-		return styleChangesCount <= maxStyleChanges;
+			try
+			{
+				mappedFile.open(filePath.string());
+			}
+			catch (const std::exception&)
+			{
+				THROW(L"Cannot open file : " + filePath.wstring());
+			}
+
+			const char* begin = mappedFile.data();
+			const char* end = begin + mappedFile.size();
+
+			if (IsAscii(begin, end, useSse2))
+				colorizer.Colorize(begin, end);
+			else if (IsValidUtf8(begin, end))
+			{
+				if (std::string(begin, std::min<size_t>(end - begin, Utf8Bom.size())) == Utf8Bom)
+					begin += Utf8Bom.size();
+				colorizer.Colorize(begin, end);
+			}
+			else
+			{
+				auto utf8Source = Latin1ToUtf8(begin, end);
+				colorizer.Colorize(utf8Source.data(), utf8Source.data() + utf8Source.size());
+			}
+		}
 	}
 }
@@ -16,7 +16,7 @@
 
 #pragma once
 
-#include <iosfwd> 
+#include <string>
 
 #include "../ExporterExport.hpp"
 
@@ -38,30 +38,23 @@ namespace Exporter
 	class EXPORTER_DLL HtmlFileCoverageExporter
 	{
 	public:
-		static const std::wstring StyleBackgroundColorExecuted;
-		static const std::wstring StyleBackgroundColorUnexecuted;
-		static const std::wstring EndStyle;
+		static const std::string StyleBackgroundColorExecuted;
+		static const std::string StyleBackgroundColorUnexecuted;
+		static const std::string StyleLineNumber;
+		static const std::string EndStyle;
 
 	public:
-		HtmlFileCoverageExporter(
-			int maxSourceLineCount = 8000, 
-			int maxSourceLineStyleChangesCount = 1000,
-			int maxStyleChangesCount = 2000);
+		HtmlFileCoverageExporter() = default;
 
-		bool Export(
+		// Append to output the HTML source of the file as UTF-8. Each line is
+		// prefixed by '\n' and its line number, colored according to its coverage
+		// and highlighted as C++. Sources that are not valid UTF-8 are read as Latin-1.
+		void Export(
 			const CppCoverage::FileCoverage&,
-			std::wostream& output) const;
-		
-		bool MustEnableCodePrettify(int lineCount, int styleChangedCount) const;
+			std::string& output) const;
 
 	private:
 		HtmlFileCoverageExporter(const HtmlFileCoverageExporter&) = delete;
 		HtmlFileCoverageExporter& operator=(const HtmlFileCoverageExporter&) = delete;
-
-		int maxSourceLineCount_;
-		int maxSourceLineStyleChangesCount_;
-		int maxStyleChangesCount_;
 	};
 }
-
-
@@ -0,0 +1,224 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "HtmlReportManifest.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "Tools/Tool.hpp"
+#include "Tools/Log.hpp"
+
+#include "../ExporterException.hpp"
+
+namespace fs = boost::filesystem;
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		// Increase when the generation of the source pages changes.
+		const int ManifestVersion = 3;
+		const std::string ManifestHeader = "OpenCppCoverage HTML manifest ";
+
+		const HtmlReportManifest::T_Hash FnvOffsetBasis = 14695981039346656037ULL;
+		const HtmlReportManifest::T_Hash FnvPrime = 1099511628211ULL;
+
+		//---------------------------------------------------------------------
+		void UpdateHash(HtmlReportManifest::T_Hash& hash, const char* data, size_t size)
+		{
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= static_cast<unsigned char>(data[i]);
+				hash *= FnvPrime;
+			}
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void UpdateHash(HtmlReportManifest::T_Hash& hash, T value)
+		{
+			UpdateHash(hash, reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		//---------------------------------------------------------------------
+		// Keys come from a file that can be edited: only paths inside the
+		// output folder can be removed.
+		bool IsInFolder(const fs::path& folder, const fs::path& relativePath)
+		{
+			if (relativePath.empty() || relativePath.has_root_path())
+				return false;
+			for (const auto& part : relativePath)
+			{
+				if (part == "..")
+					return false;
+			}
+
+			// Symbolic links can still point outside the folder.
+			boost::system::error_code folderError;
+			boost::system::error_code pathError;
+			auto canonicalFolder = fs::weakly_canonical(folder, folderError);
+			auto canonicalPath = fs::weakly_canonical(folder / relativePath, pathError);
+
+			if (folderError || pathError)
+				return false;
+
+			auto relativeToFolder = canonicalPath.lexically_relative(canonicalFolder);
+
+			return !relativeToFolder.empty() && *relativeToFolder.begin() != "..";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring HtmlReportManifest::Filename = L"ReportManifest.txt";
+
+	//-------------------------------------------------------------------------
+	HtmlReportManifest::HtmlReportManifest(const fs::path& outputFolder)
+		: outputFolder_{ outputFolder }
+	{
+		std::ifstream ifs{ (outputFolder / Filename).string() };
+		std::string line;
+
+		if (!ifs || !std::getline(ifs, line) || line != ManifestHeader + std::to_string(ManifestVersion))
+			return;
+
+		while (std::getline(ifs, line))
+		{
+			std::istringstream istr{ line };
+			PageHash pageHash;
+			std::string key;
+
+			if (istr >> std::hex >> pageHash.hash >> pageHash.sourceHash.stamp >> pageHash.sourceHash.content
+				&& istr.get() == ' ' && std::getline(istr, key))
+			{
+				previousHashes_.emplace(Tools::Utf8ToWString(key), pageHash);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	HtmlReportManifest::T_Hash HtmlReportManifest::ComputeFileHash(const fs::path& path)
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+		std::vector<char> buffer(64 * 1024);
+		T_Hash hash = FnvOffsetBasis;
+
+		if (!ifs)
+			THROW(L"Cannot open file: " << path.wstring());
+		while (ifs.read(buffer.data(), buffer.size()) || ifs.gcount())
+			UpdateHash(hash, buffer.data(), static_cast<size_t>(ifs.gcount()));
+		return hash;
+	}
+
+	//-------------------------------------------------------------------------
+	HtmlReportManifest::T_Hash HtmlReportManifest::ComputePageHash(
+		const cov::FileCoverage& fileCoverage,
+		T_Hash templateHash,
+		T_Hash sourceHash)
+	{
+		T_Hash hash = FnvOffsetBasis;
+		const auto& path = fileCoverage.GetPath().wstring();
+
+		UpdateHash(hash, ManifestVersion);
+		UpdateHash(hash, templateHash);
+		UpdateHash(hash, reinterpret_cast<const char*>(path.data()), path.size() * sizeof(wchar_t));
+		UpdateHash(hash, sourceHash);
+		for (const auto& line : fileCoverage.GetLines())
+		{
+			UpdateHash(hash, line.GetLineNumber());
+			UpdateHash(hash, line.HasBeenExecuted());
+		}
+		return hash;
+	}
+
+	//-------------------------------------------------------------------------
+	HtmlReportManifest::SourceHash HtmlReportManifest::ComputeSourceHash(
+		const fs::path& htmlFile,
+		const fs::path& source) const
+	{
+		SourceHash sourceHash{ FnvOffsetBasis, 0 };
+
+		// Like make, a change in the same second that keeps the size is not detected.
+		UpdateHash(sourceHash.stamp, fs::file_size(source));
+		UpdateHash(sourceHash.stamp, fs::last_write_time(source));
+
+		auto it = previousHashes_.find(GetKey(htmlFile));
+		if (it != previousHashes_.end() && it->second.sourceHash.stamp == sourceHash.stamp)
+			sourceHash.content = it->second.sourceHash.content;
+		else
+			sourceHash.content = ComputeFileHash(source);
+		return sourceHash;
+	}
+
+	//-------------------------------------------------------------------------
+	bool HtmlReportManifest::IsUpToDate(const fs::path& htmlFile, T_Hash hash) const
+	{
+		auto it = previousHashes_.find(GetKey(htmlFile));
+
+		return it != previousHashes_.end() && it->second.hash == hash && fs::exists(htmlFile);
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlReportManifest::SetPageHash(const fs::path& htmlFile, T_Hash hash, const SourceHash& sourceHash)
+	{
+		hashes_[GetKey(htmlFile)] = PageHash{ hash, sourceHash };
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlReportManifest::Save() const
+	{
+		auto manifestPath = outputFolder_ / Filename;
+		std::ofstream ofs{ manifestPath.string() };
+
+		if (!ofs)
+			THROW(L"Cannot write file: " << manifestPath.wstring());
+		ofs << ManifestHeader << ManifestVersion << '\n';
+		ofs << std::hex << std::setfill('0');
+		for (const auto& pair : hashes_)
+		{
+			const auto& pageHash = pair.second;
+
+			ofs << std::setw(16) << pageHash.hash << ' '
+				<< std::setw(16) << pageHash.sourceHash.stamp << ' '
+				<< std::setw(16) << pageHash.sourceHash.content << ' '
+				<< Tools::ToUtf8String(pair.first) << '\n';
+		}
+
+		for (const auto& pair : previousHashes_)
+		{
+			if (hashes_.count(pair.first) == 0 && IsInFolder(outputFolder_, pair.first))
+			{
+				boost::system::error_code error;
+
+				LOG_DEBUG << L"Remove previous page: " << pair.first;
+				fs::remove(outputFolder_ / pair.first, error);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring HtmlReportManifest::GetKey(const fs::path& htmlFile) const
+	{
+		return htmlFile.lexically_relative(outputFolder_).generic_wstring();
+	}
+}
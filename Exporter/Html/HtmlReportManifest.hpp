@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "../ExporterExport.hpp"
+
+namespace CppCoverage
+{
+	class FileCoverage;
+}
+
+namespace Exporter
+{
+	// List of the source pages of an HTML report with the hash of what was used
+	// to generate them: the source file, its line coverage and the template.
+	// A page whose hash did not change since the previous report does not need
+	// to be generated again.
+	class EXPORTER_DLL HtmlReportManifest
+	{
+	public:
+		typedef unsigned long long T_Hash;
+
+		// stamp is the hash of the size and the last write time of the source.
+		struct SourceHash
+		{
+			T_Hash stamp;
+			T_Hash content;
+		};
+
+		static const std::wstring Filename;
+
+		// Load the manifest of the report in outputFolder if it exists.
+		explicit HtmlReportManifest(const boost::filesystem::path& outputFolder);
+
+		static T_Hash ComputeFileHash(const boost::filesystem::path&);
+		static T_Hash ComputePageHash(const CppCoverage::FileCoverage&, T_Hash templateHash, T_Hash sourceHash);
+
+		// The source is only read when its stamp is not the one saved for htmlFile.
+		// Thread safe as long as SetPageHash is not called.
+		SourceHash ComputeSourceHash(const boost::filesystem::path& htmlFile, const boost::filesystem::path& source) const;
+
+		// Thread safe as long as SetPageHash is not called.
+		bool IsUpToDate(const boost::filesystem::path& htmlFile, T_Hash) const;
+		void SetPageHash(const boost::filesystem::path& htmlFile, T_Hash, const SourceHash&);
+
+		// Write the manifest and remove the pages of the previous report
+		// that are not part of this one.
+		void Save() const;
+
+	private:
+		HtmlReportManifest(const HtmlReportManifest&) = delete;
+		HtmlReportManifest& operator=(const HtmlReportManifest&) = delete;
+
+		std::wstring GetKey(const boost::filesystem::path& htmlFile) const;
+
+		struct PageHash
+		{
+			T_Hash hash;
+			SourceHash sourceHash;
+		};
+
+		boost::filesystem::path outputFolder_;
+		std::map<std::wstring, PageHash> previousHashes_;
+		std::map<std::wstring, PageHash> hashes_;
+	};
+}
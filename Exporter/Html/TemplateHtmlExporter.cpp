@@ -17,6 +17,9 @@
 #include "stdafx.h"
 #include "TemplateHtmlExporter.hpp"
 
+#include <cstring>
+#include <fstream>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -54,38 +57,62 @@ namespace Exporter
 		}
 
 		//-------------------------------------------------------------------------
-		void WriteContentTo(const std::string& content, const fs::path& path)
+		// Write the expanded template directly to the file, without building
+		// the whole page in memory.
+		class FileExpandEmitter : public ctemplate::ExpandEmitter
 		{
-			std::ofstream ofs(path.string(), std::ios::binary);
+		public:
+			//---------------------------------------------------------------------
+			explicit FileExpandEmitter(const fs::path& path)
+				: path_{ path }
+				, buffer_(BufferSize)
+			{
+				ofs_.open(path.string(), std::ios::binary);
+				if (!ofs_)
+					THROW(L"Cannot open file" << path);
+				// The buffer of the file stream is set once the file is opened.
+				ofs_.rdbuf()->pubsetbuf(&buffer_[0], buffer_.size());
+			}
 
-			if (!ofs)
-				THROW(L"Cannot open file" << path);
-			ofs << content;
-			ofs.flush();
-		}
+			//---------------------------------------------------------------------
+			void Emit(char c) override
+			{
+				ofs_.put(c);
+			}
 
-		//-------------------------------------------------------------------------
-		std::string GenerateTemplate(
-			const ctemplate::TemplateDictionary& templateDictionary,
-			const fs::path& templatePath)
-		{
-			std::string output;
+			//---------------------------------------------------------------------
+			void Emit(const std::string& str) override
+			{
+				ofs_.write(str.data(), str.size());
+			}
 
-			if (!ctemplate::ExpandTemplate(templatePath.string(), ctemplate::DO_NOT_STRIP, &templateDictionary, &output))
-				THROW(L"Cannot generate output for " + templatePath.wstring());
+			//---------------------------------------------------------------------
+			void Emit(const char* str) override
+			{
+				ofs_.write(str, std::strlen(str));
+			}
 
-			return output;
-		}
-		
-		//-------------------------------------------------------------------------
-		void WriteTemplate(
-			const ctemplate::TemplateDictionary& templateDictionary,
-			const fs::path& templatePath,
-			const fs::path& output)
-		{			
-			std::string content = GenerateTemplate(templateDictionary, templatePath);
-			WriteContentTo(content, output);
-		}
+			//---------------------------------------------------------------------
+			void Emit(const char* str, size_t size) override
+			{
+				ofs_.write(str, size);
+			}
+
+			//---------------------------------------------------------------------
+			void Close()
+			{
+				ofs_.close();
+				if (!ofs_)
+					THROW(L"Cannot write file" << path_);
+			}
+
+		private:
+			static const size_t BufferSize = 64 * 1024;
+
+			fs::path path_;
+			std::vector<char> buffer_;
+			std::ofstream ofs_;
+		};
 	}
 	
 	//-------------------------------------------------------------------------
@@ -98,11 +125,6 @@ namespace Exporter
 	const std::string TemplateHtmlExporter::NameTemplate = "NAME";
 	const std::string TemplateHtmlExporter::ItemLinkSection = "ITEM_LINK";
 	const std::string TemplateHtmlExporter::ItemNoLinkSection = "ITEM_NO_LINK";
-	const std::string TemplateHtmlExporter::BodyOnLoadTemplate = "BODY_ON_LOAD";
-	const std::string TemplateHtmlExporter::SourceWarningMessageTemplate = "SOURCE_WARNING_MESSAGE";
-	const std::string TemplateHtmlExporter::BodyOnLoadFct = "prettyPrint()";
-	const std::string TemplateHtmlExporter::SyntaxHighlightingDisabledMsg 
-		= "Syntax highlighting has been disabled for performance reasons.";
 	const std::string TemplateHtmlExporter::MainMessageTemplate = "MAIN_MESSAGE";
 	const std::string TemplateHtmlExporter::CoverRateTemplate = "COVER_RATE";
 	const std::string TemplateHtmlExporter::UncoverRateTemplate = "UNCOVER_RATE";
@@ -116,9 +138,23 @@ namespace Exporter
 		const fs::path& fileTemplatePath)
 		: mainTemplatePath_(mainTemplatePath)
 		, fileTemplatePath_(fileTemplatePath)
+		, templateCache_(std::make_unique<ctemplate::TemplateCache>())
 	{		
 	}
 
+	//-------------------------------------------------------------------------
+	TemplateHtmlExporter::~TemplateHtmlExporter() = default;
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::LoadTemplates() const
+	{
+		for (const auto& templatePath : { mainTemplatePath_, fileTemplatePath_ })
+		{
+			if (!templateCache_->LoadTemplate(templatePath.string(), ctemplate::DO_NOT_STRIP))
+				THROW(L"Cannot load template " + templatePath.wstring());
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	std::unique_ptr<ctemplate::TemplateDictionary> 
 	TemplateHtmlExporter::CreateTemplateDictionary(
@@ -181,27 +217,34 @@ namespace Exporter
 	//-------------------------------------------------------------------------
 	void TemplateHtmlExporter::GenerateSourceTemplate(
 		const std::wstring& title,
-		const std::wstring& codeContent,
-		bool enableCodePrettify,
+		const std::string& utf8CodeContent,
 		const fs::path& output) const
 	{
 		auto titleStr = ToString(title);
 		ctemplate::TemplateDictionary dictionary(titleStr);
-		std::string bodyLoad = BodyOnLoadFct;
-		std::string warning = "";
-
-		if (!enableCodePrettify)
-		{
-			bodyLoad = "";
-			warning = SyntaxHighlightingDisabledMsg;
-		}
 
 		dictionary.SetValue(TitleTemplate, titleStr);
-		dictionary.SetValue(CodeTemplate, ToString(codeContent));
-		dictionary.SetValue(BodyOnLoadTemplate, bodyLoad);
-		dictionary.SetValue(SourceWarningMessageTemplate, warning);
+		dictionary.SetValueWithoutCopy(CodeTemplate, 
+			ctemplate::TemplateString(utf8CodeContent.data(), utf8CodeContent.size()));
 		WriteTemplate(dictionary, fileTemplatePath_, output);
 	}
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::WriteTemplate(
+		const ctemplate::TemplateDictionary& templateDictionary,
+		const fs::path& templatePath,
+		const fs::path& output) const
+	{
+		FileExpandEmitter emitter{ output };
+
+		// The cache is thread safe: pages can be generated in parallel.
+		if (!templateCache_->ExpandWithData(templatePath.string(), ctemplate::DO_NOT_STRIP, 
+			&templateDictionary, nullptr, &emitter))
+		{
+			THROW(L"Cannot generate output for " + templatePath.wstring());
+		}
+		emitter.Close();
+	}
 	//-------------------------------------------------------------------------
 	std::string TemplateHtmlExporter::GetUuid()
 	{
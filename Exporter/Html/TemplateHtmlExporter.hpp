@@ -33,6 +33,7 @@ namespace CppCoverage
 namespace ctemplate
 {
 	class TemplateDictionary;
+	class TemplateCache;
 }
 
 namespace fs = boost::filesystem;
@@ -53,10 +54,6 @@ namespace Exporter
 		static const std::string NameTemplate;
 		static const std::string ItemLinkSection;
 		static const std::string ItemNoLinkSection;
-		static const std::string BodyOnLoadTemplate;
-		static const std::string SourceWarningMessageTemplate;
-		static const std::string BodyOnLoadFct;
-		static const std::string SyntaxHighlightingDisabledMsg;
 		static const std::string MainMessageTemplate;
 		static const std::string CoverRateTemplate;
 		static const std::string UncoverRateTemplate;
@@ -68,6 +65,11 @@ namespace Exporter
 		explicit TemplateHtmlExporter(
 			const fs::path& mainTemplatePath,
 			const fs::path& fileTemplatePath);
+		~TemplateHtmlExporter();
+
+		// Parse the templates in the cache of this exporter. Templates not loaded
+		// are parsed on their first use.
+		void LoadTemplates() const;
 
 		std::unique_ptr<ctemplate::TemplateDictionary>	
 		CreateTemplateDictionary(const std::wstring& title, const std::wstring& message) const;
@@ -92,16 +94,20 @@ namespace Exporter
 			const ctemplate::TemplateDictionary& templateDictionary,
 			const fs::path&) const;
 
+		// utf8CodeContent is not copied and is written directly to output.
 		void GenerateSourceTemplate(
 			const std::wstring& title, 
-			const std::wstring& codeContent,
-			bool enableCodePrettify,
+			const std::string& utf8CodeContent,
 			const fs::path& output) const;
 
 	private:
 		TemplateHtmlExporter(const TemplateHtmlExporter&) = delete;
 		TemplateHtmlExporter& operator=(const TemplateHtmlExporter&) = delete;
 		std::string GetUuid();
+		void WriteTemplate(
+			const ctemplate::TemplateDictionary&,
+			const fs::path& templatePath,
+			const fs::path& output) const;
 		void FillSection(
 			ctemplate::TemplateDictionary&,
 			const fs::path* link,
@@ -111,6 +117,7 @@ namespace Exporter
 	private:
 		fs::path mainTemplatePath_;		
 		fs::path fileTemplatePath_;
+		std::unique_ptr<ctemplate::TemplateCache> templateCache_;
 		boost::uuids::random_generator uuidGenerator_;
 	};
 }
@@ -29,18 +29,33 @@ namespace boost
 namespace CppCoverage
 {
 	class CoverageData;
+	class CoverageRateComputer;
 }
 
 namespace Exporter
 {
+	// Exporters only read the coverage data: several exporters can export the
+	// same CoverageData at the same time, each one from its own thread.
+	// A single exporter instance does not support concurrent exports.
 	class EXPORTER_DLL IExporter
 	{
 	public:
 		IExporter() = default;
+		virtual ~IExporter() = default;
 
 		virtual boost::filesystem::path GetDefaultPath(const std::wstring& prefix) const = 0;
 		virtual void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& output) = 0;
 
+		// coverageRateComputer must have been built from coverageData. It is shared
+		// between concurrent exports so that the coverage rates are computed once.
+		virtual void Export(
+			const CppCoverage::CoverageData& coverageData,
+			const CppCoverage::CoverageRateComputer&,
+			const boost::filesystem::path& output)
+		{
+			Export(coverageData, output);
+		}
+
 	private:
 		IExporter(const IExporter&) = delete;
 		IExporter& operator=(const IExporter&) = delete;
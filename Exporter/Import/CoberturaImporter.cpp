@@ -0,0 +1,188 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoberturaImporter.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "../ExporterException.hpp"
+#include "CoverageDataBuilder.hpp"
+#include "XmlStreamReader.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		const size_t HeaderSize = 4096;
+
+		//---------------------------------------------------------------------
+		const std::string& GetAttribute(const XmlStreamReader& reader, const char* name)
+		{
+			const auto* value = reader.GetAttribute(name);
+
+			if (!value)
+			{
+				THROW(L"Attribute " << name << L" is missing for the Cobertura element "
+					<< reader.GetName().c_str() << L".");
+			}
+			return *value;
+		}
+
+		//---------------------------------------------------------------------
+		unsigned long long ToNumber(const XmlStreamReader& reader, const char* name)
+		{
+			const auto& value = GetAttribute(reader, name);
+			char* end = nullptr;
+			auto number = std::strtoull(value.c_str(), &end, 10);
+
+			if (value.empty() || *end)
+				THROW(L"Invalid value for the Cobertura attribute " << name << L": " << value.c_str());
+			return number;
+		}
+
+		//---------------------------------------------------------------------
+		cov::LineCoverage ReadLine(const XmlStreamReader& reader)
+		{
+			auto number = ToNumber(reader, "number");
+			auto hits = ToNumber(reader, "hits");
+
+			return cov::LineCoverage{ static_cast<unsigned int>(number), hits != 0 };
+		}
+
+		//---------------------------------------------------------------------
+		fs::path JoinSource(fs::path source, const fs::path& filename)
+		{
+			// CoberturaExporter writes the drive as source, for example "C:".
+			if (source.has_root_name() && !source.has_root_directory())
+				source += L"\\";
+			return source / filename;
+		}
+
+		//---------------------------------------------------------------------
+		fs::path ResolvePath(const std::vector<fs::path>& sources, const std::string& filename)
+		{
+			fs::path path{ Tools::Utf8ToWString(filename) };
+
+			if (path.is_absolute() || sources.empty())
+				return path;
+			if (sources.size() > 1)
+			{
+				for (const auto& source : sources)
+				{
+					auto sourcePath = JoinSource(source, path);
+
+					if (fs::exists(sourcePath))
+						return sourcePath;
+				}
+			}
+			return JoinSource(sources.front(), path);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoberturaImporter::IsCoberturaFile(const fs::path& path)
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+		std::string header(HeaderSize, '\0');
+
+		ifs.read(&header[0], header.size());
+		header.resize(static_cast<size_t>(ifs.gcount()));
+
+		auto begin = header.find_first_not_of("\xEF\xBB\xBF \t\r\n");
+		return begin != std::string::npos && header[begin] == '<'
+			&& header.find("<coverage", begin) != std::string::npos;
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData CoberturaImporter::Import(const fs::path& path) const
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+
+		if (!ifs)
+			THROW(L"Cannot open file " << path.wstring());
+		return Import(ifs, path.wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData CoberturaImporter::Import(std::istream& istr, const std::wstring& name) const
+	{
+		XmlStreamReader reader{ istr };
+		CoverageDataBuilder builder{ name };
+		std::vector<fs::path> sources;
+		boost::optional<std::string> source;
+		boost::optional<fs::path> file;
+		std::vector<cov::LineCoverage> lines;
+		int methodDepth = 0;
+
+		for (auto node = reader.Next(); node != XmlStreamReader::Node::EndOfFile; node = reader.Next())
+		{
+			const auto& element = reader.GetName();
+
+			if (node == XmlStreamReader::Node::StartElement)
+			{
+				if (element == "line")
+				{
+					if (file && methodDepth == 0)
+						lines.push_back(ReadLine(reader));
+				}
+				else if (element == "class")
+				{
+					file = ResolvePath(sources, GetAttribute(reader, "filename"));
+					lines.clear();
+				}
+				else if (element == "method")
+					++methodDepth;
+				else if (element == "package")
+					builder.SetModule(Tools::Utf8ToWString(GetAttribute(reader, "name")));
+				else if (element == "source")
+					source = std::string{};
+			}
+			else if (node == XmlStreamReader::Node::EndElement)
+			{
+				if (element == "class" && file)
+				{
+					builder.AddFile(*file, std::move(lines));
+					lines.clear();
+					file = boost::none;
+				}
+				else if (element == "method")
+					--methodDepth;
+				else if (element == "source" && source)
+				{
+					sources.push_back(Tools::Utf8ToWString(boost::algorithm::trim_copy(*source)));
+					source = boost::none;
+				}
+			}
+			else if (source)
+				*source += reader.GetText();
+		}
+
+		return builder.Build();
+	}
+}
@@ -0,0 +1,54 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "../ExporterExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Read a Cobertura report written for example by gcovr or CoberturaExporter.
+	// Each package becomes a module and each class a file. Relative filenames
+	// are resolved with the sources of the report. A line is executed when its
+	// hits attribute is not 0. Lines of the methods are ignored as they are
+	// already listed by their class.
+	class EXPORTER_DLL CoberturaImporter
+	{
+	public:
+		CoberturaImporter() = default;
+
+		static bool IsCoberturaFile(const boost::filesystem::path&);
+
+		CppCoverage::CoverageData Import(const boost::filesystem::path&) const;
+
+		// The report is parsed while it is read: memory usage depends only on
+		// the coverage data, not on the size of the XML.
+		CppCoverage::CoverageData Import(std::istream&, const std::wstring& name) const;
+
+	private:
+		CoberturaImporter(const CoberturaImporter&) = delete;
+		CoberturaImporter& operator=(const CoberturaImporter&) = delete;
+	};
+}
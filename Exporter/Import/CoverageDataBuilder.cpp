@@ -0,0 +1,127 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataBuilder.hpp"
+
+#include <algorithm>
+
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		void SortAndMergeLines(std::vector<cov::LineCoverage>& lines)
+		{
+			auto isLess = [](const cov::LineCoverage& line1, const cov::LineCoverage& line2)
+			{
+				return line1.GetLineNumber() < line2.GetLineNumber();
+			};
+
+			if (std::is_sorted(lines.begin(), lines.end(), isLess) &&
+				std::adjacent_find(lines.begin(), lines.end(), [](const cov::LineCoverage& line1, const cov::LineCoverage& line2)
+				{ return line1.GetLineNumber() == line2.GetLineNumber(); }) == lines.end())
+			{
+				return;
+			}
+
+			std::stable_sort(lines.begin(), lines.end(), isLess);
+
+			std::vector<cov::LineCoverage> mergedLines;
+			mergedLines.reserve(lines.size());
+			for (const auto& line : lines)
+			{
+				if (!mergedLines.empty() && mergedLines.back().GetLineNumber() == line.GetLineNumber())
+				{
+					if (line.HasBeenExecuted())
+						mergedLines.back() = line;
+				}
+				else
+					mergedLines.push_back(line);
+			}
+			lines = std::move(mergedLines);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataBuilder::CoverageDataBuilder(const std::wstring& name)
+		: coverageData_{ name, 0 }
+		, currentModule_{ nullptr }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataBuilder::SetModule(const boost::filesystem::path& path)
+	{
+		auto it = modules_.find(path.wstring());
+
+		if (it == modules_.end())
+		{
+			auto& moduleCoverage = coverageData_.AddModule(path);
+
+			it = modules_.emplace(path.wstring(), Module{ &moduleCoverage, {} }).first;
+		}
+		currentModule_ = &it->second;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataBuilder::AddFile(
+		const boost::filesystem::path& path,
+		std::vector<cov::LineCoverage>&& lines)
+	{
+		if (!currentModule_)
+			SetModule(coverageData_.GetName());
+
+		SortAndMergeLines(lines);
+
+		auto& files = currentModule_->files;
+		auto it = files.find(path.wstring());
+
+		if (it == files.end())
+		{
+			auto& file = currentModule_->moduleCoverage->AddFile(path);
+
+			file.AddLines(std::move(lines));
+			files.emplace(path.wstring(), &file);
+			return;
+		}
+
+		auto& file = *it->second;
+		for (const auto& line : lines)
+		{
+			const auto* existingLine = file[line.GetLineNumber()];
+
+			if (!existingLine)
+				file.AddLine(line.GetLineNumber(), line.HasBeenExecuted());
+			else if (line.HasBeenExecuted() && !existingLine->HasBeenExecuted())
+				file.UpdateLine(line.GetLineNumber(), true);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData CoverageDataBuilder::Build()
+	{
+		modules_.clear();
+		currentModule_ = nullptr;
+
+		return std::move(coverageData_);
+	}
+}
@@ -0,0 +1,65 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+namespace CppCoverage
+{
+	class ModuleCoverage;
+	class FileCoverage;
+}
+
+namespace Exporter
+{
+	// Build a CoverageData from the records of a foreign coverage format.
+	// The lines of a record are added in bulk. A file can be split in several
+	// records and a line can appear several times: a line is executed if
+	// one of its occurrences is executed.
+	class CoverageDataBuilder
+	{
+	public:
+		explicit CoverageDataBuilder(const std::wstring& name);
+
+		// Following files are added to this module.
+		void SetModule(const boost::filesystem::path&);
+
+		void AddFile(const boost::filesystem::path&, std::vector<CppCoverage::LineCoverage>&& lines);
+
+		CppCoverage::CoverageData Build();
+
+	private:
+		CoverageDataBuilder(const CoverageDataBuilder&) = delete;
+		CoverageDataBuilder& operator=(const CoverageDataBuilder&) = delete;
+
+		struct Module
+		{
+			CppCoverage::ModuleCoverage* moduleCoverage;
+			std::unordered_map<std::wstring, CppCoverage::FileCoverage*> files;
+		};
+
+		CppCoverage::CoverageData coverageData_;
+		std::unordered_map<std::wstring, Module> modules_;
+		Module* currentModule_;
+	};
+}
@@ -0,0 +1,633 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "GcovImporter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "Tools/ParallelFor.hpp"
+#include "Tools/Tool.hpp"
+
+#include "../ExporterException.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		const uint32_t NotesMagic = 0x67636e6f; // "gcno"
+		const uint32_t DataMagic = 0x67636461; // "gcda"
+		const uint32_t FunctionTag = 0x01000000;
+		const uint32_t BlocksTag = 0x01410000;
+		const uint32_t ArcsTag = 0x01430000;
+		const uint32_t LinesTag = 0x01450000;
+		const uint32_t ArcCountersTag = 0x01a10000;
+		const uint32_t ArcOnTreeFlag = 1;
+		const int MinSupportedVersion = 8;
+
+		//---------------------------------------------------------------------
+		// Records are made of 32 bits words written in the byte order of the compiler.
+		// Since gcc 12, lengths are in bytes and strings are not padded so words
+		// are not aligned anymore.
+		class GcovFileReader
+		{
+		public:
+			//-----------------------------------------------------------------
+			GcovFileReader(const fs::path& path, uint32_t magic)
+				: path_{ path }
+				, position_{ 0 }
+			{
+				std::ifstream ifs{ path.string(), std::ios::binary };
+
+				if (!ifs)
+					THROW(L"Cannot open " << path.wstring());
+				content_.assign(std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{});
+
+				if (content_.size() < 3 * sizeof(uint32_t) || ReadUnsigned() != magic)
+					THROW(path.wstring() << L" is not a gcov file written by this platform.");
+				majorVersion_ = ToMajorVersion(ReadUnsigned());
+				if (majorVersion_ < MinSupportedVersion)
+				{
+					THROW(path.wstring() << L" was written by gcc " << majorVersion_ <<
+						L". Only gcc " << MinSupportedVersion << L" and later are supported.");
+				}
+				stamp_ = ReadUnsigned();
+				if (majorVersion_ >= 12)
+					ReadUnsigned(); // checksum
+			}
+
+			//-----------------------------------------------------------------
+			uint32_t ReadUnsigned()
+			{
+				uint32_t value;
+
+				Read(&value, sizeof(value));
+				return value;
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t ReadCounter()
+			{
+				auto low = ReadUnsigned();
+				auto high = ReadUnsigned();
+
+				return (static_cast<uint64_t>(high) << 32) | low;
+			}
+
+			//-----------------------------------------------------------------
+			// The length includes the terminating null character and is 0 for a null string.
+			std::string ReadString()
+			{
+				auto length = ToBytes(ReadUnsigned());
+				std::string value;
+
+				if (length)
+				{
+					value.resize(length);
+					Read(&value[0], length);
+					value.resize(std::strlen(value.c_str()));
+				}
+				return value;
+			}
+
+			//-----------------------------------------------------------------
+			// Position after the record whose length has just been read.
+			size_t GetRecordEnd(uint32_t length) const
+			{
+				auto recordEnd = position_ + ToBytes(length);
+
+				if (recordEnd > content_.size())
+					ThrowTruncated();
+				return recordEnd;
+			}
+
+			//-----------------------------------------------------------------
+			size_t ToBytes(uint32_t length) const
+			{
+				return (majorVersion_ >= 12) ? length : static_cast<size_t>(length) * sizeof(uint32_t);
+			}
+
+			//-----------------------------------------------------------------
+			// Files end with a tag 0.
+			uint32_t ReadNextTag()
+			{
+				return (position_ + sizeof(uint32_t) > content_.size()) ? 0 : ReadUnsigned();
+			}
+
+			//-----------------------------------------------------------------
+			size_t GetPosition() const { return position_; }
+			void SetPosition(size_t position) { position_ = position; }
+			int GetMajorVersion() const { return majorVersion_; }
+			uint32_t GetStamp() const { return stamp_; }
+			const fs::path& GetPath() const { return path_; }
+
+		private:
+			GcovFileReader(const GcovFileReader&) = delete;
+			GcovFileReader& operator=(const GcovFileReader&) = delete;
+
+			//-----------------------------------------------------------------
+			void Read(void* buffer, size_t size)
+			{
+				if (position_ + size > content_.size())
+					ThrowTruncated();
+				std::memcpy(buffer, content_.data() + position_, size);
+				position_ += size;
+			}
+
+			//-----------------------------------------------------------------
+			// The version is written as 4 characters: "409*" for gcc 4.9, "A93*" for gcc 9.3, "B22*" for gcc 12.2.
+			static int ToMajorVersion(uint32_t version)
+			{
+				auto first = static_cast<char>(version >> 24);
+				auto second = static_cast<char>(version >> 16);
+
+				if (first >= 'A')
+					return (first - 'A') * 10 + (second - '0');
+				return first - '0';
+			}
+
+			//-----------------------------------------------------------------
+			[[noreturn]] void ThrowTruncated() const
+			{
+				THROW(path_.wstring() << L" is truncated.");
+			}
+
+		private:
+			fs::path path_;
+			std::string content_;
+			size_t position_;
+			int majorVersion_;
+			uint32_t stamp_;
+		};
+
+		//---------------------------------------------------------------------
+		struct Arc
+		{
+			uint32_t source;
+			uint32_t destination;
+			bool isOnTree;
+			bool isCountKnown;
+			uint64_t count;
+		};
+
+		//---------------------------------------------------------------------
+		struct Block
+		{
+			std::vector<size_t> inArcs;
+			std::vector<size_t> outArcs;
+			bool isCountKnown = false;
+			uint64_t count = 0;
+		};
+
+		//---------------------------------------------------------------------
+		struct BlockLine
+		{
+			uint32_t block;
+			uint32_t sourceFile;
+			uint32_t line;
+		};
+
+		//---------------------------------------------------------------------
+		struct Function
+		{
+			uint32_t ident;
+			uint32_t linenoChecksum;
+			uint32_t cfgChecksum;
+			bool isArtificial;
+			std::vector<Block> blocks;
+			std::vector<Arc> arcs;
+			std::vector<BlockLine> lines;
+		};
+
+		//---------------------------------------------------------------------
+		struct Notes
+		{
+			uint32_t stamp;
+			std::vector<fs::path> sourceFiles;
+			std::vector<Function> functions;
+		};
+
+		//---------------------------------------------------------------------
+		Function& GetCurrentFunction(Notes& notes, const GcovFileReader& reader)
+		{
+			if (notes.functions.empty())
+				THROW(L"Invalid record before the first function in " << reader.GetPath().wstring());
+			return notes.functions.back();
+		}
+
+		//---------------------------------------------------------------------
+		uint32_t CheckBlock(const Function& function, uint32_t block, const GcovFileReader& reader)
+		{
+			if (block >= function.blocks.size())
+				THROW(L"Invalid block " << block << L" in " << reader.GetPath().wstring());
+			return block;
+		}
+
+		//---------------------------------------------------------------------
+		void ReadArcs(GcovFileReader& reader, size_t recordEnd, Function& function)
+		{
+			auto source = CheckBlock(function, reader.ReadUnsigned(), reader);
+
+			while (reader.GetPosition() < recordEnd)
+			{
+				auto destination = CheckBlock(function, reader.ReadUnsigned(), reader);
+				auto flags = reader.ReadUnsigned();
+				auto arcIndex = function.arcs.size();
+
+				function.arcs.push_back(Arc{ source, destination, (flags & ArcOnTreeFlag) != 0, false, 0 });
+				function.blocks[source].outArcs.push_back(arcIndex);
+				function.blocks[destination].inArcs.push_back(arcIndex);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// A line number of 0 is followed by the name of the source file of the next
+		// lines, or by an empty name at the end of the record.
+		void ReadLines(
+			GcovFileReader& reader,
+			const fs::path& currentDirectory,
+			std::unordered_map<std::string, uint32_t>& sourceFileIndexes,
+			Notes& notes)
+		{
+			auto& function = GetCurrentFunction(notes, reader);
+			auto block = CheckBlock(function, reader.ReadUnsigned(), reader);
+			const uint32_t noSourceFile = static_cast<uint32_t>(-1);
+			auto sourceFile = noSourceFile;
+
+			for (;;)
+			{
+				auto line = reader.ReadUnsigned();
+
+				if (line)
+				{
+					if (sourceFile == noSourceFile)
+						THROW(L"Line without source file in " << reader.GetPath().wstring());
+					function.lines.push_back(BlockLine{ block, sourceFile, line });
+				}
+				else
+				{
+					auto filename = reader.ReadString();
+
+					if (filename.empty())
+						break;
+					auto it = sourceFileIndexes.find(filename);
+					if (it == sourceFileIndexes.end())
+					{
+						fs::path path{ Tools::Utf8ToWString(filename) };
+
+						if (path.is_relative() && !currentDirectory.empty())
+							path = currentDirectory / path;
+						it = sourceFileIndexes.emplace(filename, static_cast<uint32_t>(notes.sourceFiles.size())).first;
+						notes.sourceFiles.push_back(path);
+					}
+					sourceFile = it->second;
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		Notes ReadNotes(const fs::path& path)
+		{
+			GcovFileReader reader{ path, NotesMagic };
+			std::unordered_map<std::string, uint32_t> sourceFileIndexes;
+			fs::path currentDirectory;
+			Notes notes;
+
+			notes.stamp = reader.GetStamp();
+			if (reader.GetMajorVersion() >= 9)
+				currentDirectory = Tools::Utf8ToWString(reader.ReadString());
+			reader.ReadUnsigned(); // Support of unexecuted blocks
+
+			for (auto tag = reader.ReadNextTag(); tag; tag = reader.ReadNextTag())
+			{
+				auto recordEnd = reader.GetRecordEnd(reader.ReadUnsigned());
+
+				switch (tag)
+				{
+					case FunctionTag:
+					{
+						notes.functions.emplace_back();
+						auto& function = notes.functions.back();
+
+						function.ident = reader.ReadUnsigned();
+						function.linenoChecksum = reader.ReadUnsigned();
+						function.cfgChecksum = reader.ReadUnsigned();
+						reader.ReadString(); // name
+						function.isArtificial = reader.ReadUnsigned() != 0;
+						break;
+					}
+					case BlocksTag:
+						GetCurrentFunction(notes, reader).blocks.resize(reader.ReadUnsigned());
+						break;
+					case ArcsTag:
+						ReadArcs(reader, recordEnd, GetCurrentFunction(notes, reader));
+						break;
+					case LinesTag:
+						ReadLines(reader, currentDirectory, sourceFileIndexes, notes);
+						break;
+				}
+				if (reader.GetPosition() > recordEnd)
+					THROW(L"Invalid record " << std::hex << tag << L" in " << path.wstring());
+				reader.SetPosition(recordEnd);
+			}
+			return notes;
+		}
+
+		//---------------------------------------------------------------------
+		// Arcs not on the spanning tree are instrumented. Counters are written
+		// in the order of their source block, as gcc writes the arcs.
+		std::vector<Arc*> GetInstrumentedArcs(Function& function)
+		{
+			std::vector<Arc*> arcs;
+
+			for (const auto& block : function.blocks)
+			{
+				for (auto arcIndex : block.outArcs)
+				{
+					auto& arc = function.arcs[arcIndex];
+
+					if (!arc.isOnTree)
+						arcs.push_back(&arc);
+				}
+			}
+			return arcs;
+		}
+
+		//---------------------------------------------------------------------
+		void ReadArcCounters(GcovFileReader& reader, uint32_t length, Function& function)
+		{
+			auto arcs = GetInstrumentedArcs(function);
+			// A negative length means all the counters are 0 and are not written.
+			auto isZero = static_cast<int32_t>(length) < 0;
+			auto counterCount = reader.ToBytes(isZero ? -static_cast<int32_t>(length) : length) / sizeof(uint64_t);
+
+			if (counterCount != arcs.size())
+			{
+				THROW(L"The data file " << reader.GetPath().wstring() << L" does not match its notes file: "
+					<< counterCount << L" counters for " << arcs.size() << L" arcs.");
+			}
+			for (auto arc : arcs)
+			{
+				arc->count += isZero ? 0 : reader.ReadCounter();
+				arc->isCountKnown = true;
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void ReadData(const fs::path& path, Notes& notes)
+		{
+			GcovFileReader reader{ path, DataMagic };
+			std::unordered_map<uint32_t, Function*> functions;
+			Function* function = nullptr;
+
+			if (reader.GetStamp() != notes.stamp)
+				THROW(L"The data file " << path.wstring() << L" does not match its notes file: the object was rebuilt.");
+			for (auto& notesFunction : notes.functions)
+				functions.emplace(notesFunction.ident, &notesFunction);
+
+			for (auto tag = reader.ReadNextTag(); tag; tag = reader.ReadNextTag())
+			{
+				auto length = reader.ReadUnsigned();
+				auto recordEnd = (static_cast<int32_t>(length) < 0) ? reader.GetPosition() : reader.GetRecordEnd(length);
+
+				if (tag == FunctionTag)
+				{
+					function = nullptr;
+					// An empty record is written for a function which is not emitted.
+					if (length)
+					{
+						auto it = functions.find(reader.ReadUnsigned());
+						auto linenoChecksum = reader.ReadUnsigned();
+						auto cfgChecksum = reader.ReadUnsigned();
+
+						if (it == functions.end()
+							|| it->second->linenoChecksum != linenoChecksum
+							|| it->second->cfgChecksum != cfgChecksum)
+						{
+							THROW(L"The data file " << path.wstring() << L" does not match its notes file.");
+						}
+						function = it->second;
+					}
+				}
+				else if (tag == ArcCountersTag && function)
+					ReadArcCounters(reader, length, *function);
+				reader.SetPosition(recordEnd);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		bool ComputeSum(const Function& function, const std::vector<size_t>& arcIndexes, uint64_t& sum)
+		{
+			if (arcIndexes.empty())
+				return false;
+
+			sum = 0;
+			for (auto arcIndex : arcIndexes)
+			{
+				const auto& arc = function.arcs[arcIndex];
+
+				if (!arc.isCountKnown)
+					return false;
+				sum += arc.count;
+			}
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		// When a single arc is unknown, its count is the count of the block minus
+		// the counts of the other arcs.
+		void SolveSingleUnknownArc(
+			Function& function,
+			const Block& block,
+			const std::vector<size_t>& arcIndexes,
+			std::vector<uint32_t>& pendingBlocks)
+		{
+			Arc* unknownArc = nullptr;
+			uint64_t sum = 0;
+
+			for (auto arcIndex : arcIndexes)
+			{
+				auto& arc = function.arcs[arcIndex];
+
+				if (arc.isCountKnown)
+					sum += arc.count;
+				else if (unknownArc)
+					return;
+				else
+					unknownArc = &arc;
+			}
+
+			if (unknownArc)
+			{
+				unknownArc->count = (block.count > sum) ? block.count - sum : 0;
+				unknownArc->isCountKnown = true;
+				pendingBlocks.push_back(unknownArc->source);
+				pendingBlocks.push_back(unknownArc->destination);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Same propagation as gcov: the count of a block is the sum of its incoming
+		// or outgoing arcs. Blocks are revisited each time one of their arcs is solved.
+		void SolveFlowGraph(Function& function)
+		{
+			std::vector<uint32_t> pendingBlocks;
+
+			for (auto i = function.blocks.size(); i > 0; --i)
+				pendingBlocks.push_back(static_cast<uint32_t>(i - 1));
+
+			while (!pendingBlocks.empty())
+			{
+				auto& block = function.blocks[pendingBlocks.back()];
+
+				pendingBlocks.pop_back();
+				if (!block.isCountKnown)
+				{
+					block.isCountKnown = ComputeSum(function, block.outArcs, block.count)
+						|| ComputeSum(function, block.inArcs, block.count);
+				}
+				if (block.isCountKnown)
+				{
+					SolveSingleUnknownArc(function, block, block.outArcs, pendingBlocks);
+					SolveSingleUnknownArc(function, block, block.inArcs, pendingBlocks);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		std::unique_ptr<cov::ModuleCoverage> CreateModule(const fs::path& path, const Notes& notes)
+		{
+			std::vector<std::vector<cov::LineCoverage>> linesBySourceFile(notes.sourceFiles.size());
+
+			// As gcov does, lines of functions generated by the compiler are ignored.
+			for (const auto& function : notes.functions)
+			{
+				if (function.isArtificial)
+					continue;
+				for (const auto& line : function.lines)
+				{
+					linesBySourceFile[line.sourceFile].emplace_back(
+						line.line, function.blocks[line.block].count != 0);
+				}
+			}
+
+			auto module = std::make_unique<cov::ModuleCoverage>(path);
+			module->ReserveFiles(notes.sourceFiles.size());
+			for (size_t i = 0; i < notes.sourceFiles.size(); ++i)
+			{
+				auto& lines = linesBySourceFile[i];
+
+				// A line is executed if one of its blocks is executed.
+				std::sort(lines.begin(), lines.end(), [](const cov::LineCoverage& line1, const cov::LineCoverage& line2)
+				{
+					if (line1.GetLineNumber() != line2.GetLineNumber())
+						return line1.GetLineNumber() < line2.GetLineNumber();
+					return line1.HasBeenExecuted() && !line2.HasBeenExecuted();
+				});
+				lines.erase(std::unique(lines.begin(), lines.end(), [](const cov::LineCoverage& line1, const cov::LineCoverage& line2)
+				{
+					return line1.GetLineNumber() == line2.GetLineNumber();
+				}), lines.end());
+
+				if (!lines.empty())
+					module->AddFile(notes.sourceFiles[i]).AddLines(std::move(lines));
+			}
+			return module;
+		}
+
+		//---------------------------------------------------------------------
+		bool HasExtension(const fs::path& path, const std::wstring& extension)
+		{
+			return path.extension().wstring() == extension;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring GcovImporter::NotesExtension = L".gcno";
+	const std::wstring GcovImporter::DataExtension = L".gcda";
+
+	//-------------------------------------------------------------------------
+	GcovImporter::GcovImporter(size_t maxThreadCount)
+		: maxThreadCount_{ maxThreadCount }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool GcovImporter::IsGcovPath(const fs::path& path)
+	{
+		return fs::is_directory(path)
+			|| HasExtension(path, NotesExtension)
+			|| HasExtension(path, DataExtension);
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData GcovImporter::Import(const fs::path& path) const
+	{
+		std::vector<fs::path> notesPaths;
+
+		if (fs::is_directory(path))
+		{
+			for (fs::recursive_directory_iterator it{ path }; it != fs::recursive_directory_iterator{}; ++it)
+			{
+				if (HasExtension(it->path(), NotesExtension) && fs::is_regular_file(it->path()))
+					notesPaths.push_back(it->path());
+			}
+			std::sort(notesPaths.begin(), notesPaths.end());
+		}
+		else
+			notesPaths.push_back(fs::path{ path }.replace_extension(NotesExtension));
+
+		std::vector<std::unique_ptr<cov::ModuleCoverage>> modules(notesPaths.size());
+		Tools::ParallelFor(notesPaths.size(), [&](size_t i)
+		{
+			modules[i] = ImportObject(notesPaths[i]);
+		}, maxThreadCount_);
+
+		cov::CoverageData coverageData{ path.wstring(), 0 };
+		for (auto& module : modules)
+			coverageData.AddModule(std::move(module));
+		return coverageData;
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<cov::ModuleCoverage> GcovImporter::ImportObject(const fs::path& notesPath) const
+	{
+		auto notes = ReadNotes(notesPath);
+		auto dataPath = fs::path{ notesPath }.replace_extension(DataExtension);
+
+		if (fs::exists(dataPath))
+		{
+			ReadData(dataPath, notes);
+			for (auto& function : notes.functions)
+				SolveFlowGraph(function);
+		}
+		return CreateModule(fs::path{ notesPath }.replace_extension(L".o"), notes);
+	}
+}
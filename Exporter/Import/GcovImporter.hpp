@@ -0,0 +1,68 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "../ExporterExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+	class ModuleCoverage;
+}
+
+namespace Exporter
+{
+	// Read the notes (.gcno) and data (.gcda) files written by gcc --coverage
+	// without running gcov. As gcov does, the execution count of each basic block
+	// is computed from the arc counters of the data file and a line is executed
+	// when one of its blocks is executed. Each object file becomes a module.
+	// Files written by gcc 8 and later are supported.
+	class EXPORTER_DLL GcovImporter
+	{
+	public:
+		static const std::wstring NotesExtension;
+		static const std::wstring DataExtension;
+
+	public:
+		// maxThreadCount is the number of threads reading the objects,
+		// 0 means one thread per hardware core.
+		explicit GcovImporter(size_t maxThreadCount = 0);
+
+		// True for a folder or for a notes or data file.
+		static bool IsGcovPath(const boost::filesystem::path&);
+
+		// Import all the notes files of a folder and its sub folders,
+		// or the object of a single notes or data file.
+		CppCoverage::CoverageData Import(const boost::filesystem::path&) const;
+
+		// The data file is expected next to the notes file. Without data file,
+		// the object has not been executed and all its lines are unexecuted.
+		// The module is named after the object file.
+		std::unique_ptr<CppCoverage::ModuleCoverage> ImportObject(const boost::filesystem::path& notesPath) const;
+
+	private:
+		GcovImporter(const GcovImporter&) = delete;
+		GcovImporter& operator=(const GcovImporter&) = delete;
+
+	private:
+		size_t maxThreadCount_;
+	};
+}
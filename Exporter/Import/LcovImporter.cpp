@@ -0,0 +1,131 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "LcovImporter.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <boost/optional.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "../ExporterException.hpp"
+#include "CoverageDataBuilder.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		bool StartsWith(const std::string& line, const char* prefix)
+		{
+			return line.compare(0, std::strlen(prefix), prefix) == 0;
+		}
+
+		//---------------------------------------------------------------------
+		// DA:<line number>,<hit count>[,<checksum>]
+		cov::LineCoverage ReadLineRecord(const std::string& line, size_t lineNumber)
+		{
+			const char* begin = line.c_str() + 3;
+			char* end = nullptr;
+			auto number = std::strtoul(begin, &end, 10);
+
+			if (end == begin || *end != ',')
+				THROW(L"Invalid LCOV record at line " << lineNumber << L": " << line.c_str());
+			begin = end + 1;
+
+			// Some versions of gcov write negative hit counts for lines not executed.
+			auto hitCount = std::strtoll(begin, &end, 10);
+			if (end == begin || (*end && *end != ','))
+				THROW(L"Invalid LCOV record at line " << lineNumber << L": " << line.c_str());
+
+			return cov::LineCoverage{ static_cast<unsigned int>(number), hitCount > 0 };
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool LcovImporter::IsLcovFile(const fs::path& path)
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+		char header[3];
+
+		if (!ifs.read(header, sizeof(header)))
+			return false;
+
+		std::string prefix{ header, sizeof(header) };
+		return prefix == "TN:" || prefix == "SF:";
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData LcovImporter::Import(const fs::path& path) const
+	{
+		std::ifstream ifs{ path.string(), std::ios::binary };
+
+		if (!ifs)
+			THROW(L"Cannot open file " << path.wstring());
+		return Import(ifs, path.wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	cov::CoverageData LcovImporter::Import(std::istream& istr, const std::wstring& name) const
+	{
+		CoverageDataBuilder builder{ name };
+		boost::optional<fs::path> file;
+		std::vector<cov::LineCoverage> lines;
+		std::string line;
+		size_t lineNumber = 0;
+
+		auto addFile = [&]()
+		{
+			if (file)
+				builder.AddFile(*file, std::move(lines));
+			lines.clear();
+			file = boost::none;
+		};
+
+		while (std::getline(istr, line))
+		{
+			++lineNumber;
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			if (StartsWith(line, "DA:"))
+			{
+				if (!file)
+					THROW(L"LCOV record at line " << lineNumber << L" is not inside a SF record.");
+				lines.push_back(ReadLineRecord(line, lineNumber));
+			}
+			else if (StartsWith(line, "SF:"))
+			{
+				addFile();
+				file = fs::path{ Tools::Utf8ToWString(line.substr(3)) };
+			}
+			else if (line == "end_of_record")
+				addFile();
+		}
+		addFile();
+
+		return builder.Build();
+	}
+}
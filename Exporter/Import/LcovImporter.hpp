@@ -0,0 +1,52 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+#include "../ExporterExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Read a LCOV tracefile (.info) written for example by lcov, gcovr or LcovExporter.
+	// Only the line coverage is read: SF, DA and end_of_record records. A line
+	// is executed when its hit count is not 0. The files are added to a single
+	// module named after the tracefile.
+	class EXPORTER_DLL LcovImporter
+	{
+	public:
+		LcovImporter() = default;
+
+		static bool IsLcovFile(const boost::filesystem::path&);
+
+		CppCoverage::CoverageData Import(const boost::filesystem::path&) const;
+
+		// The tracefile is read line by line.
+		CppCoverage::CoverageData Import(std::istream&, const std::wstring& name) const;
+
+	private:
+		LcovImporter(const LcovImporter&) = delete;
+		LcovImporter& operator=(const LcovImporter&) = delete;
+	};
+}
@@ -0,0 +1,381 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "XmlStreamReader.hpp"
+
+#include <cstring>
+#include <istream>
+
+#include "../ExporterException.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		const size_t BufferSize = 1024 * 1024;
+
+		//---------------------------------------------------------------------
+		bool IsWhitespace(int c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		//---------------------------------------------------------------------
+		bool IsNameEnd(int c)
+		{
+			return c == -1 || IsWhitespace(c) || c == '/' || c == '>' || c == '=';
+		}
+
+		//---------------------------------------------------------------------
+		void AppendUtf8(unsigned long codePoint, std::string& output)
+		{
+			if (codePoint < 0x80)
+				output += static_cast<char>(codePoint);
+			else if (codePoint < 0x800)
+			{
+				output += static_cast<char>(0xC0 | (codePoint >> 6));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				output += static_cast<char>(0xE0 | (codePoint >> 12));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x110000)
+			{
+				output += static_cast<char>(0xF0 | (codePoint >> 18));
+				output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else
+				THROW(L"Invalid XML character reference: " << codePoint);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	XmlStreamReader::XmlStreamReader(std::istream& istr)
+		: istr_(istr)
+		, buffer_(BufferSize)
+		, position_{ 0 }
+		, size_{ 0 }
+		, isEmptyElement_{ false }
+		, attributeCount_{ 0 }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	XmlStreamReader::Node XmlStreamReader::Next()
+	{
+		if (isEmptyElement_)
+		{
+			isEmptyElement_ = false;
+			attributeCount_ = 0;
+			return Node::EndElement;
+		}
+
+		for (;;)
+		{
+			auto c = Peek();
+
+			if (c == -1)
+				return Node::EndOfFile;
+			if (c != '<')
+			{
+				ReadText();
+				return Node::Text;
+			}
+			Get();
+			switch (Peek())
+			{
+				case '?':
+					SkipUntil("?>");
+					break;
+				case '!':
+					if (SkipIfNext("!--"))
+						SkipUntil("-->");
+					else if (SkipIfNext("![CDATA["))
+					{
+						text_.clear();
+						while (!SkipIfNext("]]>"))
+							text_ += GetChar();
+						return Node::Text;
+					}
+					else
+						SkipDoctype();
+					break;
+				case '/':
+					Get();
+					ReadName(name_);
+					SkipWhitespaces();
+					Expect('>');
+					attributeCount_ = 0;
+					return Node::EndElement;
+				default:
+					ReadName(name_);
+					ReadAttributes();
+					return Node::StartElement;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string& XmlStreamReader::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* XmlStreamReader::GetAttribute(const char* name) const
+	{
+		for (size_t i = 0; i < attributeCount_; ++i)
+		{
+			if (attributes_[i].first == name)
+				return &attributes_[i].second;
+		}
+		return nullptr;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string& XmlStreamReader::GetText() const
+	{
+		return text_;
+	}
+
+	//-------------------------------------------------------------------------
+	int XmlStreamReader::Peek()
+	{
+		if (position_ == size_ && !Refill())
+			return -1;
+		return static_cast<unsigned char>(buffer_[position_]);
+	}
+
+	//-------------------------------------------------------------------------
+	int XmlStreamReader::Get()
+	{
+		auto c = Peek();
+
+		if (c != -1)
+			++position_;
+		return c;
+	}
+
+	//-------------------------------------------------------------------------
+	char XmlStreamReader::GetChar()
+	{
+		auto c = Get();
+
+		if (c == -1)
+			THROW(L"Unexpected end of XML file.");
+		return static_cast<char>(c);
+	}
+
+	//-------------------------------------------------------------------------
+	bool XmlStreamReader::Refill()
+	{
+		istr_.read(buffer_.data(), buffer_.size());
+		position_ = 0;
+		size_ = static_cast<size_t>(istr_.gcount());
+		return size_ != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::Expect(char expected)
+	{
+		auto c = GetChar();
+
+		if (c != expected)
+			THROW(L"Invalid XML: expected '" << expected << L"' but found '" << c << L"'.");
+	}
+
+	//-------------------------------------------------------------------------
+	// Markup prefixes are short: the unread part of the buffer is moved to
+	// the front when a prefix spans two blocks.
+	bool XmlStreamReader::SkipIfNext(const char* text)
+	{
+		auto length = std::strlen(text);
+
+		if (size_ - position_ < length)
+		{
+			std::memmove(buffer_.data(), buffer_.data() + position_, size_ - position_);
+			size_ -= position_;
+			position_ = 0;
+			istr_.read(buffer_.data() + size_, buffer_.size() - size_);
+			size_ += static_cast<size_t>(istr_.gcount());
+			if (size_ < length)
+				return false;
+		}
+		if (std::memcmp(buffer_.data() + position_, text, length) != 0)
+			return false;
+		position_ += length;
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::SkipUntil(const char* text)
+	{
+		while (!SkipIfNext(text))
+			GetChar();
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::SkipWhitespaces()
+	{
+		while (IsWhitespace(Peek()))
+			Get();
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::ReadName(std::string& name)
+	{
+		name.clear();
+		while (Peek() != -1)
+		{
+			auto begin = position_;
+
+			while (position_ < size_ && !IsNameEnd(static_cast<unsigned char>(buffer_[position_])))
+				++position_;
+			name.append(buffer_.data() + begin, position_ - begin);
+			if (position_ < size_)
+				break;
+		}
+		if (name.empty())
+			THROW(L"Invalid XML: a name is expected.");
+	}
+
+	//-------------------------------------------------------------------------
+	// Characters are appended by blocks up to stop1, stop2 or the end of the file.
+	void XmlStreamReader::AppendUntil(std::string& output, char stop1, char stop2)
+	{
+		while (Peek() != -1)
+		{
+			auto begin = position_;
+
+			while (position_ < size_ && buffer_[position_] != stop1 && buffer_[position_] != stop2)
+				++position_;
+			output.append(buffer_.data() + begin, position_ - begin);
+			if (position_ < size_)
+				return;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::ReadReference(std::string& output)
+	{
+		std::string reference;
+
+		for (auto c = GetChar(); c != ';'; c = GetChar())
+		{
+			reference += c;
+			if (reference.size() > 10)
+				THROW(L"Invalid XML entity: &" << reference.c_str());
+		}
+
+		if (reference == "lt")
+			output += '<';
+		else if (reference == "gt")
+			output += '>';
+		else if (reference == "amp")
+			output += '&';
+		else if (reference == "quot")
+			output += '"';
+		else if (reference == "apos")
+			output += '\'';
+		else if (reference.size() > 1 && reference[0] == '#')
+		{
+			bool isHexadecimal = reference[1] == 'x';
+			auto digits = reference.substr(isHexadecimal ? 2 : 1);
+			char* end = nullptr;
+			auto codePoint = std::strtoul(digits.c_str(), &end, isHexadecimal ? 16 : 10);
+
+			if (digits.empty() || *end)
+				THROW(L"Invalid XML character reference: &" << reference.c_str() << L";");
+			AppendUtf8(codePoint, output);
+		}
+		else
+			THROW(L"Unknown XML entity: &" << reference.c_str() << L";");
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlStreamReader::ReadText()
+	{
+		text_.clear();
+		for (AppendUntil(text_, '<', '&'); Peek() == '&'; AppendUntil(text_, '<', '&'))
+		{
+			Get();
+			ReadReference(text_);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// Attribute strings are reused from one element to the next.
+	void XmlStreamReader::ReadAttributes()
+	{
+		attributeCount_ = 0;
+		for (;;)
+		{
+			SkipWhitespaces();
+
+			auto c = Peek();
+			if (c == '/')
+			{
+				Get();
+				Expect('>');
+				isEmptyElement_ = true;
+				return;
+			}
+			if (c == '>')
+			{
+				Get();
+				return;
+			}
+
+			if (attributeCount_ == attributes_.size())
+				attributes_.emplace_back();
+			auto& attribute = attributes_[attributeCount_++];
+
+			ReadName(attribute.first);
+			SkipWhitespaces();
+			Expect('=');
+			SkipWhitespaces();
+
+			auto quote = GetChar();
+			if (quote != '"' && quote != '\'')
+				THROW(L"Invalid XML: attribute " << attribute.first.c_str() << L" is not quoted.");
+
+			attribute.second.clear();
+			for (AppendUntil(attribute.second, quote, '&'); GetChar() == '&'; AppendUntil(attribute.second, quote, '&'))
+				ReadReference(attribute.second);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// <!DOCTYPE ...> may contain an internal subset between brackets.
+	void XmlStreamReader::SkipDoctype()
+	{
+		int depth = 0;
+
+		for (auto c = GetChar(); c != '>' || depth > 0; c = GetChar())
+		{
+			if (c == '[')
+				++depth;
+			else if (c == ']')
+				--depth;
+		}
+	}
+}
@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Exporter
+{
+	// Pull parser for the XML subset written by coverage tools. The input is
+	// read by blocks so that the memory does not depend on its size.
+	// Comments, processing instructions and DOCTYPE are skipped, entities
+	// and character references are decoded to UTF-8.
+	class XmlStreamReader
+	{
+	public:
+		enum class Node
+		{
+			StartElement,
+			EndElement,
+			Text,
+			EndOfFile
+		};
+
+		explicit XmlStreamReader(std::istream&);
+
+		// An empty element <a/> is returned as a start and an end element.
+		Node Next();
+
+		// Name of the current start or end element.
+		const std::string& GetName() const;
+
+		// Attribute of the current start element or nullptr if it does not exist.
+		const std::string* GetAttribute(const char* name) const;
+
+		// Content of the current text node, CDATA sections included.
+		const std::string& GetText() const;
+
+	private:
+		XmlStreamReader(const XmlStreamReader&) = delete;
+		XmlStreamReader& operator=(const XmlStreamReader&) = delete;
+
+		int Peek();
+		int Get();
+		char GetChar();
+		bool Refill();
+		void Expect(char);
+		bool SkipIfNext(const char* text);
+		void SkipUntil(const char* text);
+		void SkipWhitespaces();
+		void ReadName(std::string&);
+		void AppendUntil(std::string&, char stop1, char stop2);
+		void ReadReference(std::string&);
+		void ReadText();
+		void ReadAttributes();
+		void SkipDoctype();
+
+		std::istream& istr_;
+		std::vector<char> buffer_;
+		size_t position_;
+		size_t size_;
+		bool isEmptyElement_;
+		std::string name_;
+		std::string text_;
+		std::vector<std::pair<std::string, std::string>> attributes_;
+		size_t attributeCount_;
+	};
+}
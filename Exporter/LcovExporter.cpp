@@ -0,0 +1,159 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "LcovExporter.hpp"
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "ExporterException.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		//-------------------------------------------------------------------------
+		// Write the LCOV records to a stream by large blocks.
+		class LcovStreamWriter
+		{
+		public:
+			//---------------------------------------------------------------------
+			explicit LcovStreamWriter(std::ostream& ostr)
+				: ostr_(ostr)
+			{
+				buffer_.reserve(MaxBufferSize + 4096);
+			}
+
+			//---------------------------------------------------------------------
+			void WriteFile(const cov::FileCoverage& file)
+			{
+				const auto& coverageRate = file.GetCoverageRate();
+
+				buffer_ += "TN:\nSF:";
+				buffer_ += Tools::ToUtf8String(file.GetPath().wstring());
+				buffer_ += '\n';
+				for (const auto& line : file.GetLines())
+				{
+					buffer_ += "DA:";
+					AppendNumber(line.GetLineNumber());
+					buffer_ += line.HasBeenExecuted() ? ",1\n" : ",0\n";
+					FlushIfNeeded();
+				}
+				buffer_ += "LF:";
+				AppendNumber(static_cast<unsigned int>(coverageRate.GetTotalLinesCount()));
+				buffer_ += "\nLH:";
+				AppendNumber(static_cast<unsigned int>(coverageRate.GetExecutedLinesCount()));
+				buffer_ += "\nend_of_record\n";
+			}
+
+			//---------------------------------------------------------------------
+			void Flush()
+			{
+				ostr_.write(buffer_.data(), buffer_.size());
+				buffer_.clear();
+			}
+
+		private:
+			LcovStreamWriter(const LcovStreamWriter&) = delete;
+			LcovStreamWriter& operator=(const LcovStreamWriter&) = delete;
+
+			static const size_t MaxBufferSize = 1024 * 1024;
+
+			//---------------------------------------------------------------------
+			void AppendNumber(unsigned int value)
+			{
+				char digits[16];
+				auto end = digits + sizeof(digits);
+				auto begin = end;
+
+				do
+				{
+					*--begin = static_cast<char>('0' + value % 10);
+					value /= 10;
+				} while (value);
+				buffer_.append(begin, end);
+			}
+
+			//---------------------------------------------------------------------
+			void FlushIfNeeded()
+			{
+				if (buffer_.size() >= MaxBufferSize)
+					Flush();
+			}
+
+			std::ostream& ostr_;
+			std::string buffer_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	LcovExporter::LcovExporter() = default;
+
+	//-------------------------------------------------------------------------
+	boost::filesystem::path LcovExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		boost::filesystem::path path{ prefix };
+		
+		path += "Coverage.info";
+
+		return path;		
+	}
+
+	//-------------------------------------------------------------------------
+	void LcovExporter::Export(
+		const CppCoverage::CoverageData& coverageData, 
+		const boost::filesystem::path& output)
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+		std::ofstream ofs{ output.string(), std::ios::binary };
+
+		if (!ofs)
+			THROW(L"Cannot open file " + output.wstring());
+		Export(coverageData, ofs);
+		if (!ofs.flush())
+			THROW(L"Cannot write file " + output.wstring());
+		Tools::ShowOutputMessage(L"LCOV report generated: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	void LcovExporter::Export(
+		const CppCoverage::CoverageData& coverageData,
+		std::ostream& ostream) const
+	{
+		LcovStreamWriter writer{ ostream };
+
+		// A file shared by several modules has one record by module:
+		// LCOV tools merge the records with the same source file.
+		for (const auto& module : coverageData.GetModules())
+		{
+			for (const auto& file : module->GetFiles())
+				writer.WriteFile(*file);
+		}
+		writer.Flush();
+	}
+}
@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+
+#include "ExporterExport.hpp"
+#include "IExporter.hpp"
+
+namespace CppCoverage
+{
+	class CoverageData;
+}
+
+namespace boost
+{	
+	namespace filesystem
+	{
+		class path;
+	}
+}
+
+namespace Exporter
+{
+	// Export the coverage as a LCOV tracefile (.info) read by genhtml, Codecov
+	// or diff-cover. Each file of each module is written as a SF record with its
+	// DA, LF and LH lines. The hit count of an executed line is 1 as the number
+	// of executions is not recorded.
+	class EXPORTER_DLL LcovExporter: public IExporter
+	{
+	public:
+		LcovExporter();
+
+		boost::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
+		void Export(const CppCoverage::CoverageData&, const boost::filesystem::path& output) override;
+
+		// Write the report as UTF-8 while iterating the coverage data.
+		void Export(const CppCoverage::CoverageData&, std::ostream&) const;
+
+	private:
+		LcovExporter(const LcovExporter&) = delete;
+		LcovExporter& operator=(const LcovExporter&) = delete;
+	};
+}
@@ -16,15 +16,17 @@
 
 #include "stdafx.h"
 
+#include <chrono>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "CppCoverage/CoverageData.hpp"
 #include "CppCoverage/ModuleCoverage.hpp"
 #include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
 
 #include "Exporter/CoberturaExporter.hpp"
-#include "tools/Tool.hpp"
 
 #include "TestHelper/TemporaryPath.hpp"
 
@@ -36,11 +38,11 @@ namespace ExporterTest
 	namespace
 	{
 		//-------------------------------------------------------------------------
-		std::wstring GetExpectedResult()
+		std::string GetExpectedResult()
 		{
 			fs::path expectedResult = fs::path(PROJECT_DIR) / "Data" / "CoberturaExporterExpectedResult.xml";
-			std::wifstream ifs{ expectedResult.wstring().c_str() };
-			std::wostringstream ostr;
+			std::ifstream ifs{ expectedResult.wstring().c_str() };
+			std::ostringstream ostr;
 
 			ostr << ifs.rdbuf();
 
@@ -64,7 +66,7 @@ namespace ExporterTest
 
 		module.AddFile("File2").AddLine(0, true);
 
-		std::wostringstream ostr;
+		std::ostringstream ostr;
 		Exporter::CoberturaExporter().Export(coverageData, ostr);
 		auto result = ostr.str();
 		auto expectedResult = GetExpectedResult();				
@@ -90,19 +92,32 @@ namespace ExporterTest
 		cov::CoverageData coverageData{ L"", 0 };
 		coverageData.AddModule(L"").AddFile(L"").AddLine(0, true);
 		
-		std::wostringstream ostr;
+		std::ostringstream ostr;
 		Exporter::CoberturaExporter().Export(coverageData, ostr);
 		auto result = ostr.str();
 
-		auto packageName = Tools::LocalToWString(u8"package name=\"\"");
-		auto name = Tools::LocalToWString(u8"class name=\"\"");
-		auto filename = Tools::LocalToWString(u8"filename=\"\"");
+		std::string packageName = u8"package name=\"\"";
+		std::string name = u8"class name=\"\"";
+		std::string filename = u8"filename=\"\"";
 
 		ASSERT_TRUE(boost::algorithm::contains(result, packageName));
 		ASSERT_TRUE(boost::algorithm::contains(result, name));
 		ASSERT_TRUE(boost::algorithm::contains(result, filename));
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, EscapedChars)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		coverageData.AddModule(L"<Module & \"'>").AddFile(L"File").AddLine(0, true);
+
+		std::ostringstream ostr;
+		Exporter::CoberturaExporter().Export(coverageData, ostr);
+
+		ASSERT_TRUE(boost::algorithm::contains(ostr.str(), 
+			"package name=\"&lt;Module &amp; &quot;&apos;&gt;\""));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(CoberturaExporterTest, OutputExists)
 	{
@@ -111,4 +126,52 @@ namespace ExporterTest
 		
 		ASSERT_NO_THROW(Exporter::CoberturaExporter().Export(coverageData, outputPath));
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, SharedCoverageRateComputer)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		module.AddFile("File").AddLine(0, true);
+		module.AddFile("File2").AddLine(1, false);
+
+		cov::CoverageRateComputer coverageRateComputer{ coverageData };
+		TestHelper::TemporaryPath output;
+		std::ostringstream ostr;
+
+		Exporter::CoberturaExporter().Export(coverageData, coverageRateComputer, output.GetPath());
+		Exporter::CoberturaExporter().Export(coverageData, ostr);
+
+		std::ifstream ifs{ output.GetPath().string() };
+		std::string result{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+		ASSERT_EQ(ostr.str(), result);
+	}
+
+	//-------------------------------------------------------------------------
+	// The duration and the file size are recorded as test properties.
+	TEST(CoberturaExporterTest, DISABLED_ExportBenchmark)
+	{
+		const int fileCount = 80000;
+		const int lineCount = 200;
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		for (int i = 0; i < fileCount; ++i)
+		{
+			std::vector<cov::LineCoverage> lines;
+
+			for (int line = 0; line < lineCount; ++line)
+				lines.emplace_back(line, line % 3 != 0);
+			module.AddFile(L"C:\\Folder\\File" + std::to_wstring(i) + L".cpp").AddLines(std::move(lines));
+		}
+
+		TestHelper::TemporaryPath output;
+		auto start = std::chrono::steady_clock::now();
+		Exporter::CoberturaExporter().Export(coverageData, output.GetPath());
+		auto end = std::chrono::steady_clock::now();
+
+		RecordProperty("ExportMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+		RecordProperty("SizeMB", static_cast<int>(fs::file_size(output.GetPath()) / (1024 * 1024)));
+	}
+}
@@ -0,0 +1,189 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+
+#include "Exporter/ExporterException.hpp"
+#include "Exporter/CoberturaExporter.hpp"
+#include "Exporter/Import/CoberturaImporter.hpp"
+
+#include "TestHelper/CoverageDataComparer.hpp"
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::CoverageData Import(const std::string& report)
+		{
+			std::istringstream istr{ report };
+
+			return Exporter::CoberturaImporter().Import(istr, L"Test");
+		}
+
+		//---------------------------------------------------------------------
+		void AssertExportImport(const cov::CoverageData& coverageData)
+		{
+			std::stringstream report;
+
+			Exporter::CoberturaExporter().Export(coverageData, report);
+			auto importedCoverageData = Exporter::CoberturaImporter().Import(report, L"Test");
+			const auto& modules = coverageData.GetModules();
+			const auto& importedModules = importedCoverageData.GetModules();
+
+			ASSERT_EQ(modules.size(), importedModules.size());
+			for (size_t i = 0; i < modules.size(); ++i)
+				TestHelper::CoverageDataComparer().AssertEquals(modules[i].get(), importedModules[i].get());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaImporterTest, Import)
+	{
+		auto coverageData = Import(
+			"\xEF\xBB\xBF<?xml version=\"1.0\" ?>\n"
+			"<!DOCTYPE coverage SYSTEM 'http://cobertura.sourceforge.net/xml/coverage-04.dtd'>\n"
+			"<coverage line-rate=\"0.5\">\n"
+			"  <!-- Generated by gcovr -->\n"
+			"  <sources>\n    <source>/home/project</source>\n  </sources>\n"
+			"  <packages>\n"
+			"    <package name=\"src\">\n"
+			"      <classes>\n"
+			"        <class name=\"a\" filename='src/a&amp;b.cpp'>\n"
+			"          <methods><method name=\"f\"><lines><line number=\"1\" hits=\"9\"/></lines></method></methods>\n"
+			"          <lines>\n"
+			"            <line number=\"1\" hits=\"0\"/>\n"
+			"            <line number=\"2\" hits=\"3\" branch=\"true\" condition-coverage=\"50% (1/2)\">\n"
+			"              <conditions><condition number=\"0\" type=\"jump\" coverage=\"50%\"/></conditions>\n"
+			"            </line>\n"
+			"          </lines>\n"
+			"        </class>\n"
+			"      </classes>\n"
+			"    </package>\n"
+			"  </packages>\n"
+			"</coverage>\n");
+
+		ASSERT_EQ(1u, coverageData.GetModules().size());
+		const auto& module = *coverageData.GetModules().at(0);
+		ASSERT_EQ(L"src", module.GetPath().wstring());
+		ASSERT_EQ(1u, module.GetFiles().size());
+
+		const auto& file = *module.GetFiles().at(0);
+		ASSERT_EQ(fs::path{ "/home/project" } / "src/a&b.cpp", file.GetPath());
+		ASSERT_EQ(2u, file.GetLines().size());
+		ASSERT_FALSE(file[1]->HasBeenExecuted());
+		ASSERT_TRUE(file[2]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaImporterTest, ExportImport)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		module.AddFile(L"File").AddLine(1, true);
+		auto& file = module.AddFile(L"\u00E9\u00E0 <&>.cpp");
+		file.AddLine(1, false);
+		file.AddLine(10, true);
+		coverageData.AddModule(L"Module2").AddFile(L"File").AddLine(0, false);
+
+		AssertExportImport(coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaImporterTest, LargeReport)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		// The report is larger than the buffer of the XML reader.
+		for (int i = 0; i < 2000; ++i)
+		{
+			auto& file = module.AddFile(L"Folder\\File" + std::to_wstring(i) + L".cpp");
+
+			for (unsigned int line = 1; line < 50; ++line)
+				file.AddLine(line, line % 3 == 0);
+		}
+
+		AssertExportImport(coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaImporterTest, InvalidReport)
+	{
+		ASSERT_THROW(Import("<coverage><packages><package><classes>"), Exporter::ExporterException);
+		ASSERT_THROW(Import("<coverage><packages><package name=\"a\"><classes><class filename=\"b\">"
+			"<lines><line number=\"x\" hits=\"0\"/>"), Exporter::ExporterException);
+		ASSERT_THROW(Import("<coverage attribute=\"&unknown;\">"), Exporter::ExporterException);
+		ASSERT_THROW(Import("<coverage"), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaImporterTest, IsCoberturaFile)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		TestHelper::TemporaryPath coberturaPath;
+		TestHelper::TemporaryPath otherPath;
+
+		Exporter::CoberturaExporter().Export(coverageData, coberturaPath.GetPath());
+		std::ofstream{ otherPath.GetPath().string() } << "TN:\nSF:File.cpp\nend_of_record\n";
+
+		ASSERT_TRUE(Exporter::CoberturaImporter::IsCoberturaFile(coberturaPath));
+		ASSERT_FALSE(Exporter::CoberturaImporter::IsCoberturaFile(otherPath));
+	}
+
+	//-------------------------------------------------------------------------
+	// The duration and the file size are recorded as test properties.
+	TEST(CoberturaImporterTest, DISABLED_ImportBenchmark)
+	{
+		const int fileCount = 80000;
+		const int lineCount = 200;
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		for (int i = 0; i < fileCount; ++i)
+		{
+			std::vector<cov::LineCoverage> lines;
+
+			for (int line = 0; line < lineCount; ++line)
+				lines.emplace_back(line, line % 3 != 0);
+			module.AddFile(L"C:\\Folder\\File" + std::to_wstring(i) + L".cpp").AddLines(std::move(lines));
+		}
+
+		TestHelper::TemporaryPath output;
+		Exporter::CoberturaExporter().Export(coverageData, output.GetPath());
+
+		auto start = std::chrono::steady_clock::now();
+		auto importedCoverageData = Exporter::CoberturaImporter().Import(output.GetPath());
+		auto end = std::chrono::steady_clock::now();
+
+		RecordProperty("ImportMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+		RecordProperty("SizeMB", static_cast<int>(fs::file_size(output.GetPath()) / (1024 * 1024)));
+	}
+}
@@ -0,0 +1,247 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <fstream>
+#include <zlib.h>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+
+#include "Exporter/Html/CompactHtmlExporter.hpp"
+#include "Exporter/Html/HtmlExporter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string ReadContent(const fs::path& path)
+		{
+			std::ifstream ifs{ path.string(), std::ios::binary };
+
+			return{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+		}
+
+		//---------------------------------------------------------------------
+		std::string DecodeBase64(const std::string& base64)
+		{
+			const std::string base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::string output;
+			unsigned int value = 0;
+			int bitCount = 0;
+
+			for (auto c : base64)
+			{
+				if (c == '=')
+					break;
+				value = (value << 6) | static_cast<unsigned int>(base64Chars.find(c));
+				bitCount += 6;
+				if (bitCount >= 8)
+				{
+					bitCount -= 8;
+					output += static_cast<char>((value >> bitCount) & 0xFF);
+				}
+			}
+			return output;
+		}
+
+		//---------------------------------------------------------------------
+		std::string Uncompress(const std::string& compressed, size_t size)
+		{
+			std::string output(size, '\0');
+			auto outputSize = static_cast<uLong>(size);
+
+			if (uncompress(reinterpret_cast<Bytef*>(&output[0]), &outputSize,
+				reinterpret_cast<const Bytef*>(compressed.data()), static_cast<uLong>(compressed.size())) != Z_OK)
+			{
+				return "";
+			}
+			output.resize(outputSize);
+			return output;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetFolderSize(const fs::path& folder, size_t& fileCount)
+		{
+			size_t size = 0;
+
+			fileCount = 0;
+			for (fs::recursive_directory_iterator it{ folder }; it != fs::recursive_directory_iterator{}; ++it)
+			{
+				if (fs::is_regular_file(it->path()))
+				{
+					size += static_cast<size_t>(fs::file_size(it->path()));
+					++fileCount;
+				}
+			}
+			return size;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	struct CompactHtmlExporterTest : public ::testing::Test
+	{
+		//---------------------------------------------------------------------
+		CompactHtmlExporterTest()
+			: templateFolder_{ fs::canonical(OUT_DIR) / "Template" }
+			, testFile_{ fs::path(PROJECT_DIR) / "Data" / "TestFile1.cpp" }
+		{
+		}
+
+		fs::path templateFolder_;
+		fs::path testFile_;
+		TestHelper::TemporaryPath output_;
+	};
+
+	//-------------------------------------------------------------------------
+	TEST_F(CompactHtmlExporterTest, Export)
+	{
+		cov::CoverageData data{ L"Test", 42 };
+		auto& file = data.AddModule(L"Module.exe").AddFile(testFile_);
+
+		file.AddLine(1, true);
+		file.AddLine(2, false);
+		data.AddModule(L"EmptyModule.exe");
+
+		Exporter::CompactHtmlExporter{ templateFolder_ }.Export(data, output_);
+
+		ASSERT_TRUE(fs::exists(output_.GetPath() / "index.html"));
+		auto coverage = ReadContent(output_.GetPath() / Exporter::CompactHtmlExporter::CoverageFilename);
+		ASSERT_NE(std::string::npos, coverage.find("\"name\":\"Test\",\"exitCode\":42"));
+		ASSERT_NE(std::string::npos, coverage.find("Module.exe"));
+		ASSERT_EQ(std::string::npos, coverage.find("EmptyModule.exe"));
+		ASSERT_NE(std::string::npos, coverage.find("\"executed\":1,\"total\":2,\"firstLine\":1,\"lines\":\"Bw==\",\"source\":[0,0]"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CompactHtmlExporterTest, Source)
+	{
+		cov::CoverageData data{ L"Test", 0 };
+
+		data.AddModule(L"Module.exe").AddFile(testFile_).AddLine(1, true);
+		Exporter::CompactHtmlExporter{ templateFolder_ }.Export(data, output_);
+
+		auto chunk = ReadContent(output_.GetPath() / Exporter::CompactHtmlExporter::SourcesFolder / "sources0.js");
+		auto sourceBegin = chunk.find('"') + 1;
+		auto sourceEnd = chunk.find('"', sourceBegin);
+		auto expectedSource = ReadContent(testFile_);
+
+		ASSERT_EQ(0u, chunk.find("coverageReport.addSources(0, ["));
+		ASSERT_EQ(expectedSource, Uncompress(DecodeBase64(chunk.substr(sourceBegin, sourceEnd - sourceBegin)), expectedSource.size()));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CompactHtmlExporterTest, SeveralChunks)
+	{
+		cov::CoverageData data{ L"Test", 0 };
+		auto& module = data.AddModule(L"Module.exe");
+
+		module.AddFile(testFile_).AddLine(1, true);
+		module.AddFile(fs::path(PROJECT_DIR) / "Data" / "TestFile2.cpp").AddLine(1, true);
+		Exporter::CompactHtmlExporter{ templateFolder_, 0, 1 }.Export(data, output_);
+
+		auto sourcesFolder = output_.GetPath() / Exporter::CompactHtmlExporter::SourcesFolder;
+		auto coverage = ReadContent(output_.GetPath() / Exporter::CompactHtmlExporter::CoverageFilename);
+		ASSERT_TRUE(fs::exists(sourcesFolder / "sources0.js"));
+		ASSERT_TRUE(fs::exists(sourcesFolder / "sources1.js"));
+		ASSERT_NE(std::string::npos, coverage.find("\"source\":[1,0]"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CompactHtmlExporterTest, SourceNotFound)
+	{
+		cov::CoverageData data{ L"Test", 0 };
+
+		data.AddModule(L"Module.exe").AddFile(L"NotFound.cpp").AddLine(1, true);
+		Exporter::CompactHtmlExporter{ templateFolder_ }.Export(data, output_);
+
+		auto coverage = ReadContent(output_.GetPath() / Exporter::CompactHtmlExporter::CoverageFilename);
+		ASSERT_NE(std::string::npos, coverage.find("\"source\":null"));
+		ASSERT_FALSE(fs::exists(output_.GetPath() / Exporter::CompactHtmlExporter::SourcesFolder / "sources0.js"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CompactHtmlExporterTest, EncodeLineCoverage)
+	{
+		cov::FileCoverage file{ L"file" };
+		unsigned int firstLine = 0;
+
+		ASSERT_EQ("", Exporter::CompactHtmlExporter::EncodeLineCoverage(file, firstLine));
+
+		file.AddLine(10, true);
+		file.AddLine(11, false);
+		file.AddLine(13, true);
+		file.AddLine(14, false);
+		// 0b11000111, 0b00000001
+		ASSERT_EQ("xwE=", Exporter::CompactHtmlExporter::EncodeLineCoverage(file, firstLine));
+		ASSERT_EQ(10u, firstLine);
+	}
+
+	//-------------------------------------------------------------------------
+	// Durations and output sizes are recorded as test properties.
+	TEST_F(CompactHtmlExporterTest, DISABLED_CompareWithHtmlExporter)
+	{
+		const int fileCount = 2000;
+		const int linesByFile = 500;
+		TestHelper::TemporaryPath sourceFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		cov::CoverageData data{ L"Test", 0 };
+		auto& module = data.AddModule(L"Module.exe");
+
+		for (int i = 0; i < fileCount; ++i)
+		{
+			auto path = sourceFolder.GetPath() / ("File" + std::to_string(i) + ".cpp");
+			std::ofstream ofs{ path.string() };
+			auto& file = module.AddFile(path);
+
+			for (int line = 1; line <= linesByFile; ++line)
+			{
+				ofs << "\tif (value" << line << " < 0 && !found) // Comment " << line << '\n';
+				if (line % 3)
+					file.AddLine(line, line % 2 == 0);
+			}
+		}
+
+		std::vector<std::pair<std::string, std::unique_ptr<Exporter::IExporter>>> exporters;
+		exporters.emplace_back("Html", std::make_unique<Exporter::HtmlExporter>(templateFolder_));
+		exporters.emplace_back("CompactHtml", std::make_unique<Exporter::CompactHtmlExporter>(templateFolder_));
+
+		for (const auto& exporter : exporters)
+		{
+			TestHelper::TemporaryPath output;
+			auto start = std::chrono::steady_clock::now();
+
+			exporter.second->Export(data, output);
+			auto duration = std::chrono::steady_clock::now() - start;
+			size_t outputFileCount = 0;
+			auto size = GetFolderSize(output, outputFileCount);
+
+			RecordProperty(exporter.first + "Ms",
+				static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+			RecordProperty(exporter.first + "FileCount", static_cast<int>(outputFileCount));
+			RecordProperty(exporter.first + "KB", static_cast<int>(size / 1024));
+		}
+	}
+}
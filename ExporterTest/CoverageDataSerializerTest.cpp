@@ -18,14 +18,19 @@
 
 #include <sstream>
 #include <random>
+#include <chrono>
+#include <map>
 
 #include "CppCoverage/CoverageData.hpp"
 #include "CppCoverage/ModuleCoverage.hpp"
 #include "CppCoverage/FileCoverage.hpp"
 #include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
 #include "Exporter/Binary/CoverageDataSerializer.hpp"
 #include "Exporter/Binary/CoverageDataDeserializer.hpp"
 
+#include "Tools/ParallelFor.hpp"
+
 #include "TestHelper/TemporaryPath.hpp"
 #include "TestHelper/CoverageDataComparer.hpp"
 
@@ -74,21 +79,254 @@ namespace ExporterTest
 
 			return coverageData;
 		}
+
+		//---------------------------------------------------------------------
+		void CheckSerializeAndDeserialize(Exporter::BinaryFormat format)
+		{
+			TestHelper::TemporaryPath path;
+			Exporter::CoverageDataSerializer serializer{ format };
+			auto randomCoverageData = CreateRandomCoverageData();
+
+			serializer.Serialize(randomCoverageData, path.GetPath().string());
+
+			Exporter::CoverageDataDeserializer deserializer;
+			auto coverageDataRestored = deserializer.Deserialize(path.GetPath().string(), "");
+
+			TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageDataRestored);
+		}
+
+		//---------------------------------------------------------------------
+		void CheckDeserializeModules(Exporter::BinaryFormat format)
+		{
+			TestHelper::TemporaryPath path;
+			auto randomCoverageData = CreateRandomCoverageData();
+			std::map<boost::filesystem::path, const cov::ModuleCoverage*> selectedModules;
+			const auto& modules = randomCoverageData.GetModules();
+
+			for (size_t i = 0; i < modules.size(); i += 2)
+				selectedModules.emplace(modules[i]->GetPath(), modules[i].get());
+			Exporter::CoverageDataSerializer{ format }.Serialize(randomCoverageData, path);
+
+			auto coverageData = Exporter::CoverageDataDeserializer().DeserializeModules(path,
+				[&](const boost::filesystem::path& modulePath) { return selectedModules.count(modulePath) != 0; }, "");
+
+			ASSERT_EQ(randomCoverageData.GetName(), coverageData.GetName());
+			ASSERT_EQ(selectedModules.size(), coverageData.GetModules().size());
+			for (const auto& module : coverageData.GetModules())
+				TestHelper::CoverageDataComparer().AssertEquals(selectedModules.at(module->GetPath()), module.get());
+		}
+
+		//---------------------------------------------------------------------
+		void CheckDeserializeSummary(Exporter::BinaryFormat format)
+		{
+			TestHelper::TemporaryPath path;
+			auto randomCoverageData = CreateRandomCoverageData();
+			cov::CoverageRateComputer coverageRateComputer{ randomCoverageData };
+			const auto& modules = randomCoverageData.GetModules();
+
+			Exporter::CoverageDataSerializer{ format }.Serialize(randomCoverageData, path);
+			auto summary = Exporter::CoverageDataDeserializer().DeserializeSummary(path, "");
+
+			ASSERT_EQ(randomCoverageData.GetName(), summary.name);
+			ASSERT_EQ(randomCoverageData.GetExitCode(), summary.exitCode);
+			ASSERT_EQ(coverageRateComputer.GetCoverageRate().GetExecutedLinesCount(), summary.coverageRate.GetExecutedLinesCount());
+			ASSERT_EQ(coverageRateComputer.GetCoverageRate().GetTotalLinesCount(), summary.coverageRate.GetTotalLinesCount());
+			ASSERT_EQ(modules.size(), summary.modules.size());
+			for (size_t i = 0; i < modules.size(); ++i)
+			{
+				const auto& coverageRate = coverageRateComputer.GetCoverageRate(*modules[i]);
+
+				ASSERT_EQ(modules[i]->GetPath(), summary.modules[i].path);
+				ASSERT_EQ(coverageRate.GetExecutedLinesCount(), summary.modules[i].coverageRate.GetExecutedLinesCount());
+				ASSERT_EQ(coverageRate.GetUnExecutedLinesCount(), summary.modules[i].coverageRate.GetUnExecutedLinesCount());
+
+				const auto& files = modules[i]->GetFiles();
+				const auto& fileSummaries = summary.modules[i].files;
+
+				ASSERT_EQ(files.size(), fileSummaries.size());
+				for (size_t j = 0; j < files.size(); ++j)
+				{
+					const auto& fileCoverageRate = coverageRateComputer.GetCoverageRate(*files[j]);
+
+					ASSERT_EQ(files[j]->GetPath(), fileSummaries[j].path);
+					ASSERT_EQ(fileCoverageRate.GetExecutedLinesCount(), fileSummaries[j].coverageRate.GetExecutedLinesCount());
+					ASSERT_EQ(fileCoverageRate.GetUnExecutedLinesCount(), fileSummaries[j].coverageRate.GetUnExecutedLinesCount());
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void CheckDeserializeInParallel(Exporter::BinaryFormat format)
+		{
+			TestHelper::TemporaryPath path;
+			auto randomCoverageData = CreateRandomCoverageData();
+
+			Exporter::CoverageDataSerializer{ format }.Serialize(randomCoverageData, path);
+			auto coverageData = Exporter::CoverageDataDeserializer{ 4 }.Deserialize(path, "");
+			const auto& expectedModules = randomCoverageData.GetModules();
+			const auto& modules = coverageData.GetModules();
+
+			TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageData);
+			ASSERT_EQ(expectedModules.size(), modules.size());
+			for (size_t i = 0; i < modules.size(); ++i)
+				ASSERT_EQ(expectedModules[i]->GetPath(), modules[i]->GetPath());
+		}
+
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateLargeCoverageData()
+		{
+			cov::CoverageData coverageData{ L"Large", 0 };
+			std::default_random_engine generator;
+			std::uniform_int_distribution<int> distribution(0, 3);
+
+			for (int moduleIndex = 0; moduleIndex < 50; ++moduleIndex)
+			{
+				auto& module = coverageData.AddModule(L"C:\\Dev\\Module" + std::to_wstring(moduleIndex) + L".dll");
+
+				// Same files in all modules, like shared headers.
+				for (int fileIndex = 0; fileIndex < 400; ++fileIndex)
+				{
+					auto& file = module.AddFile(L"C:\\Dev\\Sources\\File" + std::to_wstring(fileIndex) + L".cpp");
+
+					for (int line = 1; line < 2000; ++line)
+					{
+						if (distribution(generator))
+							file.AddLine(line, distribution(generator) > 1);
+					}
+				}
+			}
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		int ToMilliseconds(std::chrono::steady_clock::duration duration)
+		{
+			return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+		}
 	}
 	
 	//-------------------------------------------------------------------------
 	TEST(CoverageDataSerializerTest, SerializeAndDeserialize)
 	{
-		TestHelper::TemporaryPath path;
-		Exporter::CoverageDataSerializer serializer;
-		auto randomCoverageData = CreateRandomCoverageData();
+		CheckSerializeAndDeserialize(Exporter::BinaryFormat::V2);
+	}
 
-		serializer.Serialize(randomCoverageData, path.GetPath().string());
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, SerializeAndDeserializeV1)
+	{
+		CheckSerializeAndDeserialize(Exporter::BinaryFormat::V1);
+	}
 
-		Exporter::CoverageDataDeserializer deserializer;		
-		auto coverageDataRestored = deserializer.Deserialize(path.GetPath().string(), "");
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, SerializeAndDeserializeCompressed)
+	{
+		CheckSerializeAndDeserialize(Exporter::BinaryFormat::V2Compressed);
+	}
 
-		TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageDataRestored);
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, V2IsSmallerThanV1)
+	{
+		TestHelper::TemporaryPath pathV1;
+		TestHelper::TemporaryPath pathV2;
+		TestHelper::TemporaryPath pathV2Compressed;
+		auto coverageData = CreateRandomCoverageData();
+
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V1 }.Serialize(coverageData, pathV1);
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V2 }.Serialize(coverageData, pathV2);
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V2Compressed }.Serialize(coverageData, pathV2Compressed);
+
+		ASSERT_LT(boost::filesystem::file_size(pathV2), boost::filesystem::file_size(pathV1));
+		ASSERT_LT(boost::filesystem::file_size(pathV2Compressed), boost::filesystem::file_size(pathV2));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeModules)
+	{
+		CheckDeserializeModules(Exporter::BinaryFormat::V2);
+		CheckDeserializeModules(Exporter::BinaryFormat::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeModulesWithoutTableOfContents)
+	{
+		CheckDeserializeModules(Exporter::BinaryFormat::V1);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeSummary)
+	{
+		CheckDeserializeSummary(Exporter::BinaryFormat::V2);
+		CheckDeserializeSummary(Exporter::BinaryFormat::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeSummaryWithoutTableOfContents)
+	{
+		CheckDeserializeSummary(Exporter::BinaryFormat::V1);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeInParallel)
+	{
+		CheckDeserializeInParallel(Exporter::BinaryFormat::V1);
+		CheckDeserializeInParallel(Exporter::BinaryFormat::V2);
+		CheckDeserializeInParallel(Exporter::BinaryFormat::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	// Durations are recorded as test properties.
+	TEST(CoverageDataSerializerTest, DISABLED_DeserializationScalingBenchmark)
+	{
+		auto coverageData = CreateLargeCoverageData();
+		std::vector<std::pair<std::string, Exporter::BinaryFormat>> formats = {
+			{ "V1", Exporter::BinaryFormat::V1 },
+			{ "V2", Exporter::BinaryFormat::V2 },
+			{ "V2Compressed", Exporter::BinaryFormat::V2Compressed } };
+
+		for (const auto& format : formats)
+		{
+			TestHelper::TemporaryPath path;
+
+			Exporter::CoverageDataSerializer{ format.second }.Serialize(coverageData, path);
+			for (size_t threadCount = 1; threadCount <= Tools::GetHardwareThreadCount(); threadCount *= 2)
+			{
+				auto start = std::chrono::steady_clock::now();
+				auto coverageDataRestored = Exporter::CoverageDataDeserializer{ threadCount }.Deserialize(path, "");
+				auto end = std::chrono::steady_clock::now();
+
+				RecordProperty(format.first + "Threads" + std::to_string(threadCount) + "Ms", ToMilliseconds(end - start));
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// File sizes and durations are recorded as test properties.
+	TEST(CoverageDataSerializerTest, DISABLED_SerializationBenchmark)
+	{
+		auto coverageData = CreateLargeCoverageData();
+		std::vector<std::pair<std::string, Exporter::BinaryFormat>> formats = {
+			{ "V1", Exporter::BinaryFormat::V1 },
+			{ "V2", Exporter::BinaryFormat::V2 },
+			{ "V2Compressed", Exporter::BinaryFormat::V2Compressed } };
+
+		for (const auto& format : formats)
+		{
+			TestHelper::TemporaryPath path;
+			auto start = std::chrono::steady_clock::now();
+
+			Exporter::CoverageDataSerializer{ format.second }.Serialize(coverageData, path);
+			auto serialized = std::chrono::steady_clock::now();
+			auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(path, "");
+			auto deserialized = std::chrono::steady_clock::now();
+			auto summary = Exporter::CoverageDataDeserializer().DeserializeSummary(path, "");
+			auto summaryDeserialized = std::chrono::steady_clock::now();
+
+			RecordProperty(format.first + "Bytes", std::to_string(boost::filesystem::file_size(path)));
+			RecordProperty(format.first + "SerializeMs", ToMilliseconds(serialized - start));
+			RecordProperty(format.first + "DeserializeMs", ToMilliseconds(deserialized - serialized));
+			RecordProperty(format.first + "SummaryMs", ToMilliseconds(summaryDeserialized - deserialized));
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -106,4 +344,38 @@ namespace ExporterTest
 
 		ASSERT_THROW(deserializer.Deserialize(path.GetPath(), "todo"), std::runtime_error);
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, InvalidModuleCount)
+	{
+		TestHelper::TemporaryPath path;
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V2 }.Serialize(cov::CoverageData{ L"", 0 }, path);
+
+		std::string bytes;
+		{
+			std::ifstream ifs{ path.GetPath().string(), std::ios::binary };
+			bytes.assign(std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{});
+		}
+
+		// File type id, empty name, exit code and compression.
+		size_t moduleCountPosition = 1 + 1 + 4 + 1;
+		for (auto fileTypeId = Exporter::CoverageDataSerializer::FileTypeIdV2; fileTypeId >= 0x80; fileTypeId >>= 7)
+			++moduleCountPosition;
+		ASSERT_EQ(0, bytes.at(moduleCountPosition));
+		bytes.replace(moduleCountPosition, 1, "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F");
+		{
+			std::ofstream ofs{ path.GetPath().string(), std::ios::binary };
+			ofs << bytes;
+		}
+
+		try
+		{
+			Exporter::CoverageDataDeserializer{}.Deserialize(path, "Invalid module count");
+			FAIL();
+		}
+		catch (const std::runtime_error& e)
+		{
+			ASSERT_EQ(std::string{ "Invalid module count" }, e.what());
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <random>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/CoverageDataMerger.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "Exporter/Binary/CoverageDataStreamMerger.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/CoverageDataComparer.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateRandomCoverageData(unsigned int seed)
+		{
+			cov::CoverageData coverageData{ L"Test" + std::to_wstring(seed), static_cast<int>(seed) };
+			std::default_random_engine generator{ seed };
+			std::uniform_int_distribution<int> distribution(0, 1);
+
+			for (int moduleIndex = 0; moduleIndex < 10; ++moduleIndex)
+			{
+				if (distribution(generator))
+				{
+					auto& module = coverageData.AddModule(std::to_wstring(moduleIndex));
+
+					for (int fileIndex = 0; fileIndex < 10; ++fileIndex)
+					{
+						if (distribution(generator))
+						{
+							auto& file = module.AddFile(std::to_wstring(fileIndex));
+
+							for (int line = 0; line < 50; ++line)
+							{
+								if (distribution(generator))
+									file.AddLine(line, distribution(generator) != 0);
+							}
+						}
+					}
+				}
+			}
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		void CheckStreamMerge(bool aggregateByFile, Exporter::BinaryFormat outputFormat)
+		{
+			std::vector<cov::CoverageData> coverageDatas;
+			std::vector<std::unique_ptr<TestHelper::TemporaryPath>> inputs;
+			std::vector<fs::path> inputPaths;
+
+			for (unsigned int seed = 0; seed < 5; ++seed)
+			{
+				coverageDatas.push_back(CreateRandomCoverageData(seed));
+				inputs.push_back(std::make_unique<TestHelper::TemporaryPath>());
+				inputPaths.push_back(inputs.back()->GetPath());
+				// Inputs use all binary formats.
+				auto format = static_cast<Exporter::BinaryFormat>(seed % 3);
+				Exporter::CoverageDataSerializer{ format }.Serialize(coverageDatas.back(), inputPaths.back());
+			}
+
+			cov::CoverageDataMerger merger;
+			auto expectedCoverageData = merger.Merge(coverageDatas);
+			if (aggregateByFile)
+				merger.MergeFileCoverage(expectedCoverageData);
+
+			TestHelper::TemporaryPath output;
+			auto exitCode = Exporter::CoverageDataStreamMerger{ outputFormat }.Merge(inputPaths, output, aggregateByFile);
+			auto coverageData = Exporter::CoverageDataDeserializer().Deserialize(output, "");
+
+			ASSERT_EQ(expectedCoverageData.GetExitCode(), exitCode);
+			TestHelper::CoverageDataComparer().AssertEquals(expectedCoverageData, coverageData);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, Merge)
+	{
+		CheckStreamMerge(false, Exporter::BinaryFormat::V2);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, MergeAggregateByFile)
+	{
+		CheckStreamMerge(true, Exporter::BinaryFormat::V2);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, MergeCompressed)
+	{
+		CheckStreamMerge(false, Exporter::BinaryFormat::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, Version1Output)
+	{
+		ASSERT_THROW(Exporter::CoverageDataStreamMerger{ Exporter::BinaryFormat::V1 }, std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, InvalidFile)
+	{
+		TestHelper::TemporaryPath input{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath output;
+
+		ASSERT_THROW(Exporter::CoverageDataStreamMerger().Merge({ input.GetPath() }, output, false), std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataStreamMergerTest, OutputNotWritable)
+	{
+		TestHelper::TemporaryPath input;
+		TestHelper::TemporaryPath output{ TestHelper::TemporaryPathOption::CreateAsFolder };
+
+		Exporter::CoverageDataSerializer{}.Serialize(CreateRandomCoverageData(0), input);
+		ASSERT_THROW(Exporter::CoverageDataStreamMerger().Merge({ input.GetPath() }, output, false), std::exception);
+	}
+}
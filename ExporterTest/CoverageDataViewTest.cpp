@@ -0,0 +1,217 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <random>
+#include <chrono>
+
+#include <malloc.h>
+#include <windows.h>
+#include <psapi.h>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "Exporter/Binary/CoverageDataView.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/CoverageDataComparer.hpp"
+
+namespace cov = CppCoverage;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::CoverageData CreateRandomCoverageData(int moduleCount, int fileCount, int lineCount)
+		{
+			cov::CoverageData coverageData{ L"Test", 42 };
+			std::default_random_engine generator;
+			std::uniform_int_distribution<int> distribution(0, 1);
+
+			for (int moduleIndex = 0; moduleIndex < moduleCount; ++moduleIndex)
+			{
+				auto& module = coverageData.AddModule(L"Module" + std::to_wstring(moduleIndex));
+
+				for (int fileIndex = 0; fileIndex < fileCount; ++fileIndex)
+				{
+					if (distribution(generator))
+					{
+						auto& file = module.AddFile(L"File" + std::to_wstring(fileIndex));
+
+						for (int line = 0; line < lineCount; ++line)
+						{
+							if (distribution(generator))
+								file.AddLine(line * 3, distribution(generator) != 0);
+						}
+					}
+				}
+			}
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		void CheckToCoverageData(Exporter::BinaryFormat format)
+		{
+			TestHelper::TemporaryPath path;
+			auto coverageData = CreateRandomCoverageData(10, 10, 200);
+
+			Exporter::CoverageDataSerializer{ format }.Serialize(coverageData, path);
+			Exporter::CoverageDataView view{ path };
+
+			TestHelper::CoverageDataComparer().AssertEquals(coverageData, view.ToCoverageData());
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetWorkingSetSize()
+		{
+			PROCESS_MEMORY_COUNTERS counters;
+
+			if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+				return 0;
+			return counters.WorkingSetSize;
+		}
+
+		//---------------------------------------------------------------------
+		int ToMegabytes(size_t size)
+		{
+			return static_cast<int>(size / (1024 * 1024));
+		}
+
+		//---------------------------------------------------------------------
+		int ToMilliseconds(std::chrono::steady_clock::duration duration)
+		{
+			return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, ToCoverageData)
+	{
+		CheckToCoverageData(Exporter::BinaryFormat::V2);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, ToCoverageDataCompressed)
+	{
+		CheckToCoverageData(Exporter::BinaryFormat::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, Iterate)
+	{
+		TestHelper::TemporaryPath path;
+		auto coverageData = CreateRandomCoverageData(5, 5, 100);
+		cov::CoverageRateComputer coverageRateComputer{ coverageData };
+
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V2 }.Serialize(coverageData, path);
+		Exporter::CoverageDataView view{ path };
+		const auto& modules = coverageData.GetModules();
+
+		ASSERT_EQ(coverageData.GetName(), view.GetName());
+		ASSERT_EQ(coverageData.GetExitCode(), view.GetExitCode());
+		ASSERT_EQ(modules.size(), view.GetModuleCount());
+		for (size_t i = 0; i < modules.size(); ++i)
+		{
+			auto moduleView = view.GetModule(i);
+			const auto& files = modules[i]->GetFiles();
+			const auto& coverageRate = coverageRateComputer.GetCoverageRate(*modules[i]);
+
+			ASSERT_EQ(modules[i]->GetPath(), view.GetModulePath(i));
+			ASSERT_EQ(modules[i]->GetPath(), moduleView.GetPath());
+			ASSERT_EQ(coverageRate.GetExecutedLinesCount(), moduleView.GetCoverageRate().GetExecutedLinesCount());
+			ASSERT_EQ(coverageRate.GetTotalLinesCount(), moduleView.GetCoverageRate().GetTotalLinesCount());
+			ASSERT_EQ(files.size(), moduleView.GetFiles().size());
+			for (size_t j = 0; j < files.size(); ++j)
+			{
+				const auto& fileView = moduleView.GetFiles()[j];
+				const auto& lines = files[j]->GetLines();
+				size_t lineIndex = 0;
+
+				ASSERT_EQ(files[j]->GetPath(), fileView.GetPath());
+				ASSERT_EQ(lines.size(), fileView.GetLineCount());
+				for (const auto& line : fileView)
+				{
+					ASSERT_EQ(lines.at(lineIndex).GetLineNumber(), line.GetLineNumber());
+					ASSERT_EQ(lines.at(lineIndex).HasBeenExecuted(), line.HasBeenExecuted());
+					++lineIndex;
+				}
+				ASSERT_EQ(lines.size(), lineIndex);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, Version1)
+	{
+		TestHelper::TemporaryPath path;
+
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V1 }.Serialize(
+			CreateRandomCoverageData(2, 2, 10), path);
+		ASSERT_THROW(Exporter::CoverageDataView{ path }, std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	// Load time and working set growth are recorded as test properties.
+	TEST(CoverageDataViewTest, DISABLED_ViewBenchmark)
+	{
+		TestHelper::TemporaryPath path;
+
+		Exporter::CoverageDataSerializer{ Exporter::BinaryFormat::V2 }.Serialize(CreateRandomCoverageData(50, 400, 4000), path);
+		_heapmin(); // Do not reuse the memory of the generated coverage data.
+		RecordProperty("FileSizeMB", ToMegabytes(static_cast<size_t>(boost::filesystem::file_size(path))));
+
+		{
+			auto initialWorkingSet = GetWorkingSetSize();
+			auto start = std::chrono::steady_clock::now();
+			Exporter::CoverageDataView view{ path };
+			int executedLinesCount = 0;
+
+			for (size_t i = 0; i < view.GetModuleCount(); ++i)
+			{
+				auto module = view.GetModule(i);
+
+				for (const auto& file : module.GetFiles())
+				{
+					for (const auto& line : file)
+						executedLinesCount += line.HasBeenExecuted() ? 1 : 0;
+				}
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			RecordProperty("ViewMs", ToMilliseconds(end - start));
+			RecordProperty("ViewWorkingSetMB", ToMegabytes(GetWorkingSetSize() - initialWorkingSet));
+			RecordProperty("ExecutedLines", executedLinesCount);
+		}
+
+		{
+			auto initialWorkingSet = GetWorkingSetSize();
+			auto start = std::chrono::steady_clock::now();
+			auto coverageData = Exporter::CoverageDataDeserializer().Deserialize(path, "");
+			auto end = std::chrono::steady_clock::now();
+
+			RecordProperty("DeserializeMs", ToMilliseconds(end - start));
+			RecordProperty("DeserializeWorkingSetMB", ToMegabytes(GetWorkingSetSize() - initialWorkingSet));
+		}
+	}
+}
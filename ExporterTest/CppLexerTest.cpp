@@ -0,0 +1,193 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "Exporter/Html/CppLexer.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+using Exporter::CppTokenType;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		using Tokens = std::vector<std::pair<CppTokenType, std::string>>;
+
+		//---------------------------------------------------------------------
+		Tokens Tokenize(const std::string& source)
+		{
+			Exporter::CppLexer lexer{ source.data(), source.data() + source.size() };
+			Exporter::CppToken token;
+			Tokens tokens;
+
+			while (lexer.Next(token))
+				tokens.emplace_back(token.type, std::string{ token.begin, token.end });
+			return tokens;
+		}
+
+		//---------------------------------------------------------------------
+		std::string CreateSource(int lineCount)
+		{
+			std::string source;
+
+			for (int i = 0; i < lineCount; ++i)
+			{
+				source += "\t// Comment " + std::to_string(i) + "\r\n";
+				source += "\tfor (int i = 0; i < values.size() && !found; ++i)\r\n";
+				source += "\t\tstd::cout << \"Value: \" << values[i] * 0.5 << std::endl;\r\n";
+			}
+			return source;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Empty)
+	{
+		ASSERT_EQ(Tokens{}, Tokenize(""));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, KeywordsAndIdentifiers)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::Keyword, "const" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::Keyword, "int" },
+			{ CppTokenType::Plain, " integer_value\n  constant " },
+			{ CppTokenType::Keyword, "static_assert" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("const int integer_value\n  constant static_assert"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Literals)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::Literal, "0x1F'FFu" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::Literal, "1.5e-3" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::Literal, ".5f" },
+			{ CppTokenType::Plain, "-" },
+			{ CppTokenType::Literal, "1" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("0x1F'FFu 1.5e-3 .5f-1"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Strings)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::String, "\"a\\\"b\"" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::String, "'\\''" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::String, "L\"w\"" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::String, "u8\"x\"" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::String, "R\"d(a)\"\nb)d\"" },
+			{ CppTokenType::Plain, " Rx" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("\"a\\\"b\" '\\'' L\"w\" u8\"x\" R\"d(a)\"\nb)d\" Rx"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, UnterminatedString)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::String, "\"a" },
+			{ CppTokenType::Plain, "\r\nb" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("\"a\r\nb"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Comments)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::Comment, "// a \\\r\n b" },
+			{ CppTokenType::Plain, "\r\n" },
+			{ CppTokenType::Comment, "/* c\n * d */" },
+			{ CppTokenType::Plain, " e " },
+			{ CppTokenType::Comment, "/* f" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("// a \\\r\n b\r\n/* c\n * d */ e /* f"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Preprocessor)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::Preprocessor, "#include" },
+			{ CppTokenType::Plain, " " },
+			{ CppTokenType::String, "<vector>" },
+			{ CppTokenType::Plain, "\n  " },
+			{ CppTokenType::Preprocessor, "# define" },
+			{ CppTokenType::Plain, " X < #a" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("#include <vector>\n  # define X < #a"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppLexerTest, Operators)
+	{
+		Tokens expectedTokens = {
+			{ CppTokenType::Plain, "a->b(" },
+			{ CppTokenType::Literal, ".5" },
+			{ CppTokenType::Plain, ")" },
+			{ CppTokenType::Comment, "///c" } };
+
+		ASSERT_EQ(expectedTokens, Tokenize("a->b(.5)///c"));
+	}
+
+	//-------------------------------------------------------------------------
+	// Throughputs are recorded as test properties.
+	TEST(CppLexerTest, DISABLED_LexerBenchmark)
+	{
+		TestHelper::TemporaryPath sourcePath;
+		{
+			std::ofstream ofs{ sourcePath.GetPath().string(), std::ios::binary };
+			ofs << CreateSource(200000);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::ifstream ifs{ sourcePath.GetPath().string(), std::ios::binary };
+		std::string source(static_cast<size_t>(boost::filesystem::file_size(sourcePath.GetPath())), '\0');
+		ifs.read(&source[0], source.size());
+		auto readDuration = std::chrono::steady_clock::now() - start;
+
+		start = std::chrono::steady_clock::now();
+		Exporter::CppLexer lexer{ source.data(), source.data() + source.size() };
+		Exporter::CppToken token;
+		int tokenCount = 0;
+
+		while (lexer.Next(token))
+			++tokenCount;
+		auto lexerDuration = std::chrono::steady_clock::now() - start;
+
+		auto sizeInMB = static_cast<double>(source.size()) / (1024 * 1024);
+		RecordProperty("ReadMBPerSecond", std::to_string(sizeInMB / std::chrono::duration<double>(readDuration).count()));
+		RecordProperty("LexerMBPerSecond", std::to_string(sizeInMB / std::chrono::duration<double>(lexerDuration).count()));
+		RecordProperty("TokenCount", tokenCount);
+	}
+}
@@ -0,0 +1,27 @@
+#include "Header.hpp"
+
+int Unused(int value)
+{
+	return value + 1;
+}
+
+int Sum(int count)
+{
+	int sum = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (i % 2)
+			sum += Square(i);
+		else
+			sum -= i;
+	}
+	return sum;
+}
+
+int main(int argc, char**)
+{
+	if (argc > 1)
+		return Unused(argc);
+	return Sum(5) > 100 ? 1 : 0;
+}
@@ -0,0 +1,4 @@
+inline int Square(int value)
+{
+	return value * value;
+}
@@ -0,0 +1,323 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+
+#include "Exporter/ExporterException.hpp"
+#include "Exporter/Import/GcovImporter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		const uint32_t Stamp = 42;
+
+		//---------------------------------------------------------------------
+		// Write notes and data files in the format of gcc 12.
+		class GcovFileWriter
+		{
+		public:
+			//-----------------------------------------------------------------
+			GcovFileWriter(const char* magic, uint32_t stamp)
+			{
+				Write(ToWord(magic));
+				Write(ToWord("B22*"));
+				Write(stamp);
+				Write(0);
+			}
+
+			//-----------------------------------------------------------------
+			void Write(uint32_t value)
+			{
+				content_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+
+			//-----------------------------------------------------------------
+			void WriteCounter(uint64_t value)
+			{
+				Write(static_cast<uint32_t>(value));
+				Write(static_cast<uint32_t>(value >> 32));
+			}
+
+			//-----------------------------------------------------------------
+			void WriteString(const std::string& value)
+			{
+				Write(static_cast<uint32_t>(value.empty() ? 0 : value.size() + 1));
+				if (!value.empty())
+					content_.append(value.c_str(), value.size() + 1);
+			}
+
+			//-----------------------------------------------------------------
+			void BeginRecord(uint32_t tag)
+			{
+				Write(tag);
+				Write(0);
+				recordBegin_ = content_.size();
+			}
+
+			//-----------------------------------------------------------------
+			void EndRecord()
+			{
+				auto length = static_cast<uint32_t>(content_.size() - recordBegin_);
+
+				std::memcpy(&content_[recordBegin_ - sizeof(length)], &length, sizeof(length));
+			}
+
+			//-----------------------------------------------------------------
+			void Save(const fs::path& path) const
+			{
+				std::ofstream ofs{ path.string(), std::ios::binary };
+
+				ofs.write(content_.data(), content_.size());
+			}
+
+		private:
+			//-----------------------------------------------------------------
+			static uint32_t ToWord(const char* value)
+			{
+				return (static_cast<uint32_t>(value[0]) << 24) | (static_cast<uint32_t>(value[1]) << 16)
+					| (static_cast<uint32_t>(value[2]) << 8) | static_cast<uint32_t>(value[3]);
+			}
+
+		private:
+			std::string content_;
+			size_t recordBegin_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		struct FunctionCounts
+		{
+			uint64_t callCount;
+			uint64_t thenCount;
+		};
+
+		//---------------------------------------------------------------------
+		// Each function is an if else statement on 4 lines: condition, then, else and end.
+		// Blocks: 0 entry, 1 exit, 2 condition, 3 then, 4 else and 5 end.
+		// The arcs 2->3 and 4->5 are not on the spanning tree and have a counter.
+		void WriteObject(
+			const fs::path& notesPath,
+			const std::string& sourceFile,
+			const std::vector<FunctionCounts>& functions,
+			uint32_t dataStamp = Stamp)
+		{
+			const uint32_t arcs[][3] = { { 0, 2, 1 }, { 2, 3, 0 }, { 2, 4, 1 }, { 3, 5, 1 }, { 4, 5, 0 }, { 5, 1, 1 } };
+			GcovFileWriter notes{ "gcno", Stamp };
+			GcovFileWriter data{ "gcda", dataStamp };
+
+			notes.WriteString("/src");
+			notes.Write(1);
+			for (uint32_t i = 0; i < functions.size(); ++i)
+			{
+				notes.BeginRecord(0x01000000);
+				notes.Write(i);
+				notes.Write(0);
+				notes.Write(0);
+				notes.WriteString("Function" + std::to_string(i));
+				notes.Write(0);
+				notes.EndRecord();
+				notes.BeginRecord(0x01410000);
+				notes.Write(6);
+				notes.EndRecord();
+				for (const auto& arc : arcs)
+				{
+					notes.BeginRecord(0x01430000);
+					notes.Write(arc[0]);
+					notes.Write(arc[1]);
+					notes.Write(arc[2]);
+					notes.EndRecord();
+				}
+				for (uint32_t block = 2; block < 6; ++block)
+				{
+					notes.BeginRecord(0x01450000);
+					notes.Write(block);
+					notes.Write(0);
+					notes.WriteString(sourceFile);
+					notes.Write(i * 4 + block - 1);
+					notes.Write(0);
+					notes.WriteString("");
+					notes.EndRecord();
+				}
+
+				data.BeginRecord(0x01000000);
+				data.Write(i);
+				data.Write(0);
+				data.Write(0);
+				data.EndRecord();
+				data.BeginRecord(0x01a10000);
+				data.WriteCounter(functions[i].thenCount);
+				data.WriteCounter(functions[i].callCount - functions[i].thenCount);
+				data.EndRecord();
+			}
+			notes.Save(notesPath);
+			data.Save(fs::path{ notesPath }.replace_extension(Exporter::GcovImporter::DataExtension));
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<bool> GetExecutedLines(const cov::FileCoverage& file)
+		{
+			std::vector<bool> executedLines;
+
+			for (const auto& line : file.GetLines())
+				executedLines.push_back(line.HasBeenExecuted());
+			return executedLines;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, Import)
+	{
+		// Built from Data/Gcov/Gcov.cpp with gcc 12.2: g++ --coverage Gcov.cpp
+		auto notesPath = fs::path(PROJECT_DIR) / "Data" / "Gcov" / "Gcov.gcno";
+		auto coverageData = Exporter::GcovImporter{}.Import(notesPath);
+
+		ASSERT_EQ(1u, coverageData.GetModules().size());
+		const auto& module = *coverageData.GetModules().at(0);
+		ASSERT_EQ(fs::path(notesPath).replace_extension(".o"), module.GetPath());
+		ASSERT_EQ(2u, module.GetFiles().size());
+
+		const auto& source = *module.GetFiles().at(0);
+		ASSERT_EQ(fs::path("/tmp/gc") / "Gcov.cpp", source.GetPath());
+		ASSERT_EQ(13u, source.GetLines().size());
+		for (auto line : { 8, 10, 12, 14, 15, 17, 19, 22, 24, 26 })
+			ASSERT_TRUE(source[line]->HasBeenExecuted()) << line;
+		for (auto line : { 3, 5, 25 })
+			ASSERT_FALSE(source[line]->HasBeenExecuted()) << line;
+
+		const auto& header = *module.GetFiles().at(1);
+		ASSERT_EQ(fs::path("/tmp/gc") / "Header.hpp", header.GetPath());
+		ASSERT_EQ((std::vector<bool>{ true, true }), GetExecutedLines(header));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, FlowGraph)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		auto notesPath = folder.GetPath() / "File.gcno";
+
+		WriteObject(notesPath, "File.cpp", { { 3, 0 }, { 0, 0 }, { 2, 2 } });
+		auto module = Exporter::GcovImporter{}.ImportObject(notesPath);
+
+		ASSERT_EQ(1u, module->GetFiles().size());
+		const auto& file = *module->GetFiles().at(0);
+		ASSERT_EQ(fs::path("/src") / "File.cpp", file.GetPath());
+		ASSERT_EQ((std::vector<bool>{
+			true, false, true, true,
+			false, false, false, false,
+			true, true, false, true }), GetExecutedLines(file));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, NoDataFile)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		auto notesPath = folder.GetPath() / "File.gcno";
+
+		WriteObject(notesPath, "File.cpp", { { 1, 1 } });
+		fs::remove(fs::path{ notesPath }.replace_extension(Exporter::GcovImporter::DataExtension));
+		auto module = Exporter::GcovImporter{}.ImportObject(notesPath);
+
+		ASSERT_EQ((std::vector<bool>{ false, false, false, false }), GetExecutedLines(*module->GetFiles().at(0)));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, DataFileOfAnotherBuild)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		auto notesPath = folder.GetPath() / "File.gcno";
+
+		WriteObject(notesPath, "File.cpp", { { 1, 1 } }, Stamp + 1);
+		ASSERT_THROW(Exporter::GcovImporter{}.ImportObject(notesPath), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, InvalidFile)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		auto notesPath = folder.GetPath() / "File.gcno";
+		{
+			std::ofstream ofs{ notesPath.string() };
+			ofs << "Not a notes file";
+		}
+
+		ASSERT_THROW(Exporter::GcovImporter{}.ImportObject(notesPath), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, Folder)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+
+		fs::create_directory(folder.GetPath() / "SubFolder");
+		WriteObject(folder.GetPath() / "SubFolder" / "File2.gcno", "File2.cpp", { { 1, 0 } });
+		WriteObject(folder.GetPath() / "File1.cpp.gcno", "File1.cpp", { { 1, 1 } });
+		auto coverageData = Exporter::GcovImporter{}.Import(folder);
+
+		ASSERT_TRUE(Exporter::GcovImporter::IsGcovPath(folder));
+		ASSERT_EQ(2u, coverageData.GetModules().size());
+		ASSERT_EQ(folder.GetPath() / "File1.cpp.o", coverageData.GetModules().at(0)->GetPath());
+		ASSERT_EQ(folder.GetPath() / "SubFolder" / "File2.o", coverageData.GetModules().at(1)->GetPath());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(GcovImporterTest, IsGcovPath)
+	{
+		ASSERT_TRUE(Exporter::GcovImporter::IsGcovPath(L"File.gcno"));
+		ASSERT_TRUE(Exporter::GcovImporter::IsGcovPath(L"File.gcda"));
+		ASSERT_FALSE(Exporter::GcovImporter::IsGcovPath(L"File.cov"));
+	}
+
+	//-------------------------------------------------------------------------
+	// The duration is recorded as a test property.
+	TEST(GcovImporterTest, DISABLED_ImportBenchmark)
+	{
+		const int objectCount = 2000;
+		const int functionCount = 200;
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		std::vector<FunctionCounts> functions;
+
+		for (int i = 0; i < functionCount; ++i)
+			functions.push_back(FunctionCounts{ static_cast<uint64_t>(i % 3 + 1), static_cast<uint64_t>(i % 2) });
+		for (int i = 0; i < objectCount; ++i)
+		{
+			auto name = "File" + std::to_string(i);
+
+			WriteObject(folder.GetPath() / (name + ".gcno"), name + ".cpp", functions);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto coverageData = Exporter::GcovImporter{}.Import(folder);
+		auto duration = std::chrono::steady_clock::now() - start;
+
+		ASSERT_EQ(static_cast<size_t>(objectCount), coverageData.GetModules().size());
+		RecordProperty("ImportMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+	}
+}
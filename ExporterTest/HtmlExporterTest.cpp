@@ -25,6 +25,7 @@
 
 #include "Exporter/Html/HtmlExporter.hpp"
 #include "Exporter/Html/HtmlFolderStructure.hpp"
+#include "Exporter/Html/HtmlReportManifest.hpp"
 
 #include "TestHelper/TemporaryPath.hpp"
 
@@ -158,5 +159,47 @@ namespace ExporterTest
 		ASSERT_TRUE(fs::exists(modulesPath / "module" / (filename + L"2.html")));
 		ASSERT_TRUE(fs::exists(modulesPath / "module.html"));
 	}
-}
 
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, SameSourceFileSeveralThreads)
+	{
+		const int fileCount = 20;
+		Exporter::HtmlExporter htmlExporter{ fs::canonical(OUT_DIR) / "Template", 4 };
+		cov::CoverageData data{ L"Test", 0 };
+		const std::wstring filename = L"TestFile1.cpp";
+		auto& module = data.AddModule(L"Module.exe");
+
+		for (int i = 0; i < fileCount; ++i)
+			module.AddFile(fs::path(PROJECT_DIR) / "Data" / filename).AddLine(0, true);
+
+		htmlExporter.Export(data, output_);
+
+		auto modulePath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules / "module";
+		ASSERT_TRUE(fs::exists(modulePath / (filename + L".html")));
+		for (int i = 2; i <= fileCount; ++i)
+			ASSERT_TRUE(fs::exists(modulePath / (filename + std::to_wstring(i) + L".html")));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, UnchangedPagesAreNotGenerated)
+	{
+		const std::wstring filename = L"TestFile1.cpp";
+		cov::CoverageData data{ L"Test", 0 };
+		auto& file = data.AddModule(L"Module.exe").AddFile(fs::path(PROJECT_DIR) / "Data" / filename);
+		auto pagePath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules / "module" / (filename + L".html");
+		const std::time_t previousTime = 0;
+
+		file.AddLine(0, true);
+		file.AddLine(1, false);
+		htmlExporter_.Export(data, output_);
+		ASSERT_TRUE(fs::exists(output_.GetPath() / Exporter::HtmlReportManifest::Filename));
+
+		fs::last_write_time(pagePath, previousTime);
+		htmlExporter_.Export(data, output_);
+		ASSERT_EQ(previousTime, fs::last_write_time(pagePath));
+
+		file.UpdateLine(1, true);
+		htmlExporter_.Export(data, output_);
+		ASSERT_NE(previousTime, fs::last_write_time(pagePath));
+	}
+}
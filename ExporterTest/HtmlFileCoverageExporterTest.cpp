@@ -16,8 +16,13 @@
 
 #include "stdafx.h"
 
+#include <chrono>
+#include <fstream>
 #include <boost/algorithm/string.hpp>
+#include <boost/spirit/include/classic.hpp>
+#include <boost/spirit/include/classic_tree_to_xml.hpp>
 #include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
 #include "Exporter/Html/HtmlFileCoverageExporter.hpp"
 #include "TestHelper/TemporaryPath.hpp"
 
@@ -32,7 +37,7 @@ namespace ExporterTest
 			NotExecutable
 		};
 
-		using SourceLines = std::vector<std::pair<std::wstring, CoverageType>>;
+		using SourceLines = std::vector<std::pair<std::string, CoverageType>>;
 
 		//-----------------------------------------------------------------
 		void FillSources(
@@ -40,7 +45,7 @@ namespace ExporterTest
 			const TestHelper::TemporaryPath& sourceFile,
 			CppCoverage::FileCoverage& fileCoverage)
 		{
-			std::wofstream ofs(sourceFile.GetPath().wstring());
+			std::ofstream ofs(sourceFile.GetPath().string());
 
 			unsigned int lineNumber = 1;
 			for (const auto& line : sourceLines)
@@ -58,35 +63,107 @@ namespace ExporterTest
 		}
 
 		//-----------------------------------------------------------------
-		std::vector<std::wstring> GetExportedLines(
+		std::string RemoveLineNumbers(std::string exportedString)
+		{
+			const auto& lineNumberStyle = Exporter::HtmlFileCoverageExporter::StyleLineNumber;
+			const auto& endStyle = Exporter::HtmlFileCoverageExporter::EndStyle;
+
+			for (auto pos = exportedString.find(lineNumberStyle); pos != std::string::npos;
+				pos = exportedString.find(lineNumberStyle, pos))
+			{
+				auto endPos = exportedString.find(endStyle, pos);
+				exportedString.erase(pos, endPos + endStyle.size() - pos);
+			}
+			return exportedString;
+		}
+
+		//-----------------------------------------------------------------
+		std::vector<std::string> SplitExportedLines(const std::string& exportedString)
+		{
+			std::vector<std::string> lines;
+			boost::split(lines, RemoveLineNumbers(exportedString), boost::is_any_of("\n"));
+
+			// First line is always empty
+			lines.erase(lines.begin());
+			return lines;
+		}
+
+		//-----------------------------------------------------------------
+		std::vector<std::string> GetExportedLines(
 			const SourceLines& sourceLines)
 		{
-			std::wostringstream ostr;
+			std::string output;
 			TestHelper::TemporaryPath sourceFile;
 			CppCoverage::FileCoverage fileCoverage{ sourceFile };
 
 			FillSources(sourceLines, sourceFile, fileCoverage);
 
-			if (!Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, ostr))
-				throw std::runtime_error("Error in HtmlFileCoverageExporter::Export");
+			Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
 
-			std::wstring exportedString = ostr.str();
-			std::vector<std::wstring> lines;
-			boost::split(lines, exportedString, boost::is_any_of("\n"));
-
-			// First line is always empty
-			lines.erase(lines.begin());
+			auto lines = SplitExportedLines(output);
 
 			if (lines.size() != sourceLines.size())
 				throw std::runtime_error("Invalid number of exported lines.");
 			return lines;
 		}
+
+		//-----------------------------------------------------------------
+		std::string ExportRawContent(const std::string& content)
+		{
+			std::string output;
+			TestHelper::TemporaryPath sourceFile;
+			CppCoverage::FileCoverage fileCoverage{ sourceFile };
+			{
+				std::ofstream ofs(sourceFile.GetPath().string(), std::ios::binary);
+				ofs << content;
+			}
+			Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
+
+			return RemoveLineNumbers(output);
+		}
+
+		//-----------------------------------------------------------------
+		// Previous implementation, used as reference in the benchmark.
+		void ExportWithWifstream(
+			const CppCoverage::FileCoverage& fileCoverage, 
+			std::wostream& output)
+		{
+			std::wifstream ifs{ fileCoverage.GetPath().string() };
+			std::wstring line;
+			const CppCoverage::LineCoverage* previousLineCoverage = nullptr;
+
+			for (int i = 1; std::getline(ifs, line); ++i)
+			{
+				auto lineCoverage = fileCoverage[i];
+				auto sameCoverage = (!lineCoverage || !previousLineCoverage)
+					? lineCoverage == previousLineCoverage
+					: lineCoverage->HasBeenExecuted() == previousLineCoverage->HasBeenExecuted();
+
+				if (!sameCoverage && previousLineCoverage)
+					output << L"</span>";
+				output << std::endl;
+				if (!sameCoverage && lineCoverage)
+				{
+					output << (lineCoverage->HasBeenExecuted() 
+						? L"<span style = \"background-color:#dfd\">"
+						: L"<span style = \"background-color:#fdd\">");
+				}
+				output << boost::spirit::classic::xml::encode(line);
+				previousLineCoverage = lineCoverage;
+			}
+			if (previousLineCoverage)
+				output << L"</span>";
+		}
 	}
 
-	const auto StyleExecuted = Exporter::HtmlFileCoverageExporter::StyleBackgroundColorExecuted;
-	const auto StyleNotExecuted = Exporter::HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted;
-	const auto EndStyle = Exporter::HtmlFileCoverageExporter::EndStyle;
-	const std::wstring Line = L"line";
+	const auto& StyleExecuted = Exporter::HtmlFileCoverageExporter::StyleBackgroundColorExecuted;
+	const auto& StyleNotExecuted = Exporter::HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted;
+	const auto& EndStyle = Exporter::HtmlFileCoverageExporter::EndStyle;
+	const std::string Line = "line";
+	const std::string KeywordStyle = "<span class=\"kwd\">";
+	const std::string LiteralStyle = "<span class=\"lit\">";
+	const std::string StringStyle = "<span class=\"str\">";
+	const std::string CommentStyle = "<span class=\"com\">";
 
 	//---------------------------------------------------------------------
 	TEST(HtmlFileCoverageExporterTest, ExecutedLine)
@@ -112,7 +189,7 @@ namespace ExporterTest
 	//---------------------------------------------------------------------
 	TEST(HtmlFileCoverageExporterTest, SeveralLines)
 	{
-		std::vector<std::wstring> lines = { L"1", L"2", L"3", L"4", L"5", L"6" };
+		std::vector<std::string> lines = { "a", "b", "c", "d", "e", "f" };
 		auto exportedLines = GetExportedLines({
 			{ lines.at(0), CoverageType::UnCover },
 			{ lines.at(1), CoverageType::UnCover },
@@ -130,18 +207,104 @@ namespace ExporterTest
 	}
 
 	//---------------------------------------------------------------------
-	TEST(HtmlFileCoverageExporterTest, MustEnableCodePrettify)
+	TEST(HtmlFileCoverageExporterTest, EscapedChars)
 	{
-		Exporter::HtmlFileCoverageExporter exporter;
+		auto exportedLines = GetExportedLines({ 
+			{ "a < b && b > c", CoverageType::NotExecutable },
+			{ std::string(40, ' ') + "\"<&>\"", CoverageType::NotExecutable } });
+
+		ASSERT_EQ("a &lt; b &amp;&amp; b &gt; c", exportedLines.at(0));
+		ASSERT_EQ(std::string(40, ' ') + StringStyle + "\"&lt;&amp;&gt;\"" + EndStyle, exportedLines.at(1));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, LineNumbers)
+	{
+		std::string output;
+		TestHelper::TemporaryPath sourceFile;
+		CppCoverage::FileCoverage fileCoverage{ sourceFile };
+
+		FillSources({ { Line, CoverageType::Cover }, { Line, CoverageType::Cover } }, sourceFile, fileCoverage);
+		Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
+
+		const auto& lineNumberStyle = Exporter::HtmlFileCoverageExporter::StyleLineNumber;
+		ASSERT_EQ("\n" + lineNumberStyle + "1" + EndStyle + StyleExecuted + Line 
+			+ "\n" + lineNumberStyle + "2" + EndStyle + Line + EndStyle, output);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, LineEndings)
+	{
+		ASSERT_EQ("\na\nb\nc", ExportRawContent("a\r\nb\nc"));
+		ASSERT_EQ("\na\\rb\n", ExportRawContent("a\rb\n\n"));
+		ASSERT_EQ("\n" + CommentStyle + "// a" + EndStyle + "\nb", ExportRawContent("// a\r\nb"));
+		ASSERT_EQ("", ExportRawContent(""));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, Encoding)
+	{
+		const std::string utf8Line = "// \xC3\xA9t\xC3\xA9 \xE2\x82\xAC";
+		const auto expectedLine = "\n" + CommentStyle + utf8Line + EndStyle;
+
+		ASSERT_EQ(expectedLine, ExportRawContent(utf8Line));
+		ASSERT_EQ(expectedLine, ExportRawContent("\xEF\xBB\xBF" + utf8Line));
+		ASSERT_EQ("\n" + CommentStyle + "// \xC3\xA9t\xC3\xA9" + EndStyle, ExportRawContent("// \xE9t\xE9"));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, SyntaxHighlighting)
+	{
+		auto exportedLines = GetExportedLines({ { "return x + 42; // end", CoverageType::Cover } });
+
+		ASSERT_EQ(StyleExecuted + KeywordStyle + "return" + EndStyle + " x + "
+			+ LiteralStyle + "42" + EndStyle + "; " + CommentStyle + "// end" + EndStyle + EndStyle, exportedLines.at(0));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, TokenOnSeveralLines)
+	{
+		auto exportedLines = GetExportedLines({
+			{ "/* a", CoverageType::Cover },
+			{ "b */", CoverageType::UnCover } });
+
+		ASSERT_EQ(StyleExecuted + CommentStyle + "/* a" + EndStyle + EndStyle, exportedLines.at(0));
+		ASSERT_EQ(StyleNotExecuted + CommentStyle + "b */" + EndStyle + EndStyle, exportedLines.at(1));
+	}
+
+	//---------------------------------------------------------------------
+	// Durations and throughputs are recorded as test properties.
+	TEST(HtmlFileCoverageExporterTest, DISABLED_ExportBenchmark)
+	{
+		const int lineCount = 200000;
+		TestHelper::TemporaryPath sourceFile;
+		CppCoverage::FileCoverage fileCoverage{ sourceFile };
+		SourceLines sourceLines;
+
+		for (int i = 0; i < lineCount; ++i)
+		{
+			sourceLines.emplace_back("\tfor (int i = 0; i < values.size() && !found; ++i) // " + std::to_string(i),
+				static_cast<CoverageType>(i % 3));
+		}
+		FillSources(sourceLines, sourceFile, fileCoverage);
+
+		auto sizeInMB = static_cast<double>(boost::filesystem::file_size(sourceFile.GetPath())) / (1024 * 1024);
+		auto recordThroughput = [=](const std::string& name, std::chrono::steady_clock::duration duration)
+		{
+			auto seconds = std::chrono::duration<double>(duration).count();
+			::testing::Test::RecordProperty(name + "Ms",
+				static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+			::testing::Test::RecordProperty(name + "MBPerSecond", std::to_string(sizeInMB / seconds));
+		};
 
-		ASSERT_TRUE(exporter.MustEnableCodePrettify(8000, 1000));
-		ASSERT_FALSE(exporter.MustEnableCodePrettify(8001, 1000));
-		ASSERT_FALSE(exporter.MustEnableCodePrettify(8000, 1001));
-		
-		ASSERT_TRUE(exporter.MustEnableCodePrettify(4000, 1666));
-		ASSERT_FALSE(exporter.MustEnableCodePrettify(4000, 1667));
+		auto start = std::chrono::steady_clock::now();
+		std::wostringstream ostr;
+		ExportWithWifstream(fileCoverage, ostr);
+		recordThroughput("Wifstream", std::chrono::steady_clock::now() - start);
 
-		ASSERT_TRUE(exporter.MustEnableCodePrettify(2000, 2000));
-		ASSERT_FALSE(exporter.MustEnableCodePrettify(2000, 2001));
+		start = std::chrono::steady_clock::now();
+		std::string output;
+		Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
+		recordThroughput("HtmlFileCoverageExporter", std::chrono::steady_clock::now() - start);
 	}
-}
\ No newline at end of file
+}
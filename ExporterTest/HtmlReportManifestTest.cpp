@@ -0,0 +1,168 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/FileCoverage.hpp"
+
+#include "Exporter/Html/HtmlReportManifest.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/Tools.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct HtmlReportManifestTest : public ::testing::Test
+		{
+			HtmlReportManifestTest()
+				: page1_{ outputFolder_.GetPath() / "Modules" / "page1.html" }
+				, page2_{ outputFolder_.GetPath() / "Modules" / "page2.html" }
+			{
+				fs::create_directories(page1_.parent_path());
+				TestHelper::CreateEmptyFile(page1_);
+				TestHelper::CreateEmptyFile(page2_);
+			}
+
+			TestHelper::TemporaryPath outputFolder_{ TestHelper::TemporaryPathOption::CreateAsFolder };
+			fs::path page1_;
+			fs::path page2_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlReportManifestTest, IsUpToDate)
+	{
+		{
+			Exporter::HtmlReportManifest manifest{ outputFolder_ };
+
+			ASSERT_FALSE(manifest.IsUpToDate(page1_, 42));
+			manifest.SetPageHash(page1_, 42, {});
+			manifest.Save();
+		}
+
+		Exporter::HtmlReportManifest manifest{ outputFolder_ };
+		ASSERT_TRUE(manifest.IsUpToDate(page1_, 42));
+		ASSERT_FALSE(manifest.IsUpToDate(page1_, 43));
+		ASSERT_FALSE(manifest.IsUpToDate(page2_, 42));
+
+		fs::remove(page1_);
+		ASSERT_FALSE(manifest.IsUpToDate(page1_, 42));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlReportManifestTest, RemovePreviousPages)
+	{
+		{
+			Exporter::HtmlReportManifest manifest{ outputFolder_ };
+
+			manifest.SetPageHash(page1_, 1, {});
+			manifest.SetPageHash(page2_, 2, {});
+			manifest.Save();
+		}
+
+		Exporter::HtmlReportManifest manifest{ outputFolder_ };
+		manifest.SetPageHash(page1_, 1, {});
+		manifest.Save();
+
+		ASSERT_TRUE(fs::exists(page1_));
+		ASSERT_FALSE(fs::exists(page2_));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlReportManifestTest, KeepFilesOutsideOutputFolder)
+	{
+		TestHelper::TemporaryPath outside{ TestHelper::TemporaryPathOption::CreateAsFile };
+		{
+			Exporter::HtmlReportManifest manifest{ outputFolder_ };
+
+			manifest.SetPageHash(page1_, 1, {});
+			manifest.Save();
+		}
+		{
+			std::ofstream ofs{ (outputFolder_.GetPath() / Exporter::HtmlReportManifest::Filename).string(), std::ios::app };
+			auto relativePath = outside.GetPath().lexically_relative(outputFolder_.GetPath());
+
+			ofs << "0000000000000002 0000000000000000 0000000000000000 " << relativePath.generic_string() << '\n';
+			ofs << "0000000000000003 0000000000000000 0000000000000000 " << outside.GetPath().generic_string() << '\n';
+		}
+
+		Exporter::HtmlReportManifest manifest{ outputFolder_ };
+		manifest.SetPageHash(page1_, 1, {});
+		manifest.Save();
+
+		ASSERT_TRUE(fs::exists(outside));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlReportManifestTest, ComputePageHash)
+	{
+		TestHelper::TemporaryPath sourcePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		cov::FileCoverage file{ sourcePath };
+		const Exporter::HtmlReportManifest::T_Hash templateHash = 42;
+		const Exporter::HtmlReportManifest::T_Hash sourceHash = 43;
+
+		file.AddLine(1, true);
+		file.AddLine(2, false);
+
+		auto hash = Exporter::HtmlReportManifest::ComputePageHash(file, templateHash, sourceHash);
+		ASSERT_EQ(hash, Exporter::HtmlReportManifest::ComputePageHash(file, templateHash, sourceHash));
+		ASSERT_NE(hash, Exporter::HtmlReportManifest::ComputePageHash(file, templateHash + 1, sourceHash));
+		ASSERT_NE(hash, Exporter::HtmlReportManifest::ComputePageHash(file, templateHash, sourceHash + 1));
+
+		file.UpdateLine(2, true);
+		ASSERT_NE(hash, Exporter::HtmlReportManifest::ComputePageHash(file, templateHash, sourceHash));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlReportManifestTest, ComputeSourceHash)
+	{
+		TestHelper::TemporaryPath sourcePath;
+		std::ofstream{ sourcePath.GetPath().string() } << "int main() {0}";
+		auto lastWriteTime = fs::last_write_time(sourcePath);
+		Exporter::HtmlReportManifest::SourceHash sourceHash;
+		{
+			Exporter::HtmlReportManifest manifest{ outputFolder_ };
+
+			sourceHash = manifest.ComputeSourceHash(page1_, sourcePath);
+			ASSERT_EQ(Exporter::HtmlReportManifest::ComputeFileHash(sourcePath), sourceHash.content);
+			manifest.SetPageHash(page1_, 1, sourceHash);
+			manifest.Save();
+		}
+
+		// Same size and last write time: the saved hash is used.
+		std::ofstream{ sourcePath.GetPath().string() } << "int main() {1}";
+		fs::last_write_time(sourcePath, lastWriteTime);
+		Exporter::HtmlReportManifest manifest{ outputFolder_ };
+		auto newSourceHash = manifest.ComputeSourceHash(page1_, sourcePath);
+		ASSERT_EQ(sourceHash.stamp, newSourceHash.stamp);
+		ASSERT_EQ(sourceHash.content, newSourceHash.content);
+
+		fs::last_write_time(sourcePath, lastWriteTime + 1);
+		newSourceHash = manifest.ComputeSourceHash(page1_, sourcePath);
+		ASSERT_NE(sourceHash.stamp, newSourceHash.stamp);
+		ASSERT_EQ(Exporter::HtmlReportManifest::ComputeFileHash(sourcePath), newSourceHash.content);
+		ASSERT_NE(sourceHash.content, newSourceHash.content);
+	}
+}
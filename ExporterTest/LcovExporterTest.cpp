@@ -0,0 +1,126 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/LineCoverage.hpp"
+
+#include "Exporter/LcovExporter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(LcovExporterTest, Export)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"EmptyModule");
+		auto& module = coverageData.AddModule(L"Module");
+
+		module.AddFile("EmptyFile");
+		auto& file = module.AddFile("File");
+
+		file.AddLine(10, true);
+		file.AddLine(12, false);
+		file.AddLine(13, true);
+
+		std::ostringstream ostr;
+		Exporter::LcovExporter().Export(coverageData, ostr);
+
+		ASSERT_EQ(
+			"TN:\nSF:EmptyFile\nLF:0\nLH:0\nend_of_record\n"
+			"TN:\nSF:File\nDA:10,1\nDA:12,0\nDA:13,1\nLF:3\nLH:2\nend_of_record\n", ostr.str());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovExporterTest, SameFileSeveralModules)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"Module1").AddFile("File").AddLine(1, true);
+		coverageData.AddModule(L"Module2").AddFile("File").AddLine(1, false);
+
+		std::ostringstream ostr;
+		Exporter::LcovExporter().Export(coverageData, ostr);
+
+		ASSERT_EQ(
+			"TN:\nSF:File\nDA:1,1\nLF:1\nLH:1\nend_of_record\n"
+			"TN:\nSF:File\nDA:1,0\nLF:1\nLH:0\nend_of_record\n", ostr.str());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovExporterTest, SubFolderDoesNotExist)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		TestHelper::TemporaryPath output;
+		auto outputPath = output.GetPath() / "SubFolder" / "output.info";
+
+		ASSERT_FALSE(fs::exists(outputPath));
+		Exporter::LcovExporter().Export(coverageData, outputPath);
+		ASSERT_TRUE(fs::exists(outputPath));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovExporterTest, SpecialChars)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		coverageData.AddModule(L"Module").AddFile(L"\u00E9\u00E0.cpp").AddLine(0, true);
+
+		std::ostringstream ostr;
+		Exporter::LcovExporter().Export(coverageData, ostr);
+
+		ASSERT_TRUE(boost::algorithm::contains(ostr.str(), u8"SF:\u00E9\u00E0.cpp\n"));
+	}
+
+	//-------------------------------------------------------------------------
+	// The duration and the file size are recorded as test properties.
+	TEST(LcovExporterTest, DISABLED_ExportBenchmark)
+	{
+		const int fileCount = 80000;
+		const int lineCount = 200;
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		for (int i = 0; i < fileCount; ++i)
+		{
+			std::vector<cov::LineCoverage> lines;
+
+			for (int line = 0; line < lineCount; ++line)
+				lines.emplace_back(line, line % 3 != 0);
+			module.AddFile(L"C:\\Folder\\File" + std::to_wstring(i) + L".cpp").AddLines(std::move(lines));
+		}
+
+		TestHelper::TemporaryPath output;
+		auto start = std::chrono::steady_clock::now();
+		Exporter::LcovExporter().Export(coverageData, output.GetPath());
+		auto end = std::chrono::steady_clock::now();
+
+		RecordProperty("ExportMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+		RecordProperty("SizeMB", static_cast<int>(fs::file_size(output.GetPath()) / (1024 * 1024)));
+	}
+}
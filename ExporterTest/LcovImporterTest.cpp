@@ -0,0 +1,158 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+
+#include "Exporter/ExporterException.hpp"
+#include "Exporter/LcovExporter.hpp"
+#include "Exporter/Import/LcovImporter.hpp"
+
+#include "TestHelper/CoverageDataComparer.hpp"
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = boost::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::CoverageData Import(const std::string& tracefile)
+		{
+			std::istringstream istr{ tracefile };
+
+			return Exporter::LcovImporter().Import(istr, L"Test");
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovImporterTest, Import)
+	{
+		auto coverageData = Import(
+			"TN:test\r\nSF:/src/File.cpp\r\nFN:1,main\r\nDA:1,5\r\nDA:2,0\r\nDA:3,-1\r\n"
+			"DA:4,1,checksum\r\nLF:4\r\nLH:2\r\nend_of_record\r\n");
+
+		ASSERT_EQ(L"Test", coverageData.GetName());
+		ASSERT_EQ(1u, coverageData.GetModules().size());
+		const auto& module = *coverageData.GetModules().at(0);
+		ASSERT_EQ(L"Test", module.GetPath().wstring());
+		ASSERT_EQ(1u, module.GetFiles().size());
+
+		const auto& file = *module.GetFiles().at(0);
+		ASSERT_EQ(fs::path{ "/src/File.cpp" }, file.GetPath());
+		ASSERT_EQ(4u, file.GetLines().size());
+		ASSERT_TRUE(file[1]->HasBeenExecuted());
+		ASSERT_FALSE(file[2]->HasBeenExecuted());
+		ASSERT_FALSE(file[3]->HasBeenExecuted());
+		ASSERT_TRUE(file[4]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovImporterTest, SameFileSeveralRecords)
+	{
+		auto coverageData = Import(
+			"SF:File.cpp\nDA:3,0\nDA:1,0\nDA:1,1\nend_of_record\n"
+			"SF:File2.cpp\nDA:1,1\nend_of_record\n"
+			"SF:File.cpp\nDA:2,0\nDA:3,1\nend_of_record\n");
+		const auto& files = coverageData.GetModules().at(0)->GetFiles();
+
+		ASSERT_EQ(2u, files.size());
+		const auto& file = *files.at(0);
+		ASSERT_EQ(3u, file.GetLines().size());
+		ASSERT_TRUE(file[1]->HasBeenExecuted());
+		ASSERT_FALSE(file[2]->HasBeenExecuted());
+		ASSERT_TRUE(file[3]->HasBeenExecuted());
+		ASSERT_EQ(2, file.GetCoverageRate().GetExecutedLinesCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovImporterTest, ExportImport)
+	{
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		module.AddFile(L"File").AddLine(1, true);
+		auto& file = module.AddFile(L"\u00E9\u00E0.cpp");
+		file.AddLine(1, false);
+		file.AddLine(10, true);
+
+		std::stringstream tracefile;
+		Exporter::LcovExporter().Export(coverageData, tracefile);
+		auto importedCoverageData = Exporter::LcovImporter().Import(tracefile, L"Module");
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+			&module, importedCoverageData.GetModules().at(0).get());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovImporterTest, InvalidRecord)
+	{
+		ASSERT_THROW(Import("SF:File.cpp\nDA:1\nend_of_record\n"), Exporter::ExporterException);
+		ASSERT_THROW(Import("DA:1,1\n"), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LcovImporterTest, IsLcovFile)
+	{
+		TestHelper::TemporaryPath lcovPath;
+		TestHelper::TemporaryPath otherPath;
+
+		std::ofstream{ lcovPath.GetPath().string() } << "TN:\nSF:File.cpp\nend_of_record\n";
+		std::ofstream{ otherPath.GetPath().string() } << "<?xml version=\"1.0\"?>";
+
+		ASSERT_TRUE(Exporter::LcovImporter::IsLcovFile(lcovPath));
+		ASSERT_FALSE(Exporter::LcovImporter::IsLcovFile(otherPath));
+	}
+
+	//-------------------------------------------------------------------------
+	// The duration and the file size are recorded as test properties.
+	TEST(LcovImporterTest, DISABLED_ImportBenchmark)
+	{
+		const int fileCount = 80000;
+		const int lineCount = 200;
+		cov::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+
+		for (int i = 0; i < fileCount; ++i)
+		{
+			std::vector<cov::LineCoverage> lines;
+
+			for (int line = 0; line < lineCount; ++line)
+				lines.emplace_back(line, line % 3 != 0);
+			module.AddFile(L"C:\\Folder\\File" + std::to_wstring(i) + L".cpp").AddLines(std::move(lines));
+		}
+
+		TestHelper::TemporaryPath output;
+		Exporter::LcovExporter().Export(coverageData, output.GetPath());
+
+		auto start = std::chrono::steady_clock::now();
+		auto importedCoverageData = Exporter::LcovImporter().Import(output.GetPath());
+		auto end = std::chrono::steady_clock::now();
+
+		RecordProperty("ImportMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+		RecordProperty("SizeMB", static_cast<int>(fs::file_size(output.GetPath()) / (1024 * 1024)));
+	}
+}
@@ -20,6 +20,7 @@
 #include "TestHelper/TemporaryPath.hpp"
 #include "Exporter/Html/TemplateHtmlExporter.hpp"
 #include "Exporter/Html/CTemplate.hpp"
+#include "Exporter/ExporterException.hpp"
 #include "CppCoverage/CoverageRate.hpp"
 
 using namespace Exporter;
@@ -94,8 +95,6 @@ namespace ExporterTest
 
 			for (const auto& tag : {
 				TemplateHtmlExporter::TitleTemplate,
-				TemplateHtmlExporter::BodyOnLoadTemplate,
-				TemplateHtmlExporter::SourceWarningMessageTemplate,
 				TemplateHtmlExporter::CodeTemplate })
 			{
 				AddTag(ofs, tag);
@@ -187,19 +186,36 @@ namespace ExporterTest
 
 		auto outputFile = output_folder.GetPath() / "file";
 		std::wstring sourceTitle = L"SourceTitle";
-		std::wstring sourceContent = L"SourceContent";
-		exporter.GenerateSourceTemplate(sourceTitle, sourceContent, true, outputFile);
+		std::string sourceContent = "SourceContent";
+		exporter.GenerateSourceTemplate(sourceTitle, sourceContent, outputFile);
 		auto templateValues = ReadTemplate(outputFile);
 
 		ASSERT_EQ(sourceTitle, templateValues.at(TemplateHtmlExporter::TitleTemplate));
-		ASSERT_EQ(sourceContent, templateValues.at(TemplateHtmlExporter::CodeTemplate));
-		ASSERT_NE(L"", templateValues.at(TemplateHtmlExporter::BodyOnLoadTemplate));
-		ASSERT_EQ(L"", templateValues.at(TemplateHtmlExporter::SourceWarningMessageTemplate));
+		ASSERT_EQ(L"SourceContent", templateValues.at(TemplateHtmlExporter::CodeTemplate));
+	}
 
-		exporter.GenerateSourceTemplate(sourceTitle, sourceContent, false, outputFile);
-		templateValues = ReadTemplate(outputFile);
+	//-------------------------------------------------------------------------
+	TEST_F(TemplateHtmlExporterTest, LargeFileTemplate)
+	{
+		auto sourceTemplate = CreateSourceTemplate();
+		TemplateHtmlExporter exporter{ sourceTemplate, sourceTemplate };
+
+		auto outputFile = output_folder.GetPath() / "file";
+		std::string sourceContent(1024 * 1024, 'a');
+		exporter.LoadTemplates();
+		exporter.GenerateSourceTemplate(L"SourceTitle", sourceContent, outputFile);
+		auto templateValues = ReadTemplate(outputFile);
+
+		ASSERT_EQ(std::wstring(sourceContent.size(), L'a'), templateValues.at(TemplateHtmlExporter::CodeTemplate));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(TemplateHtmlExporterTest, TemplateNotFound)
+	{
+		auto notFound = output_folder.GetPath() / "NotFound";
+		TemplateHtmlExporter exporter{ notFound, notFound };
 
-		ASSERT_EQ(L"", templateValues.at(TemplateHtmlExporter::BodyOnLoadTemplate));
-		ASSERT_NE(L"", templateValues.at(TemplateHtmlExporter::SourceWarningMessageTemplate));
+		ASSERT_THROW(exporter.LoadTemplates(), ExporterException);
+		ASSERT_THROW(exporter.GenerateSourceTemplate(L"Title", "Content", output_folder.GetPath() / "file"), ExporterException);
 	}
 }
\ No newline at end of file
@@ -18,23 +18,40 @@
 #include "OpenCppCoverage.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <functional>
 
 #include "CppCoverage/CodeCoverageRunner.hpp"
 #include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/CoverageFilterManager.hpp"
 #include "CppCoverage/OptionsParser.hpp"
 #include "CppCoverage/Options.hpp"
 #include "CppCoverage/ProgramOptions.hpp"
 #include "CppCoverage/CoverageDataMerger.hpp"
+#include "CppCoverage/CoverageDataAlgebra.hpp"
 #include "CppCoverage/OptionsExport.hpp"
 #include "CppCoverage/RunCoverageSettings.hpp"
+#include "CppCoverage/CoverageJournalReader.hpp"
+#include "CppCoverage/SanitizerCoverageReader.hpp"
+#include "CppCoverage/CoverageData.hpp"
+#include "CppCoverage/ModuleCoverage.hpp"
+#include "CppCoverage/FileCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
 
 #include "Exporter/Html/HtmlExporter.hpp"
+#include "Exporter/Html/CompactHtmlExporter.hpp"
 #include "Exporter/CoberturaExporter.hpp"
+#include "Exporter/LcovExporter.hpp"
 #include "Exporter/Binary/BinaryExporter.hpp"
 #include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "Exporter/Binary/CoverageDataStreamMerger.hpp"
+#include "Exporter/Import/CoberturaImporter.hpp"
+#include "Exporter/Import/GcovImporter.hpp"
+#include "Exporter/Import/LcovImporter.hpp"
 
 #include "Tools/Tool.hpp"
 #include "Tools/Log.hpp"
+#include "Tools/ParallelFor.hpp"
 
 namespace cov = CppCoverage;
 namespace logging = boost::log;
@@ -64,26 +81,103 @@ namespace OpenCppCoverage
 			const cov::Options& options, 
 			const cov::CoverageData& coverage)
 		{
+			using ExporterFactory = std::function<std::unique_ptr<Exporter::IExporter>()>;
+
 			const auto& exports = options.GetExports();
-			std::map<cov::OptionsExportType, std::unique_ptr<Exporter::IExporter>> exporters;
+			std::map<cov::OptionsExportType, ExporterFactory> exporterFactories;
+
+			// Exporters run at the same time and share the hardware threads.
+			auto maxThreadCount = std::max<size_t>(1, Tools::GetHardwareThreadCount() / std::max<size_t>(1, exports.size()));
 			
-			exporters.emplace(cov::OptionsExportType::Html, 
-				std::unique_ptr<Exporter::IExporter>(new Exporter::HtmlExporter{ Tools::GetTemplateFolder() }));
-			exporters.emplace(cov::OptionsExportType::Cobertura, 
-				std::unique_ptr<Exporter::IExporter>(new Exporter::CoberturaExporter{}));
-			exporters.emplace(cov::OptionsExportType::Binary,
-				std::unique_ptr<Exporter::IExporter>(new Exporter::BinaryExporter{}));
+			exporterFactories.emplace(cov::OptionsExportType::Html, [=]() 
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::HtmlExporter{ Tools::GetTemplateFolder(), maxThreadCount }); });
+			exporterFactories.emplace(cov::OptionsExportType::Cobertura, []() 
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::CoberturaExporter{}); });
+			exporterFactories.emplace(cov::OptionsExportType::Binary, []()
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::BinaryExporter{}); });
+			exporterFactories.emplace(cov::OptionsExportType::BinaryV2, []()
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::BinaryExporter{ Exporter::BinaryFormat::V2 }); });
+			exporterFactories.emplace(cov::OptionsExportType::BinaryV2Compressed, []()
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::BinaryExporter{ Exporter::BinaryFormat::V2Compressed }); });
+			exporterFactories.emplace(cov::OptionsExportType::CompactHtml, [=]()
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::CompactHtmlExporter{ Tools::GetTemplateFolder(), maxThreadCount }); });
+			exporterFactories.emplace(cov::OptionsExportType::Lcov, []()
+				{ return std::unique_ptr<Exporter::IExporter>(new Exporter::LcovExporter{}); });
 			
 			auto defaultPathPrefix = GetDefaultPathPrefix(options);
+			using ExporterWithOutput = std::pair<std::unique_ptr<Exporter::IExporter>, fs::path>;
+			std::map<fs::path, std::vector<ExporterWithOutput>> exportersByOutput;
 
+			// Each export has its own exporter as an exporter instance
+			// does not support concurrent exports.
 			for (const auto& singleExport : exports)
 			{
-				const auto& exporter = exporters.at(singleExport.GetType());
+				auto exporter = exporterFactories.at(singleExport.GetType())();
 				auto optionalOutputPath = singleExport.GetOutputPath();
 				auto output = (optionalOutputPath) ? *optionalOutputPath : exporter->GetDefaultPath(defaultPathPrefix);
 
-				exporter->Export(coverage, output);
+				exportersByOutput[fs::absolute(output).lexically_normal()].emplace_back(std::move(exporter), output);
 			}
+
+			std::vector<std::vector<ExporterWithOutput>*> exporterGroups;
+			for (auto& pair : exportersByOutput)
+				exporterGroups.push_back(&pair.second);
+
+			// Exporters only read the coverage data and share the same coverage rates:
+			// they all run at the same time. Exports to the same output run in
+			// the command line order so that the last one is kept.
+			cov::CoverageRateComputer coverageRateComputer{ coverage };
+
+			Tools::ParallelFor(exporterGroups.size(), [&](size_t i)
+			{
+				for (auto& exporter : *exporterGroups[i])
+					exporter.first->Export(coverage, coverageRateComputer, exporter.second);
+			}, exporterGroups.size());
+		}
+
+		//-----------------------------------------------------------------------------
+		// Journals and coverage files of other tools cannot be read as binary coverage files.
+		bool IsBinaryCoverageFile(const fs::path& path)
+		{
+			return !Exporter::GcovImporter::IsGcovPath(path)
+				&& !cov::CoverageJournalReader::IsCoverageJournal(path)
+				&& !cov::SanitizerCoverageReader::IsSanitizerCoverageFile(path)
+				&& !Exporter::CoberturaImporter::IsCoberturaFile(path)
+				&& !Exporter::LcovImporter::IsLcovFile(path);
+		}
+
+		//-----------------------------------------------------------------------------
+		// Blocks are mapped to lines with the same filters as a coverage run.
+		cov::CoverageData ReadSanitizerCoverage(const fs::path& path, const cov::Options& options)
+		{
+			cov::CoverageFilterManager coverageFilterManager{
+				cov::CoverageFilterSettings{ options.GetModulePatterns(), options.GetSourcePatterns() },
+				options.GetUnifiedDiffSettingsCollection(),
+				options.GetExcludedLineRegexes(),
+				options.IsOptimizedBuildSupportEnabled() };
+
+			return cov::SanitizerCoverageReader{}.Read(path, coverageFilterManager);
+		}
+
+		//-----------------------------------------------------------------------------
+		cov::CoverageData LoadCoverageData(
+			const fs::path& path,
+			const cov::Options& options,
+			const Exporter::CoverageDataDeserializer& coverageDataDeserializer)
+		{
+			auto errorMsg = "Cannot extract coverage data from " + path.string();
+
+			if (Exporter::GcovImporter::IsGcovPath(path))
+				return Exporter::GcovImporter{}.Import(path);
+			if (cov::CoverageJournalReader::IsCoverageJournal(path))
+				return cov::CoverageJournalReader{}.Read(path);
+			if (cov::SanitizerCoverageReader::IsSanitizerCoverageFile(path))
+				return ReadSanitizerCoverage(path, options);
+			if (Exporter::CoberturaImporter::IsCoberturaFile(path))
+				return Exporter::CoberturaImporter{}.Import(path);
+			if (Exporter::LcovImporter::IsLcovFile(path))
+				return Exporter::LcovImporter{}.Import(path);
+			return coverageDataDeserializer.Deserialize(path, errorMsg);
 		}
 
 		//-----------------------------------------------------------------------------
@@ -93,15 +187,161 @@ namespace OpenCppCoverage
 			Exporter::CoverageDataDeserializer coverageDataDeserializer;
 
 			for (const auto& path : options.GetInputCoveragePaths())
-			{				
-				auto errorMsg = "Cannot extract coverage data from " + path.string();
-
+			{
 				LOG_INFO << L"Load coverage file: " << path.wstring();
-				coverageDatas.push_back(coverageDataDeserializer.Deserialize(path, errorMsg));
+				coverageDatas.push_back(LoadCoverageData(path, options, coverageDataDeserializer));
 			}
 			return coverageDatas;
 		}
 
+		//-----------------------------------------------------------------------------
+		// The streaming merge only writes version 2 files.
+		boost::optional<Exporter::BinaryFormat> GetStreamingFormat(cov::OptionsExportType type)
+		{
+			if (type == cov::OptionsExportType::BinaryV2)
+				return Exporter::BinaryFormat::V2;
+			if (type == cov::OptionsExportType::BinaryV2Compressed)
+				return Exporter::BinaryFormat::V2Compressed;
+			return boost::none;
+		}
+
+		//-----------------------------------------------------------------------------
+		// Merging coverage files into version 2 binary files only does not require to load
+		// all coverage data in memory. All exports share the same file.
+		bool CanMergeInStreamingMode(const cov::Options& options)
+		{
+			const auto& exports = options.GetExports();
+			const auto& inputCoveragePaths = options.GetInputCoveragePaths();
+
+			return !options.GetStartInfo()
+				&& !options.GetCoverageDataOperation()
+				&& !inputCoveragePaths.empty()
+				&& std::all_of(inputCoveragePaths.begin(), inputCoveragePaths.end(), IsBinaryCoverageFile)
+				&& !exports.empty()
+				&& GetStreamingFormat(exports.front().GetType())
+				&& std::all_of(exports.begin(), exports.end(), [&](const cov::OptionsExport& singleExport)
+			{
+				return singleExport.GetType() == exports.front().GetType();
+			});
+		}
+
+		//-----------------------------------------------------------------------------
+		int MergeInStreamingMode(const cov::Options& options)
+		{
+			auto format = GetStreamingFormat(options.GetExports().front().GetType());
+			Exporter::CoverageDataStreamMerger coverageDataStreamMerger{ *format };
+			auto defaultPath = Exporter::BinaryExporter{}.GetDefaultPath(GetDefaultPathPrefix(options));
+			boost::optional<fs::path> mergedPath;
+			int exitCode = 0;
+
+			for (const auto& singleExport : options.GetExports())
+			{
+				auto optionalOutputPath = singleExport.GetOutputPath();
+				auto output = (optionalOutputPath) ? *optionalOutputPath : defaultPath;
+
+				if (mergedPath)
+				{
+					// The merged file cannot be copied onto itself.
+					if (fs::absolute(output).lexically_normal() == fs::absolute(*mergedPath).lexically_normal())
+						continue;
+					Tools::CreateParentFolderIfNeeded(output);
+					fs::copy_file(*mergedPath, output, fs::copy_option::overwrite_if_exists);
+				}
+				else
+				{
+					LOG_INFO << L"Merge coverage files in streaming mode to: " << output.wstring();
+					exitCode = coverageDataStreamMerger.Merge(
+						options.GetInputCoveragePaths(), 
+						output, 
+						options.IsAggregateByFileModeEnabled());
+					mergedPath = output;
+				}
+			}
+
+			return exitCode;
+		}
+
+		//-----------------------------------------------------------------------------
+		Exporter::CoverageDataSummary CreateSummary(const cov::CoverageData& coverageData)
+		{
+			Exporter::CoverageDataSummary summary{ coverageData.GetName(), coverageData.GetExitCode(), cov::CoverageRate{}, {} };
+
+			for (const auto& module : coverageData.GetModules())
+			{
+				Exporter::ModuleCoverageSummary moduleSummary{ module->GetPath(), cov::CoverageRate{}, {} };
+
+				for (const auto& file : module->GetFiles())
+				{
+					moduleSummary.coverageRate += file->GetCoverageRate();
+					moduleSummary.files.push_back(Exporter::FileCoverageSummary{ file->GetPath(), file->GetCoverageRate() });
+				}
+				summary.coverageRate += moduleSummary.coverageRate;
+				summary.modules.push_back(std::move(moduleSummary));
+			}
+			return summary;
+		}
+
+		//-----------------------------------------------------------------------------
+		void PrintCoverageRate(const std::wstring& indent, const std::wstring& name, const cov::CoverageRate& coverageRate)
+		{
+			std::wcout << indent << name << L": " << coverageRate.GetPercentRate() << L"% ("
+				<< coverageRate.GetExecutedLinesCount() << L"/" << coverageRate.GetTotalLinesCount() << L" lines)" << std::endl;
+		}
+
+		//-----------------------------------------------------------------------------
+		// Print the coverage rate of the input coverage files. Binary coverage files
+		// are read from their table of contents, the lines are not loaded.
+		// Other formats are fully loaded.
+		int PrintStat(const cov::Options& options)
+		{
+			Exporter::CoverageDataDeserializer coverageDataDeserializer;
+			bool printFiles = options.GetLogLevel() == cov::LogLevel::Verbose;
+			int exitCode = 0;
+
+			for (const auto& path : options.GetInputCoveragePaths())
+			{
+				auto errorMsg = "Cannot extract coverage data from " + path.string();
+				auto summary = (IsBinaryCoverageFile(path))
+					? coverageDataDeserializer.DeserializeSummary(path, errorMsg)
+					: CreateSummary(LoadCoverageData(path, options, coverageDataDeserializer));
+
+				PrintCoverageRate(L"", path.wstring(), summary.coverageRate);
+				for (const auto& module : summary.modules)
+				{
+					PrintCoverageRate(L"  ", module.path.wstring(), module.coverageRate);
+					if (printFiles)
+					{
+						for (const auto& file : module.files)
+							PrintCoverageRate(L"    ", file.path.wstring(), file.coverageRate);
+					}
+				}
+
+				const auto& minCoverage = options.GetMinCoverage();
+				if (minCoverage && summary.coverageRate.GetRate() * 100 < *minCoverage)
+				{
+					LOG_ERROR << L"Coverage rate of " << path.wstring() << L" is lower than " << *minCoverage << L"%.";
+					exitCode = 1;
+				}
+			}
+			return exitCode;
+		}
+
+		//-----------------------------------------------------------------------------
+		cov::CoverageData ComputeCoverageDataOperation(
+			cov::CoverageDataOperation operation,
+			const cov::Options& options,
+			std::vector<cov::CoverageData>& coverageDatas)
+		{
+			// Inputs are aggregated first so that a file has the same lines in all modules.
+			if (options.IsAggregateByFileModeEnabled())
+			{
+				for (auto& coverageData : coverageDatas)
+					cov::CoverageDataMerger{}.MergeFileCoverage(coverageData);
+			}
+
+			return cov::CoverageDataAlgebra{}.Compute(operation, coverageDatas.at(0), coverageDatas.at(1));
+		}
+
 		//-----------------------------------------------------------------------------
 		void InitLogger(const cov::Options& options)
 		{
@@ -122,6 +362,18 @@ namespace OpenCppCoverage
 		{
 			InitLogger(options);
 
+			if (options.IsStatModeEnabled())
+				return PrintStat(options);
+
+			if (CanMergeInStreamingMode(options))
+			{
+				auto exitCode = MergeInStreamingMode(options);
+
+				if (exitCode)
+					LOG_ERROR << L"Your program stop with error code: " << exitCode;
+				return exitCode;
+			}
+
 			auto coveraDatas = LoadInputCoverageDatas(options);
 			const auto* startInfo = options.GetStartInfo();
 			
@@ -147,11 +399,16 @@ namespace OpenCppCoverage
 				runCoverageSettings.SetContinueAfterCppException(options.IsContinueAfterCppExceptionModeEnabled());
 				runCoverageSettings.SetMaxUnmatchPathsForWarning(maxUnmatchPathsForWarning);
 				runCoverageSettings.SetOptimizedBuildSupport(options.IsOptimizedBuildSupportEnabled());
+				if (options.GetJournalPath())
+					runCoverageSettings.SetJournal(*options.GetJournalPath(), options.IsJournalSyncModeEnabled());
 				coveraDatas.push_back(codeCoverageRunner.RunCoverage(runCoverageSettings));
 			}
 			cov::CoverageDataMerger	coverageDataMerger;
+			const auto& coverageDataOperation = options.GetCoverageDataOperation();
 
-			auto coverageData = coverageDataMerger.Merge(coveraDatas);
+			auto coverageData = (coverageDataOperation)
+				? ComputeCoverageDataOperation(*coverageDataOperation, options, coveraDatas)
+				: coverageDataMerger.Merge(coveraDatas);
 
 			if (options.IsAggregateByFileModeEnabled())
 				coverageDataMerger.MergeFileCoverage(coverageData);
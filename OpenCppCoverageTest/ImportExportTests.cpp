@@ -85,6 +85,27 @@ namespace OpenCppCoverageTest
 		RunCoverage(cov::ProgramOptions::ExportTypeCoberturaValue);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(ImportExportTest, ExportSeveralTypes)
+	{
+		TestHelper::TemporaryPath htmlOutput;
+		TestHelper::TemporaryPath coberturaOutput;
+		TestHelper::TemporaryPath binaryOutput;
+		TestHelper::TemporaryPath lcovOutput;
+
+		RunCoverage(
+		{ BuildExportTypeString(cov::ProgramOptions::ExportTypeHtmlValue, htmlOutput),
+		BuildExportTypeString(cov::ProgramOptions::ExportTypeCoberturaValue, coberturaOutput),
+		BuildExportTypeString(cov::ProgramOptions::ExportTypeBinaryValue, binaryOutput),
+		BuildExportTypeString(cov::ProgramOptions::ExportTypeLcovValue, lcovOutput) },
+		binaryOutput);
+
+		ASSERT_TRUE(fs::exists(htmlOutput));
+		ASSERT_TRUE(fs::exists(coberturaOutput));
+		ASSERT_TRUE(fs::exists(lcovOutput));
+		ASSERT_FALSE(ReadCoverageDataFromFile(binaryOutput).GetModules().empty());
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(ImportExportTest, ExportImportBinary)
 	{
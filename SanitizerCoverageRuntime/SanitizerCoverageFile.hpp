@@ -0,0 +1,52 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace SanitizerCoverageRuntime
+{
+	// File written by the runtime for each instrumented module:
+	//  - FileHeader.
+	//  - The path of the module: modulePathSize UTF-16 characters.
+	//  - blockCount Block in the order of the guards.
+	const char FileMagic[] = "OCCGUARD";
+	const uint32_t FileVersion = 1;
+	const wchar_t FileExtension[] = L".pcguard";
+
+	struct FileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t modulePathSize;
+		uint32_t blockCount;
+		uint32_t reserved;
+	};
+
+	enum BlockFlags : uint32_t
+	{
+		FunctionEntry = 1,
+		Executed = 2
+	};
+
+	// rva is the address of the basic block relative to the base of the module.
+	struct Block
+	{
+		uint32_t rva;
+		uint32_t flags;
+	};
+}
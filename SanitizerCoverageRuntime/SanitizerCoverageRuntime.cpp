@@ -0,0 +1,156 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Runtime for the modules built with clang-cl -fsanitize-coverage=trace-pc-guard,pc-table.
+//
+// Add this file to each instrumented executable or dll, compiled without
+// -fsanitize-coverage and with the same runtime library as the module.
+// A guard is cleared the first time its block is executed, the following
+// executions only read it so the instrumented code runs at nearly native speed.
+// When the module is unloaded or when __sanitizer_cov_dump is called, the
+// blocks are written to <folder>\<module filename>.<process id>.pcguard where
+// folder is the value of the environment variable OPENCPPCOVERAGE_PCGUARD_FOLDER,
+// or the current folder. This file can be read with --input_coverage.
+
+#include <windows.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "SanitizerCoverageFile.hpp"
+
+namespace
+{
+	// Zero initialized before any constructor so the guards can be registered
+	// by the constructors of the instrumented code.
+	uint32_t* guardsBegin;
+	uint32_t* guardsEnd;
+	const uintptr_t* pcTableBegin;
+	const uintptr_t* pcTableEnd;
+
+	//-------------------------------------------------------------------------
+	std::wstring GetOutputPath(const std::wstring& modulePath)
+	{
+		wchar_t buffer[MAX_PATH];
+		std::wstring outputPath;
+
+		auto size = GetEnvironmentVariableW(L"OPENCPPCOVERAGE_PCGUARD_FOLDER", buffer, MAX_PATH);
+		if (size && size < MAX_PATH)
+			outputPath = std::wstring{ buffer } + L'\\';
+		outputPath += modulePath.substr(modulePath.find_last_of(L"\\/") + 1);
+		return outputPath + L'.' + std::to_wstring(GetCurrentProcessId())
+			+ SanitizerCoverageRuntime::FileExtension;
+	}
+
+	//-------------------------------------------------------------------------
+	void WriteCoverage()
+	{
+		using namespace SanitizerCoverageRuntime;
+
+		const size_t pcTableEntrySize = 2; // PC and flags
+		HMODULE module = nullptr;
+
+		if (!guardsBegin || !pcTableBegin
+			|| static_cast<size_t>(pcTableEnd - pcTableBegin) != static_cast<size_t>(guardsEnd - guardsBegin) * pcTableEntrySize
+			|| !GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+				reinterpret_cast<LPCWSTR>(guardsBegin), &module))
+		{
+			return;
+		}
+
+		wchar_t buffer[MAX_PATH];
+		auto size = GetModuleFileNameW(module, buffer, MAX_PATH);
+		if (!size || size == MAX_PATH)
+			return;
+
+		std::wstring modulePath{ buffer, size };
+		FILE* file = nullptr;
+		if (_wfopen_s(&file, GetOutputPath(modulePath).c_str(), L"wb") || !file)
+			return;
+
+		FileHeader header = {};
+		std::memcpy(header.magic, FileMagic, sizeof(header.magic));
+		header.version = FileVersion;
+		header.modulePathSize = static_cast<uint32_t>(modulePath.size());
+		header.blockCount = static_cast<uint32_t>(guardsEnd - guardsBegin);
+		std::fwrite(&header, sizeof(header), 1, file);
+		std::fwrite(modulePath.c_str(), sizeof(wchar_t), modulePath.size(), file);
+
+		auto baseOfImage = reinterpret_cast<uintptr_t>(module);
+		for (size_t i = 0; i < header.blockCount; ++i)
+		{
+			const auto* pcTableEntry = pcTableBegin + i * pcTableEntrySize;
+			Block block;
+
+			block.rva = static_cast<uint32_t>(pcTableEntry[0] - baseOfImage);
+			block.flags = 0;
+			if (pcTableEntry[1] & 1)
+				block.flags |= FunctionEntry;
+			if (!guardsBegin[i])
+				block.flags |= Executed;
+			std::fwrite(&block, sizeof(block), 1, file);
+		}
+		std::fclose(file);
+	}
+
+	//-------------------------------------------------------------------------
+	struct CoverageWriter
+	{
+		~CoverageWriter()
+		{
+			WriteCoverage();
+		}
+	} coverageWriter;
+}
+
+//-----------------------------------------------------------------------------
+// Called by the constructor of each instrumented object file with the guards
+// of the whole module.
+extern "C" void __sanitizer_cov_trace_pc_guard_init(uint32_t* begin, uint32_t* end)
+{
+	if (begin == end || begin == guardsBegin)
+		return;
+
+	guardsBegin = begin;
+	guardsEnd = end;
+	for (auto guard = begin; guard < end; ++guard)
+		*guard = 1;
+}
+
+//-----------------------------------------------------------------------------
+// Entries of the table are the address of a block and its flags, in the same
+// order as the guards. Bit 0 of the flags is set for a function entry.
+extern "C" void __sanitizer_cov_pcs_init(const uintptr_t* begin, const uintptr_t* end)
+{
+	pcTableBegin = begin;
+	pcTableEnd = end;
+}
+
+//-----------------------------------------------------------------------------
+// The guard is only written once to avoid sharing its cache line between threads.
+extern "C" void __sanitizer_cov_trace_pc_guard(uint32_t* guard)
+{
+	if (*guard)
+		*guard = 0;
+}
+
+//-----------------------------------------------------------------------------
+extern "C" void __sanitizer_cov_dump()
+{
+	WriteCoverage();
+}
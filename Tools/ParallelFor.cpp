@@ -0,0 +1,98 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ParallelFor.hpp"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace Tools
+{
+	//-------------------------------------------------------------------------
+	size_t GetHardwareThreadCount()
+	{
+		return std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	//-------------------------------------------------------------------------
+	void ParallelFor(
+		size_t count,
+		const std::function<void(size_t)>& action,
+		size_t maxThreadCount)
+	{
+		if (maxThreadCount == 0)
+			maxThreadCount = GetHardwareThreadCount();
+		auto threadCount = std::min(count, maxThreadCount);
+
+		if (threadCount <= 1)
+		{
+			for (size_t i = 0; i < count; ++i)
+				action(i);
+			return;
+		}
+
+		std::atomic<size_t> nextIndex{ 0 };
+		std::atomic<bool> hasFailed{ false };
+		std::exception_ptr firstException;
+		std::mutex exceptionMutex;
+
+		auto worker = [&]()
+		{
+			for (auto i = nextIndex++; i < count && !hasFailed; i = nextIndex++)
+			{
+				try
+				{
+					action(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ exceptionMutex };
+
+					if (!firstException)
+						firstException = std::current_exception();
+					hasFailed = true;
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		
+		threads.reserve(threadCount - 1);
+		try
+		{
+			for (size_t i = 1; i < threadCount; ++i)
+				threads.emplace_back(worker);
+		}
+		catch (const std::system_error&)
+		{
+			// No more thread can be started: the started threads and the
+			// calling thread share the remaining indexes.
+		}
+		worker();
+
+		for (auto& thread : threads)
+			thread.join();
+
+		if (firstException)
+			std::rethrow_exception(firstException);
+	}
+}
@@ -0,0 +1,37 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Call action(i) for each i in [0, count) on several threads and wait for
+	// completion. Indexes are handed out dynamically so uneven tasks are
+	// balanced. The first exception thrown by action is rethrown once all
+	// threads are joined and no new index is started after it.
+	// maxThreadCount == 0 means one thread per hardware core. If a thread
+	// cannot be created, the work is done by the threads already started.
+	TOOLS_DLL void ParallelFor(
+		size_t count, 
+		const std::function<void(size_t)>& action,
+		size_t maxThreadCount = 0);
+
+	TOOLS_DLL size_t GetHardwareThreadCount();
+}
@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "Tools/ParallelFor.hpp"
+
+namespace ToolsTests
+{
+	//---------------------------------------------------------------------
+	TEST(ParallelForTest, AllIndexesAreProcessedOnce)
+	{
+		const size_t count = 1000;
+		std::vector<std::atomic<int>> counters(count);
+
+		Tools::ParallelFor(count, [&](size_t i) { ++counters[i]; }, 4);
+
+		for (const auto& counter : counters)
+			ASSERT_EQ(1, counter);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(ParallelForTest, Empty)
+	{
+		bool isCalled = false;
+
+		Tools::ParallelFor(0, [&](size_t) { isCalled = true; });
+		ASSERT_FALSE(isCalled);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(ParallelForTest, Exception)
+	{
+		auto action = [](size_t i) 
+		{ 
+			if (i == 42)
+				throw std::runtime_error("Error");
+		};
+
+		ASSERT_THROW(Tools::ParallelFor(100, action, 4), std::runtime_error);
+	}
+}
@@ -0,0 +1,37 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <boost/filesystem/path.hpp>
+
+#include "Tools/UniquePath.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace ToolsTests
+{
+	//---------------------------------------------------------------------
+	TEST(UniquePathTest, GetUniquePath)
+	{
+		Tools::UniquePath uniquePath;
+
+		ASSERT_EQ(fs::path{ "folder/file.html" }, uniquePath.GetUniquePath("folder/file.html"));
+		ASSERT_EQ(fs::path{ "folder/file2.html" }, uniquePath.GetUniquePath("folder/file.html"));
+		ASSERT_EQ(fs::path{ "folder/file3.html" }, uniquePath.GetUniquePath("folder/file.html"));
+		ASSERT_EQ(fs::path{ "folder/other.html" }, uniquePath.GetUniquePath("folder/other.html"));
+	}
+}